@@ -0,0 +1,152 @@
+/* -*- C++ -*- */
+/*
+ * colfile.h - class ColumnFile, class ColumnScan
+ *
+ * A ColumnFile stores a relation of fixed-length records column by
+ * column: every attribute has its own chain of data pages, holding the
+ * values of that attribute in record order.  All attributes are
+ * recLen/numOfAttr bytes long.  A record is identified by its position,
+ * i.e. the order in which it was inserted.
+ *
+ * Each column also has a chain of position index pages listing its data
+ * pages in order, with the first position and the number of values of
+ * each, so that the page holding a given position can be found without
+ * reading the data pages before it.
+ *
+ * Records added by InsertRecord are stored as they are.  BulkLoad
+ * compresses every int column page by page instead, each page in
+ * whichever encoding of ColumnPage suits its values best, so pages of
+ * the same column may hold very different numbers of values.
+ *
+ * The joins of Practical 3 link the spacemgr library prebuilt, which
+ * has no ColumnFile, so a ColumnScan cannot feed them.
+ */
+
+#ifndef _COLFILE_H
+#define _COLFILE_H
+
+#include "minirel.h"
+#include "page.h"
+#include "heapfile.h"
+#include "colpage.h"
+
+const int COLFILE_MAX_ATTR = 32;
+
+struct ColumnIndexPage;
+
+class ColumnFile
+{
+	friend class ColumnScan;
+
+private :
+
+	struct ColumnFileHeaderPage
+	{
+		int    recLen;
+		int    numOfAttr;
+		int    numOfRecords;
+		PageID firstIndexPid[COLFILE_MAX_ATTR]; // Position index of each column.
+		PageID lastIndexPid[COLFILE_MAX_ATTR];
+		PageID lastPid[COLFILE_MAX_ATTR];       // Data page appended to.
+	};
+
+	char  *filename;
+	int    type;
+	PageID headerPid;
+
+	int    recLen;     // copied from the header page.
+	int    numOfAttr;
+	PageID firstIndexPid[COLFILE_MAX_ATTR];
+	int    capacity;   // number of uncompressed values in a data page.
+
+	int    AttrLen() { return recLen / numOfAttr; }
+	Status Open(const char *name);
+	Status FindPage(int attr, int pos, PageID& pid, int& firstPos);
+	Status AppendPage(ColumnFileHeaderPage *header, int attr, int firstPos,
+	                  int numOfValues, PageID& pid, ColumnPage *&page);
+	Status AppendValue(ColumnFileHeaderPage *header, int attr, int pos,
+	                   char *valPtr);
+	Status FlushValues(ColumnFileHeaderPage *header, int attr, int *values,
+	                   int& numOfValues, int& firstPos, bool all);
+	Status EmptyColumns(ColumnFileHeaderPage *header);
+
+public:
+
+    ColumnFile( const char* name, Status& returnStatus );
+    ColumnFile( const char* name, Status& returnStatus, const int recLen,
+                const int numOfAttr );
+    ~ColumnFile();
+
+    int GetNumOfRecords();
+    int GetNumOfAttr() { return numOfAttr; }
+    Status InsertRecord(char* recPtr, int recLen, int& pos);
+    Status BulkLoad(HeapFile* source);
+    Status GetRecord(int pos, char* recPtr, int& recLen);
+    Status GetAttr(int pos, int attr, char* valPtr);
+    class ColumnScan* OpenScan(Status& status, int numOfProj, const int *projAttrs);
+    class ColumnScan* OpenScan(Status& status, int numOfProj, const int *projAttrs,
+                               int filterAttr, AttrOperator op, int value);
+
+    Status DeleteFile();
+};
+
+
+//
+// A ColumnScan returns the given attributes of each record in position
+// order, reading the pages of those columns only.  With all attributes
+// of the file it reconstructs whole records.
+//
+// A scan may also be given a predicate "attribute op value" on an int
+// attribute.  It is evaluated on the compressed pages of that column,
+// and only the records satisfying it are returned; pages of the other
+// columns holding none of them are not read at all.
+//
+
+class ColumnScan
+{
+public:
+
+	ColumnScan(ColumnFile* cf, Status& status, int numOfProj, const int *projAttrs);
+	ColumnScan(ColumnFile* cf, Status& status, int numOfProj, const int *projAttrs,
+	           int filterAttr, AttrOperator op, int value);
+	~ColumnScan();
+
+	Status GetNext(int& pos, char* recPtr, int& recLen);
+
+private:
+
+	// Where a column is being read: the current position index page and
+	// entry, the positions of the data page of that entry, and the
+	// values of that page once decoded.
+	struct Cursor
+	{
+		PageID indexPid;
+		int    entry;
+		PageID pid;
+		int    firstPos;
+		int    endPos;
+		bool   loaded;
+		char  *values;
+	};
+
+	ColumnFile *file;
+	int   numOfProj;
+	int  *projAttrs;
+	Cursor *cursor;
+
+	int   currPos;          // position of the next record to return.
+	int   numOfRecords;
+
+	bool  filtered;
+	AttrOperator op;
+	int   value;
+	Cursor filter;          // values of filter are the results of the
+	                        // predicate, one char per position.
+
+	void   Init(ColumnFile* cf, int numOfProj, const int *projAttrs);
+	void   InitCursor(Cursor& c, int attr, int size);
+	Status Seek(Cursor& c, int pos);
+	Status Load(Cursor& c, bool select);
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef COLPAGE_H
+#define COLPAGE_H
+
+#include "minirel.h"
+#include "page.h"
+
+//
+// Ways the values of a ColumnPage can be stored.  Only int attributes
+// are ever compressed; other attributes are always ENC_PLAIN.
+//
+//   ENC_PLAIN  the values one after the other.
+//   ENC_FOR    frame of reference: value - base, bit-packed in bitWidth
+//              bits each.
+//   ENC_DICT   the distinct values (a dictionary of base entries),
+//              followed by the index of each value in the dictionary,
+//              bit-packed in bitWidth bits each.
+//   ENC_RLE    base runs of (value, run length) pairs of ints.
+//
+
+enum ColumnEncoding {
+	ENC_PLAIN,
+	ENC_FOR,
+	ENC_DICT,
+	ENC_RLE
+};
+
+//
+// CHANGE this constant whenever you update the structure of ColumnPage class.
+//
+const int COLPAGE_DATA_SIZE = (MAX_SPACE - 2*sizeof(int) - 4*sizeof(short));
+
+// Most values a page may hold, reached by columns that need a single bit
+// (or none at all) per value.
+const int COLPAGE_MAX_VALUES = 8*COLPAGE_DATA_SIZE;
+
+// Largest dictionary considered for ENC_DICT.
+const int COLPAGE_MAX_DICT = 256;
+
+//
+// A data page of one column of a ColumnFile.
+//
+
+class ColumnPage {
+
+private :
+
+	int     numOfValues;  // Number of values in this page.
+	int     base;         // ENC_FOR: reference value, ENC_DICT: number of
+	                      // dictionary entries, ENC_RLE: number of runs.
+	short   encoding;     // One of ColumnEncoding.
+	short   bitWidth;     // Bits per packed value for ENC_FOR and ENC_DICT.
+	short   attrLen;      // Length of a value.
+	short   unused;
+
+	char data[COLPAGE_DATA_SIZE];
+
+	unsigned GetBits(const char *buf, int i);
+	void     PutBits(char *buf, int i, unsigned v);
+	int      GetInt(int i);
+
+public:
+
+	void   Init(int attrLen);
+	Status Append(const char *valPtr);
+	void   Encode(const int *values, int n);
+	static int Fit(const int *values, int n);
+
+	int    GetNumOfValues() { return numOfValues; }
+	int    GetEncoding() { return encoding; }
+	void   GetValue(int i, char *valPtr);
+	void   Decode(char *valPtr);
+	int    Select(AttrOperator op, int value, char *match);
+};
+
+#endif
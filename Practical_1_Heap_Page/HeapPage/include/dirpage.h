@@ -10,6 +10,23 @@ struct PageInfo
 	short  numOfRecords;
 };
 
+//
+// A zone map keeps, for every data page, the smallest and largest value
+// of some int attributes of the records reached from that page, so that
+// a scan with a predicate on them can skip pages without reading them.
+// The zones of a page follow its PageInfo in the directory.  They are
+// widened when a record is inserted or updated and recomputed when one
+// is deleted.  An empty zone has min > max.
+//
+
+const int DIR_MAX_ZONES = 4;
+
+struct Zone
+{
+	int min;
+	int max;
+};
+
 
 class DirPage 
 {
@@ -19,14 +36,21 @@ class DirPage
 private : 
 	int numOfEntry;
 	int spaceAvailable;
+	int recLen;      // Length of the records on FIXED_PAGE data pages,
+	                 // 0 if the file uses SLOTTED_PAGE data pages.
+	int numOfAttr;   // Number of minipages of the FIXED_PAGE data pages.
+	int numOfZones;  // Number of int attributes in the zone map, and
+	int zoneOffset[DIR_MAX_ZONES];  // their offsets in the records.
 	PageID curr;
 	PageID next;
 	PageID prev;
 
-	#define DIR_PAGE_SIZE (MAX_SPACE - 2*sizeof(int) - 3*sizeof(PageID))
+	#define DIR_PAGE_SIZE (MAX_SPACE - (5 + DIR_MAX_ZONES)*sizeof(int) - 3*sizeof(PageID))
 
 	char data[DIR_PAGE_SIZE];
 
+	int  EntrySize() { return sizeof(PageInfo) + numOfZones*sizeof(Zone); }
+
 public :
 	Status Init (PageID pid);
 	PageInfo *FindPageInfo (PageID pid);
@@ -36,9 +60,20 @@ public :
 	Status DeletePage (PageID pid);
 	Status InsertRecordIntoPage (PageID pid, HeapPage *page);
 	Status DeleteRecordFromPage (PageID pid, HeapPage *page);
+	Status UpdatePage (PageID pid, HeapPage *page);
 	void   SetNextPage (PageID pid) { next = pid; }
 	void   SetPrevPage (PageID pid) { prev = pid; }
+	void   SetRecLen (int len, int attrs) { recLen = len; numOfAttr = attrs; }
+	int    GetRecLen () { return recLen; }
+	int    GetNumOfAttr () { return numOfAttr; }
+	void   SetZoneMap (int num, const int *offsets);
+	int    GetNumOfZones () { return numOfZones; }
+	const int *GetZoneOffsets () { return zoneOffset; }
+	Zone  *GetZones (PageInfo *info) { return (Zone *)(info + 1); }
+	Status AddToZones (PageID pid, const char *recPtr, int recLen);
+	Status ClearZones (PageID pid);
 	PageID GetNextPage();
+	PageID GetPrevPage() { return prev; }
 	PageInfo *GetEntry(int entry);
 	Bool HasFreeSpace();
 	Bool IsEmpty()   { return (numOfEntry == 0); }
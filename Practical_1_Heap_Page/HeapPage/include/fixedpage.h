@@ -0,0 +1,82 @@
+#ifndef FIXEDPAGE_H
+#define FIXEDPAGE_H
+
+#include "minirel.h"
+#include "page.h"
+#include "heappage.h"
+
+//
+// CHANGE this constant whenever you update the structure of FixedPage class.
+//
+const int FIXEDPAGE_DATA_SIZE=(MAX_SPACE - 3*sizeof(PageID) - 5*sizeof(short));
+
+//
+// A data page of a HeapFile whose records all have the same length.
+// Records are stored densely and an occupancy bitmap replaces the slot
+// directory of HeapPage: record number i is present iff bit i is set.
+//
+// A record is made of numOfAttr attributes of recLen/numOfAttr bytes
+// each.  Attribute a of every record is kept in minipage a (the PAX
+// layout), so attribute a of record i lives at
+//
+//     data + bitmap size + a*capacity*attrLen + i*attrLen
+//
+// With a single attribute this is the plain row layout, and a record
+// can be returned in place.
+//
+// The type field and the page links are at the same positions as in
+// HeapPage, so that the HeapPage methods can look at the type field and
+// forward the call here.
+//
+
+class FixedPage {
+
+protected :
+
+	short   numOfRecords; // Number of records stored in this page.
+	short   recLen;       // Length of every record in this page.
+	short   capacity;     // Number of records this page can hold.
+
+	short   type;         // FIXED_PAGE.
+
+	PageID  pid;          // Page ID of this page
+	PageID  nextPage;     // Page ID of the next page in a link list.
+	PageID  prevPage;     // Page ID of the prev page in a link list.
+
+	short   numOfAttr;    // Number of minipages.
+
+	char data[FIXEDPAGE_DATA_SIZE];
+
+	                      // Occupancy bitmap, followed by the minipages.
+
+	int    BitmapSize()       { return (capacity + 7) / 8; }
+	int    AttrLen()          { return recLen / numOfAttr; }
+	char  *AttrPtr(int i, int a) 
+		{ return data + BitmapSize() + (a*capacity + i)*AttrLen(); }
+	bool   IsUsed(int i)      { return (data[i/8] >> (i%8)) & 1; }
+	bool   IsValid(int i)     { return i >= 0 && i < capacity && IsUsed(i); }
+
+public:
+
+    void Init(PageID pageNo, int recLen, int numOfAttr = 1);
+    PageID GetNextPage()               { return nextPage; }
+    PageID GetPrevPage()               { return prevPage; }
+	PageID PageNo()                    { return pid; }
+    void   SetNextPage(PageID pageNo)  { nextPage = pageNo; }
+    void   SetPrevPage(PageID pageNo)  { prevPage = pageNo; }
+    Status InsertRecord(char* recPtr, int recLen, RecordID& rid);
+    Status DeleteRecord(const RecordID& rid);
+    Status FirstRecord(RecordID& firstRid);
+    Status NextRecord (RecordID curRid, RecordID& nextRid);
+    Status GetRecord(RecordID rid, char* recPtr, int& recLen);
+    Status ReturnRecord(RecordID rid, char*& recPtr, int& recLen);
+    Status UpdateRecord(RecordID rid, char* recPtr, int recLen);
+    Status GetAttrs(RecordID rid, int numOfProj, const int *projAttrs,
+                    char* recPtr, int& recLen);
+    Status ReturnAttr(RecordID rid, int attr, char*& attrPtr);
+    int    AvailableSpace(void);
+    bool   IsEmpty(void);
+    int    GetNumOfRecords();
+};
+
+#endif
@@ -10,6 +10,8 @@
 #define PERMENANT 1
 
 class HeapPage;
+class DirPage;
+struct ScanPredicate;
 
 class HeapFile 
 {
@@ -19,6 +21,9 @@ private :
 	
 	char *filename;
 	int   type;
+	int   fixedRecLen; // Length of every record if the data pages are
+	                   // FixedPages, 0 for slotted HeapPages.
+	int   numOfAttr;   // Number of minipages of the FixedPages.
 
 	PageID dirPid;
 	PageID lastDirPid;
@@ -27,19 +32,39 @@ private :
 	Status NewPage(PageID &pid, PageID &dirPid);
 
 	PageID GetFirstDirPage() { return dirPid; }
+	Bool   IsDataPage(HeapPage *page, PageID pid);
+	Status FindDirPage(PageID pid, PageID& currDirPid);
+	Status DeleteFromPage(const RecordID& rid);
+	Status DeleteStub(const RecordID& rid);
+	Status DeleteStubs(PageID pid);
+	Status RemovePage(PageID pid, PageID currDirPid, DirPage *dirPage);
+	Status VacuumPage(PageID pid);
+	Status ComputeZones(DirPage *dirPage, PageID pid, HeapPage *page);
+	Status WidenZones(PageID pid, char *recPtr, int recLen);
+	Status FindTarget(PageID pid, int space, int needed, PageID& targetPid,
+	                  PageID& targetDirPid);
+
+	void Open(const char *name, int recLen, int attrs, Status& returnStatus);
 
 
 public:
 
     HeapFile( const char* name, Status& returnStatus ); 
+    HeapFile( const char* name, Status& returnStatus, const int recLen, 
+              const int numOfAttr = 1 );
     ~HeapFile();
 	
     int GetNumOfRecords();
+    int GetNumOfPages();
     Status InsertRecord(char* recPtr, int recLen, RecordID& outRid); 
     Status DeleteRecord(const RecordID& rid); 
     Status UpdateRecord(const RecordID& rid, char* recPtr, int recLen);
     Status GetRecord(const RecordID& rid, char* recPtr, int& recLen); 
     class Scan* OpenScan(Status& status);
+    class Scan* OpenScan(Status& status, int numOfProj, const int *projAttrs);
+    class Scan* OpenScan(Status& status, int numOfPreds, const ScanPredicate *preds);
+    Status Vacuum();
+    Status SetZoneMap(int numOfZones, const int *offsets);
 
     Status DeleteFile();
 };
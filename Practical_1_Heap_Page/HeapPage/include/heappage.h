@@ -6,6 +6,27 @@
 
 const int INVALID_SLOT =  -1;
 
+//
+// Values of the type field for the data pages of a HeapFile.  They start
+// after the NodeType values that SortedPage keeps in the same field.
+//
+const short SLOTTED_PAGE = 2;  // HeapPage, variable-length records.
+const short FIXED_PAGE   = 3;  // FixedPage, see fixedpage.h.
+const short STUB_PAGE    = 4;  // HeapPage holding forwarding stubs only.
+
+//
+// A record may be stored away from the page its RecordID names.  Its
+// slot there is then a forwarding stub, so that the RecordID stays
+// valid: the stub holds the RecordID of the record's new place, and the
+// record is stored there behind the RecordID of its stub and flagged as
+// moved.  Scans return a moved record where it is stored, under the
+// RecordID of its stub, and skip the stubs.  A page that HeapFile::Vacuum
+// leaves with stubs only becomes a STUB_PAGE: it leaves the directory of
+// its HeapFile, and is freed when its last stub is deleted.
+//
+const short FORWARD_SLOT = -2;      // Slot::length of a forwarding stub.
+const short MOVED_RECORD = 0x4000;  // Flag in Slot::length of a moved record.
+
 //
 // CHANGE this constant whenever you update the structure of HeapPage class.
 //
@@ -26,10 +47,12 @@ protected :
 	                     // empty.
 	short   fillPtr;     // Offset from start of data area, where 
 	                     // the records resides.
-	short   freeSpace;   // Amount of free space in bytes in this page.
+	short   freeSpace;   // Amount of free space in bytes in this page,
+	                     // including the holes left by deleted records.
 	
-	short   type;        // Not used for HeapFile assignment, but will 
-	                     // be used in B+-tree assignment.
+	short   type;        // Layout of the page (SLOTTED_PAGE, FIXED_PAGE,
+	                     // STUB_PAGE);
+	                     // the B+-tree pages store their NodeType here.
 
 	PageID  pid;         // Page ID of this page  
 	PageID  nextPage;    // Page ID of the next page in a link list.
@@ -46,6 +69,10 @@ protected :
 			     // a page. 
 
 	void CompactSlotDir();
+	int  SlotDirEnd(int slots);
+	int  SlotBytes(int slotNo);
+	Bool IsValidSlot(int slotNo);
+	int  Allocate(int length, int slots);
 
 public:
 
@@ -53,10 +80,18 @@ public:
     PageID GetNextPage();
     PageID GetPrevPage();
 	PageID PageNo() {return pid;}   
+	short  GetType() {return type;}
+	void   SetType(short t) {type = t;}
     void   SetNextPage(PageID pageNo);
     void   SetPrevPage(PageID pageNo);
     Status InsertRecord(char* recPtr, int recLen, RecordID& rid);
     Status DeleteRecord(const RecordID& rid);
+    Status InsertMovedRecord(char* recPtr, int recLen, RecordID homeRid,
+                             RecordID& rid);
+    Status Forward(RecordID rid, RecordID newRid);
+    Status GetForward(RecordID rid, RecordID& newRid);
+    Status GetHome(RecordID rid, RecordID& homeRid);
+    void   Compact();
     Status FirstRecord(RecordID& firstRid);
     Status NextRecord (RecordID curRid, RecordID& nextRid);
     Status GetRecord(RecordID rid, char* recPtr, int& recLen);
@@ -73,9 +108,12 @@ public:
     int    AvailableSpace(void);
     bool   IsEmpty(void);
     int    GetNumOfRecords();
+    int    GetNumOfSlots() { return numOfSlots; }
 };
 
 #define SLOT_IS_EMPTY(s)  ((s).length == INVALID_SLOT)
+#define SLOT_IS_FORWARD(s) ((s).length == FORWARD_SLOT)
+#define SLOT_IS_MOVED(s)  ((s).length >= 0 && ((s).length & MOVED_RECORD))
 #define SLOT_FILL(s, o, l) do { (s).offset = (o); (s).length = (l);} while (0)
 #define SLOT_SET_EMPTY(s)  (s).length = INVALID_SLOT
 
@@ -21,6 +21,11 @@ private:
     int Test4();
     int Test5();
     int Test6();
+    int Test7();
+    int Test8();
+    int Test9();
+    int Test10();
+    int Test11();
 
     Status RunAllTests();
     const char* TestName();
@@ -14,11 +14,25 @@
 class HeapFile;
 class HeapPage;
 
+//
+// A condition "int at offset op value" on the records of a scan.  The
+// int is read from the given byte offset of the record.
+//
+
+struct ScanPredicate
+{
+	int offset;
+	AttrOperator op;
+	int value;
+};
+
 class Scan
 {
 public:
 
   Scan(HeapFile* hf, Status& status);
+  Scan(HeapFile* hf, Status& status, int numOfProj, const int *projAttrs);
+  Scan(HeapFile* hf, Status& status, int numOfPreds, const ScanPredicate *preds);
   ~Scan();
 
   Status GetNext(RecordID& rid, char* recPtr, int& recLen );
@@ -26,6 +40,12 @@ public:
 
 private:
 
+	void Init(HeapFile* hf, Status& status);
+	Status NextPage();
+	Status Advance();
+	Status Matches(RecordID rid);
+	Bool   MayMatch(PageInfo *info);
+
 	PageID currDirPid;
 	PageID firstDirPid;
 	DirPage *dirPage;
@@ -37,6 +57,14 @@ private:
 	RecordID currRid;
 
 	Bool noMore;
+
+	int numOfProj;    // Number of attributes returned by GetNext, 0 to
+	int *projAttrs;   // return whole records, and their numbers.
+
+	int numOfPreds;   // Conditions a record must satisfy to be returned
+	ScanPredicate *preds;  // by GetNext.
+	int attrLen;      // Length of a minipage attribute, 0 if the records
+	                  // are contiguous.
 };
 
 #endif
@@ -0,0 +1,886 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/colfile.h"
+#include "../include/heappage.h"
+#include "../include/scan.h"
+#include "../include/bufmgr.h"
+#include "../include/db.h"
+
+//
+// A position index page of one column: the data pages of the column,
+// in position order, with the position of the first value of each and
+// the number of values it holds.  Uncompressed pages are entered with
+// capacity values as soon as they are created; only the last one of a
+// column may hold fewer.
+//
+
+struct ColumnIndexEntry
+{
+	PageID pid;
+	int    firstPos;
+	int    numOfValues;
+};
+
+#define COLUMN_INDEX_SIZE ((MAX_SPACE - sizeof(int) - sizeof(PageID))/sizeof(ColumnIndexEntry))
+
+struct ColumnIndexPage
+{
+	int    numOfEntry;
+	PageID nextPage;
+	ColumnIndexEntry entries[COLUMN_INDEX_SIZE];
+};
+
+
+//-----------------------------------------------------------------------
+//  Constructor for ColumnFile
+//
+//  Input   : name - name of an existing Column File
+//	Output  : status of initialization
+//-----------------------------------------------------------------------
+
+ColumnFile::ColumnFile( const char *name, Status& returnStatus )
+{
+	filename = NULL;
+	type = PERMENANT;
+	numOfAttr = 0;
+
+	if (name == NULL || MINIBASE_DB->GetFileEntry(name, headerPid) != OK)
+	{
+		cerr << "ColumnFile::ColumnFile - No such file" << endl;
+		returnStatus = FAIL;
+		return;
+	}
+
+	returnStatus = Open(name);
+}
+
+
+//-----------------------------------------------------------------------
+//  Constructor for a new ColumnFile
+//
+//  Input   : name - name of the Column File, NULL for a temporary file
+//            recLen - length of every record of the file
+//            numOfAttr - number of equally long attributes of a record
+//	Output  : status of initialization
+//  Purpose : Create the header page and an empty position index for
+//            every column.  If a file of this name exists already, it
+//            is opened instead.
+//-----------------------------------------------------------------------
+
+ColumnFile::ColumnFile( const char *name, Status& returnStatus, const int len,
+					   const int attrs )
+{
+	ColumnFileHeaderPage *header;
+	ColumnIndexPage *index;
+	Status s;
+
+	filename = NULL;
+	type = PERMENANT;
+	numOfAttr = 0;
+
+	if (name != NULL && MINIBASE_DB->GetFileEntry(name, headerPid) == OK)
+	{
+		returnStatus = Open(name);
+		return;
+	}
+
+	if (attrs <= 0 || attrs > COLFILE_MAX_ATTR || len <= 0 || len % attrs != 0
+		|| len / attrs > COLPAGE_DATA_SIZE)
+	{
+		cerr << "ColumnFile::ColumnFile - Invalid record length " << len
+			<< " for " << attrs << " attributes" << endl;
+		returnStatus = FAIL;
+		return;
+	}
+
+	recLen = len;
+	numOfAttr = attrs;
+	capacity = COLPAGE_DATA_SIZE / AttrLen();
+
+	s = MINIBASE_BM->NewPage(headerPid, (Page *&)header);
+	if (s != OK)
+	{
+		cerr << "Error creating new file.\n" << endl;
+		returnStatus = FAIL;
+		return;
+	}
+
+	if (name == NULL)
+	{
+		type = TEMPORARY;
+	}
+	else
+	{
+		filename = strcpy((char *)malloc(strlen(name)+1), name);
+		type = PERMENANT;
+		MINIBASE_DB->AddFileEntry(name, headerPid);
+	}
+
+	header->recLen = recLen;
+	header->numOfAttr = numOfAttr;
+	header->numOfRecords = 0;
+
+	for (int a = 0; a < numOfAttr; a++)
+	{
+		s = MINIBASE_BM->NewPage(firstIndexPid[a], (Page *&)index);
+		if (s != OK)
+		{
+			cerr << "Error creating new file.\n" << endl;
+			returnStatus = FAIL;
+			return;
+		}
+		index->numOfEntry = 0;
+		index->nextPage = INVALID_PAGE;
+		MINIBASE_BM->UnpinPage(firstIndexPid[a], DIRTY);
+
+		header->firstIndexPid[a] = firstIndexPid[a];
+		header->lastIndexPid[a] = firstIndexPid[a];
+		header->lastPid[a] = INVALID_PAGE;
+	}
+
+	returnStatus = MINIBASE_BM->UnpinPage(headerPid, DIRTY);
+}
+
+
+//-----------------------------------------------------------------------
+//  ColumnFile::Open
+//
+//  Input   : name - name of the existing file whose header page is
+//            headerPid
+//  Purpose : Read the layout of the file from its header page.
+//-----------------------------------------------------------------------
+
+Status ColumnFile::Open( const char *name )
+{
+	ColumnFileHeaderPage *header;
+
+	filename = strcpy((char *)malloc(strlen(name)+1), name);
+	type = PERMENANT;
+
+	PIN(headerPid, header);
+	recLen = header->recLen;
+	numOfAttr = header->numOfAttr;
+	memcpy(firstIndexPid, header->firstIndexPid, sizeof(firstIndexPid));
+	capacity = COLPAGE_DATA_SIZE / AttrLen();
+	UNPIN(headerPid, CLEAN);
+
+	return OK;
+}
+
+
+//-----------------------------------------------------------------------
+// Destructor for Column File
+//-----------------------------------------------------------------------
+
+ColumnFile::~ColumnFile()
+{
+	if (type == TEMPORARY)
+		DeleteFile();
+	free(filename);
+}
+
+
+//-----------------------------------------------------------------------
+// ColumnFile::DeleteFile
+//
+// Purpose   ; Free every page of every column and the header page.
+// Return    : OK if operation is successful, FAIL otherwise
+// -----------------------------------------------------------------------
+
+Status ColumnFile::DeleteFile()
+{
+	ColumnIndexPage *index;
+	PageID indexPid, nextPid;
+
+	for (int a = 0; a < numOfAttr; a++)
+	{
+		indexPid = firstIndexPid[a];
+		while (indexPid != INVALID_PAGE)
+		{
+			PIN(indexPid, index);
+			for (int i = 0; i < index->numOfEntry; i++)
+			{
+				FREEPAGE(index->entries[i].pid);
+			}
+			nextPid = index->nextPage;
+			UNPIN(indexPid, CLEAN);
+			FREEPAGE(indexPid);
+			indexPid = nextPid;
+		}
+	}
+	FREEPAGE(headerPid);
+
+	if (type == PERMENANT)
+		MINIBASE_DB->DeleteFileEntry(filename);
+
+	// Nothing left to delete if the destructor calls us again.
+	numOfAttr = 0;
+	type = PERMENANT;
+	return OK;
+}
+
+
+//-----------------------------------------------------------------------
+// ColumnFile::GetNumOfRecords
+//-----------------------------------------------------------------------
+
+int ColumnFile::GetNumOfRecords()
+{
+	ColumnFileHeaderPage *header;
+	int num;
+
+	PIN(headerPid, header);
+	num = header->numOfRecords;
+	UNPIN(headerPid, CLEAN);
+
+	return num;
+}
+
+
+//-----------------------------------------------------------------------
+// ColumnFile::InsertRecord
+//
+// Input     : pointer to the record, record length
+// Output    : position of the record in the file
+// Purpose   : Append each attribute of the record to its column.
+// Return    : OK if operation is successful, FAIL otherwise
+//-----------------------------------------------------------------------
+
+Status ColumnFile::InsertRecord(char *recPtr, int len, int& pos)
+{
+	ColumnFileHeaderPage *header;
+
+	if (len != recLen)
+	{
+		cerr << " Attempting to insert a record of length " << len
+			<< " into a file of fixed length " << recLen << endl;
+		return FAIL;
+	}
+
+	PIN(headerPid, header);
+	pos = header->numOfRecords;
+
+	for (int a = 0; a < numOfAttr; a++)
+	{
+		if (AppendValue(header, a, pos, recPtr + a*AttrLen()) != OK)
+		{
+			UNPIN(headerPid, DIRTY);
+			return FAIL;
+		}
+	}
+
+	header->numOfRecords++;
+	UNPIN(headerPid, DIRTY);
+
+	return OK;
+}
+
+
+//-----------------------------------------------------------------------
+// ColumnFile::AppendValue
+//
+// Input     : the pinned header page, a column, the position of the
+//             value and the value itself
+// Purpose   : Add the value, uncompressed, at the end of the column,
+//             starting a new data page if the last one is full or
+//             compressed.
+//-----------------------------------------------------------------------
+
+Status ColumnFile::AppendValue(ColumnFileHeaderPage *header, int attr, int pos,
+							   char *valPtr)
+{
+	ColumnPage *page;
+	PageID pid = header->lastPid[attr];
+
+	if (pid != INVALID_PAGE)
+	{
+		PIN(pid, page);
+		if (page->Append(valPtr) == OK)
+		{
+			UNPIN(pid, DIRTY);
+			return OK;
+		}
+		UNPIN(pid, CLEAN);
+	}
+
+	if (AppendPage(header, attr, pos, capacity, pid, page) != OK)
+		return FAIL;
+	page->Init(AttrLen());
+	page->Append(valPtr);
+	UNPIN(pid, DIRTY);
+
+	return OK;
+}
+
+
+//-----------------------------------------------------------------------
+// ColumnFile::AppendPage
+//
+// Input     : the pinned header page, a column, the position of the
+//             first value of the new page and the number of values it
+//             will hold
+// Output    : ID of a new, pinned data page at the end of that column,
+//             for the caller to fill and unpin
+//-----------------------------------------------------------------------
+
+Status ColumnFile::AppendPage(ColumnFileHeaderPage *header, int attr, int firstPos,
+							  int numOfValues, PageID& pid, ColumnPage *&page)
+{
+	ColumnIndexPage *index;
+	PageID indexPid = header->lastIndexPid[attr];
+	ColumnIndexEntry *entry;
+
+	PIN(indexPid, index);
+	if (index->numOfEntry == (int)COLUMN_INDEX_SIZE)
+	{
+		ColumnIndexPage *newIndex;
+		PageID newIndexPid;
+
+		NEWPAGE(newIndexPid, newIndex);
+		newIndex->numOfEntry = 0;
+		newIndex->nextPage = INVALID_PAGE;
+		index->nextPage = newIndexPid;
+		UNPIN(indexPid, DIRTY);
+
+		index = newIndex;
+		indexPid = newIndexPid;
+		header->lastIndexPid[attr] = newIndexPid;
+	}
+
+	NEWPAGE(pid, page);
+
+	entry = &index->entries[index->numOfEntry++];
+	entry->pid = pid;
+	entry->firstPos = firstPos;
+	entry->numOfValues = numOfValues;
+	UNPIN(indexPid, DIRTY);
+
+	header->lastPid[attr] = pid;
+	return OK;
+}
+
+
+//-----------------------------------------------------------------------
+// ColumnFile::BulkLoad
+//
+// Input     : a heap file of records of this file's length
+// Purpose   : Append all the records of the heap file, compressing
+//             every int column.  The values of such a column are
+//             buffered until enough of them are known to fill a page,
+//             which is then written in the encoding that fits the most
+//             of them.  Other columns are stored uncompressed.
+// Return    : OK if operation is successful, FAIL otherwise.  The file
+//             must be empty.  A load that fails may have appended some
+//             columns of a record and not others, so the pages it
+//             appended are freed again and the file left empty, to be
+//             loaded anew.
+//-----------------------------------------------------------------------
+
+Status ColumnFile::BulkLoad(HeapFile *source)
+{
+	ColumnFileHeaderPage *header;
+	Scan *scan;
+	RecordID rid;
+	Status s;
+	char *rec;
+	int len, pos;
+	bool compress = (AttrLen() == sizeof(int));
+	int *values[COLFILE_MAX_ATTR];
+	int numOfValues[COLFILE_MAX_ATTR];
+	int firstPos[COLFILE_MAX_ATTR];
+
+	PIN(headerPid, header);
+	if (header->numOfRecords != 0)
+	{
+		cerr << "ColumnFile::BulkLoad - File is not empty" << endl;
+		UNPIN(headerPid, CLEAN);
+		return FAIL;
+	}
+
+	scan = source->OpenScan(s);
+	if (s != OK)
+	{
+		UNPIN(headerPid, CLEAN);
+		return FAIL;
+	}
+
+	for (int a = 0; compress && a < numOfAttr; a++)
+	{
+		values[a] = new int[COLPAGE_MAX_VALUES];
+		numOfValues[a] = 0;
+		firstPos[a] = 0;
+	}
+
+	rec = new char[recLen];
+	pos = 0;
+	while (s == OK && (s = scan->GetNext(rid, rec, len)) == OK)
+	{
+		if (len != recLen)
+		{
+			cerr << "ColumnFile::BulkLoad - Record of length " << len
+				<< " in a file of fixed length " << recLen << endl;
+			s = FAIL;
+			break;
+		}
+
+		for (int a = 0; a < numOfAttr && s == OK; a++)
+		{
+			if (!compress)
+				s = AppendValue(header, a, pos, rec + a*AttrLen());
+			else
+			{
+				memcpy(&values[a][numOfValues[a]++], rec + a*AttrLen(), sizeof(int));
+				if (numOfValues[a] == COLPAGE_MAX_VALUES)
+					s = FlushValues(header, a, values[a], numOfValues[a], firstPos[a], false);
+			}
+		}
+		pos++;
+	}
+	if (s == DONE)
+		s = OK;
+
+	for (int a = 0; compress && a < numOfAttr; a++)
+	{
+		if (s == OK)
+			s = FlushValues(header, a, values[a], numOfValues[a], firstPos[a], true);
+		delete [] values[a];
+	}
+	delete [] rec;
+	delete scan;
+
+	if (s == OK)
+		header->numOfRecords = pos;
+	else
+		EmptyColumns(header);
+	UNPIN(headerPid, DIRTY);
+
+	return s;
+}
+
+
+//-----------------------------------------------------------------------
+// ColumnFile::EmptyColumns
+//
+// Input     : the pinned header page
+// Purpose   : Free every data page of every column, and every position
+//             index page but the first, which is left with no entries,
+//             as a new file has it.
+//-----------------------------------------------------------------------
+
+Status ColumnFile::EmptyColumns(ColumnFileHeaderPage *header)
+{
+	ColumnIndexPage *index;
+	PageID indexPid, nextPid;
+
+	for (int a = 0; a < numOfAttr; a++)
+	{
+		indexPid = firstIndexPid[a];
+		while (indexPid != INVALID_PAGE)
+		{
+			PIN(indexPid, index);
+			for (int i = 0; i < index->numOfEntry; i++)
+			{
+				FREEPAGE(index->entries[i].pid);
+			}
+			nextPid = index->nextPage;
+			if (indexPid == firstIndexPid[a])
+			{
+				index->numOfEntry = 0;
+				index->nextPage = INVALID_PAGE;
+				UNPIN(indexPid, DIRTY);
+			}
+			else
+			{
+				UNPIN(indexPid, CLEAN);
+				FREEPAGE(indexPid);
+			}
+			indexPid = nextPid;
+		}
+
+		header->lastIndexPid[a] = firstIndexPid[a];
+		header->lastPid[a] = INVALID_PAGE;
+	}
+	return OK;
+}
+
+
+//-----------------------------------------------------------------------
+// ColumnFile::FlushValues
+//
+// Input     : the pinned header page, a column, the values buffered for
+//             it and the position of the first of them, all - true if
+//             no more values will follow
+// Purpose   : Write the buffered values to new compressed pages at the
+//             end of the column.  Unless all is set, a page that would
+//             not be full is not written; its values are moved to the
+//             front of the buffer instead, to be written with the next
+//             ones.
+//-----------------------------------------------------------------------
+
+Status ColumnFile::FlushValues(ColumnFileHeaderPage *header, int attr, int *values,
+							   int& numOfValues, int& firstPos, bool all)
+{
+	ColumnPage *page;
+	PageID pid;
+	int done = 0;
+
+	while (done < numOfValues)
+	{
+		int n = ColumnPage::Fit(values + done, numOfValues - done);
+
+		if (!all && n == numOfValues - done && n < COLPAGE_MAX_VALUES)
+			break;
+
+		if (AppendPage(header, attr, firstPos, n, pid, page) != OK)
+			return FAIL;
+		page->Encode(values + done, n);
+		UNPIN(pid, DIRTY);
+
+		done += n;
+		firstPos += n;
+	}
+
+	memmove(values, values + done, (numOfValues - done)*sizeof(int));
+	numOfValues -= done;
+	return OK;
+}
+
+
+//-----------------------------------------------------------------------
+// ColumnFile::FindPage
+//
+// Input     : a column, a position
+// Output    : ID of the data page of that column holding the position,
+//             and the position of the first value of that page
+//-----------------------------------------------------------------------
+
+Status ColumnFile::FindPage(int attr, int pos, PageID& pid, int& firstPos)
+{
+	ColumnIndexPage *index;
+	PageID indexPid = firstIndexPid[attr];
+	PageID next;
+	ColumnIndexEntry *last;
+
+	PIN(indexPid, index);
+	last = &index->entries[index->numOfEntry - 1];
+	while (pos >= last->firstPos + last->numOfValues && index->nextPage != INVALID_PAGE)
+	{
+		next = index->nextPage;
+		UNPIN(indexPid, CLEAN);
+		indexPid = next;
+		PIN(indexPid, index);
+		last = &index->entries[index->numOfEntry - 1];
+	}
+
+	for (int i = 0; i < index->numOfEntry; i++)
+	{
+		if (pos < index->entries[i].firstPos + index->entries[i].numOfValues)
+		{
+			pid = index->entries[i].pid;
+			firstPos = index->entries[i].firstPos;
+			UNPIN(indexPid, CLEAN);
+			return OK;
+		}
+	}
+
+	UNPIN(indexPid, CLEAN);
+	return FAIL;
+}
+
+
+//-----------------------------------------------------------------------
+// ColumnFile::GetAttr
+//
+// Input    : position of a record, attribute number
+// Output   : A copy of that attribute of the record
+// Return   : OK if the attribute is found, FAIL otherwise
+//-----------------------------------------------------------------------
+
+Status ColumnFile::GetAttr(int pos, int attr, char *valPtr)
+{
+	ColumnPage *page;
+	PageID pid;
+	int firstPos;
+
+	if (attr < 0 || attr >= numOfAttr || pos < 0 || pos >= GetNumOfRecords())
+		return FAIL;
+	if (FindPage(attr, pos, pid, firstPos) != OK)
+		return FAIL;
+
+	PIN(pid, page);
+	page->GetValue(pos - firstPos, valPtr);
+	UNPIN(pid, CLEAN);
+
+	return OK;
+}
+
+
+//-----------------------------------------------------------------------
+// ColumnFile::GetRecord
+//
+// Input    : position of a record
+// Output   : A copy of the record, put back together from all the
+//            columns, record's length
+// Return   : OK if the record is found, FAIL otherwise
+//-----------------------------------------------------------------------
+
+Status ColumnFile::GetRecord(int pos, char *recPtr, int& len)
+{
+	for (int a = 0; a < numOfAttr; a++)
+	{
+		if (GetAttr(pos, a, recPtr + a*AttrLen()) != OK)
+			return FAIL;
+	}
+	len = recLen;
+	return OK;
+}
+
+
+//-----------------------------------------------------------------------
+// ColumnFile::OpenScan
+//
+// Input    : numOfProj - number of attributes wanted
+//            projAttrs - their attribute numbers
+//            filterAttr, op, value - if given, only the records whose
+//            int attribute filterAttr satisfies "attribute op value"
+//            are returned
+// Purpose  : Initiate a scan in position order over those columns.
+//-----------------------------------------------------------------------
+
+ColumnScan *ColumnFile::OpenScan(Status& status, int numOfProj, const int *projAttrs)
+{
+	return OpenScan(status, numOfProj, projAttrs, -1, aopNOP, 0);
+}
+
+ColumnScan *ColumnFile::OpenScan(Status& status, int numOfProj, const int *projAttrs,
+								 int filterAttr, AttrOperator op, int value)
+{
+	ColumnScan *newScan;
+
+	for (int p = 0; p < numOfProj; p++)
+	{
+		if (projAttrs[p] < 0 || projAttrs[p] >= numOfAttr)
+		{
+			cerr << "ColumnFile::OpenScan - No attribute " << projAttrs[p] << endl;
+			status = FAIL;
+			return NULL;
+		}
+	}
+
+	if (filterAttr == -1)
+		newScan = new ColumnScan(this, status, numOfProj, projAttrs);
+	else if (filterAttr < 0 || filterAttr >= numOfAttr || AttrLen() != sizeof(int))
+	{
+		cerr << "ColumnFile::OpenScan - Cannot filter on attribute " << filterAttr << endl;
+		status = FAIL;
+		return NULL;
+	}
+	else
+		newScan = new ColumnScan(this, status, numOfProj, projAttrs, filterAttr, op, value);
+
+	if (status == OK)
+	    return newScan;
+	else
+	{
+	    delete newScan;
+	    return NULL;
+	}
+}
+
+
+//------------------------------------------------------------------
+// Constructors of ColumnScan
+//------------------------------------------------------------------
+
+ColumnScan::ColumnScan(ColumnFile *cf, Status& status, int numOfProj, const int *projAttrs)
+{
+	Init(cf, numOfProj, projAttrs);
+	filtered = false;
+	filter.values = NULL;
+
+	status = OK;
+}
+
+ColumnScan::ColumnScan(ColumnFile *cf, Status& status, int numOfProj, const int *projAttrs,
+					   int filterAttr, AttrOperator op, int value)
+{
+	Init(cf, numOfProj, projAttrs);
+	filtered = true;
+	this->op = op;
+	this->value = value;
+	InitCursor(filter, filterAttr, COLPAGE_MAX_VALUES);
+
+	status = OK;
+}
+
+
+//------------------------------------------------------------------
+// ColumnScan::Init
+//
+// Purpose  : Set up a cursor at the start of every wanted column.  The
+//            cursors decode a whole page at a time, which for an int
+//            column may hold up to COLPAGE_MAX_VALUES values.
+//------------------------------------------------------------------
+
+void ColumnScan::Init(ColumnFile *cf, int numOfProj, const int *projAttrs)
+{
+	int attrLen = cf->AttrLen();
+	int size = (attrLen == sizeof(int)) ? COLPAGE_MAX_VALUES*sizeof(int) : COLPAGE_DATA_SIZE;
+
+	file = cf;
+	this->numOfProj = numOfProj;
+	this->projAttrs = new int[numOfProj];
+	memcpy(this->projAttrs, projAttrs, numOfProj*sizeof(int));
+
+	cursor = new Cursor[numOfProj];
+	for (int p = 0; p < numOfProj; p++)
+		InitCursor(cursor[p], projAttrs[p], size);
+
+	currPos = 0;
+	numOfRecords = cf->GetNumOfRecords();
+}
+
+
+void ColumnScan::InitCursor(Cursor& c, int attr, int size)
+{
+	c.indexPid = file->firstIndexPid[attr];
+	c.entry = -1;
+	c.pid = INVALID_PAGE;
+	c.firstPos = 0;
+	c.endPos = 0;
+	c.loaded = false;
+	c.values = new char[size];
+}
+
+
+//------------------------------------------------------------------
+// Destructor of ColumnScan
+//------------------------------------------------------------------
+
+ColumnScan::~ColumnScan()
+{
+	for (int p = 0; p < numOfProj; p++)
+		delete [] cursor[p].values;
+	delete [] cursor;
+	delete [] projAttrs;
+	delete [] filter.values;
+}
+
+
+//------------------------------------------------------------------
+// ColumnScan::Seek
+//
+// Input    : a cursor, a position not before the cursor's page
+// Purpose  : Move the cursor to the data page holding the position,
+//            using the position index only: the data pages skipped
+//            over are not read.
+//------------------------------------------------------------------
+
+Status ColumnScan::Seek(Cursor& c, int pos)
+{
+	ColumnIndexPage *index;
+
+	if (pos < c.endPos)
+		return OK;
+
+	PIN(c.indexPid, index);
+	while (pos >= c.endPos)
+	{
+		c.entry++;
+		if (c.entry == index->numOfEntry)
+		{
+			PageID next = index->nextPage;
+
+			UNPIN(c.indexPid, CLEAN);
+			if (next == INVALID_PAGE)
+				return DONE;
+			c.indexPid = next;
+			c.entry = 0;
+			PIN(c.indexPid, index);
+		}
+		c.pid = index->entries[c.entry].pid;
+		c.firstPos = index->entries[c.entry].firstPos;
+		c.endPos = c.firstPos + index->entries[c.entry].numOfValues;
+	}
+	UNPIN(c.indexPid, CLEAN);
+
+	c.loaded = false;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// ColumnScan::Load
+//
+// Input    : a cursor, select - true to evaluate the predicate of the
+//            scan on the page rather than decode it
+// Purpose  : Read the data page of the cursor, if not done already.
+//------------------------------------------------------------------
+
+Status ColumnScan::Load(Cursor& c, bool select)
+{
+	ColumnPage *page;
+
+	if (c.loaded)
+		return OK;
+
+	PIN(c.pid, page);
+	if (select)
+		page->Select(op, value, c.values);
+	else
+		page->Decode(c.values);
+	UNPIN(c.pid, CLEAN);
+
+	c.loaded = true;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// ColumnScan::GetNext
+//
+// Input    : recPtr: pointer to the copy of the attributes, you must
+//				allocate space for this pointer before calling this function
+// Output   : the wanted attributes of the next record, one after the
+//            other, their total length and the record's position
+// Return   : OK if successful, DONE if no more records, FAIL if error
+//------------------------------------------------------------------
+
+Status ColumnScan::GetNext(int& pos, char *recPtr, int& recLen)
+{
+	int attrLen = file->AttrLen();
+
+	while (filtered)
+	{
+		int end;
+
+		if (currPos >= numOfRecords)
+			return DONE;
+		if (Seek(filter, currPos) != OK || Load(filter, true) != OK)
+			return FAIL;
+
+		end = (filter.endPos < numOfRecords) ? filter.endPos : numOfRecords;
+		while (currPos < end && !filter.values[currPos - filter.firstPos])
+			currPos++;
+		if (currPos < end)
+			break;
+	}
+
+	if (currPos >= numOfRecords)
+		return DONE;
+
+	for (int p = 0; p < numOfProj; p++)
+	{
+		Cursor& c = cursor[p];
+
+		if (Seek(c, currPos) != OK || Load(c, false) != OK)
+			return FAIL;
+		memcpy(recPtr + p*attrLen, c.values + (currPos - c.firstPos)*attrLen, attrLen);
+	}
+
+	recLen = numOfProj * attrLen;
+	pos = currPos++;
+	return OK;
+}
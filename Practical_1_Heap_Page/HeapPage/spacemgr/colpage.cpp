@@ -0,0 +1,477 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/colpage.h"
+
+//------------------------------------------------------------------
+// Number of bits needed to store any value from 0 to v.
+//------------------------------------------------------------------
+
+static int BitsFor(unsigned v)
+{
+	int bits = 0;
+
+	while (v)
+	{
+		bits++;
+		v >>= 1;
+	}
+	return bits;
+}
+
+
+//------------------------------------------------------------------
+// Compare
+//
+// Purpose  : Evaluate "v op value".  Takes long longs so that it can
+//            compare frame-of-reference codes against a shifted
+//            constant without overflow.
+//------------------------------------------------------------------
+
+static int Compare(long long v, AttrOperator op, long long value)
+{
+	switch (op)
+	{
+	case aopEQ : return v == value;
+	case aopLT : return v < value;
+	case aopGT : return v > value;
+	case aopNE : return v != value;
+	case aopLE : return v <= value;
+	case aopGE : return v >= value;
+	case aopNOP: return 1;
+	default    : return 0;
+	}
+}
+
+
+//------------------------------------------------------------------
+// Cheapest
+//
+// Input    : statistics of n values: the span between their minimum
+//            and maximum, the number of distinct values (-1 if more
+//            than COLPAGE_MAX_DICT), the number of runs
+// Output   : the encoding that stores them in the fewest bytes
+// Return   : the number of data bytes that encoding needs
+//------------------------------------------------------------------
+
+static int Cheapest(int n, unsigned span, int numOfDict, int runs, short& encoding)
+{
+	int size, best;
+
+	best = n * sizeof(int);
+	encoding = ENC_PLAIN;
+
+	size = (n * BitsFor(span) + 7) / 8;
+	if (size < best)
+	{
+		best = size;
+		encoding = ENC_FOR;
+	}
+
+	if (numOfDict > 0)
+	{
+		size = numOfDict * sizeof(int) + (n * BitsFor(numOfDict - 1) + 7) / 8;
+		if (size < best)
+		{
+			best = size;
+			encoding = ENC_DICT;
+		}
+	}
+
+	size = runs * 2 * sizeof(int);
+	if (size < best)
+	{
+		best = size;
+		encoding = ENC_RLE;
+	}
+
+	return best;
+}
+
+
+//------------------------------------------------------------------
+// AddToStats
+//
+// Input    : values, of which values[0..i-1] have already been added
+// Purpose  : Add values[i] to the statistics Cheapest() needs: the
+//            minimum, the maximum, the number of runs and the distinct
+//            values (numOfDict becomes -1 once there are too many).
+//------------------------------------------------------------------
+
+static void AddToStats(const int *values, int i, int *dict, int& numOfDict,
+					   int& runs, int& minV, int& maxV)
+{
+	int v = values[i];
+
+	if (i == 0 || v < minV)
+		minV = v;
+	if (i == 0 || v > maxV)
+		maxV = v;
+	if (i == 0 || v != values[i-1])
+		runs++;
+
+	if (numOfDict >= 0)
+	{
+		int d = 0;
+		while (d < numOfDict && dict[d] != v)
+			d++;
+		if (d == numOfDict)
+		{
+			if (numOfDict == COLPAGE_MAX_DICT)
+				numOfDict = -1;
+			else
+				dict[numOfDict++] = v;
+		}
+	}
+}
+
+
+//------------------------------------------------------------------
+// ColumnPage::Init
+//
+// Input    : length of the values
+// Purpose  : Make an empty ENC_PLAIN page, to be filled by Append.
+//------------------------------------------------------------------
+
+void ColumnPage::Init(int len)
+{
+	numOfValues = 0;
+	base = 0;
+	encoding = ENC_PLAIN;
+	bitWidth = 0;
+	attrLen = len;
+}
+
+
+//------------------------------------------------------------------
+// ColumnPage::Append
+//
+// Input    : pointer to a value
+// Purpose  : Add the value at the end of an ENC_PLAIN page.
+// Return   : OK, DONE if the page is full, FAIL if it is compressed.
+//------------------------------------------------------------------
+
+Status ColumnPage::Append(const char *valPtr)
+{
+	if (encoding != ENC_PLAIN)
+		return FAIL;
+	if ((numOfValues + 1) * attrLen > COLPAGE_DATA_SIZE)
+		return DONE;
+
+	memcpy(data + numOfValues * attrLen, valPtr, attrLen);
+	numOfValues++;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// ColumnPage::Fit
+//
+// Input    : n int values
+// Return   : how many of the first values fit in one page, using
+//            whichever encoding suits them best
+//------------------------------------------------------------------
+
+int ColumnPage::Fit(const int *values, int n)
+{
+	int dict[COLPAGE_MAX_DICT];
+	int numOfDict = 0;
+	int runs = 0;
+	int minV = 0, maxV = 0;
+	short encoding;
+
+	for (int i = 0; i < n; i++)
+	{
+		if (i == COLPAGE_MAX_VALUES)
+			return i;
+
+		AddToStats(values, i, dict, numOfDict, runs, minV, maxV);
+		if (Cheapest(i + 1, (unsigned)maxV - (unsigned)minV, numOfDict, runs,
+			encoding) > COLPAGE_DATA_SIZE)
+			return i;
+	}
+	return n;
+}
+
+
+//------------------------------------------------------------------
+// ColumnPage::Encode
+//
+// Input    : n int values, n no more than Fit() allows
+// Purpose  : Fill the page with the values, in the cheapest encoding.
+//------------------------------------------------------------------
+
+void ColumnPage::Encode(const int *values, int n)
+{
+	int dict[COLPAGE_MAX_DICT];
+	int numOfDict = 0;
+	int runs = 0;
+	int minV = 0, maxV = 0;
+
+	for (int i = 0; i < n; i++)
+		AddToStats(values, i, dict, numOfDict, runs, minV, maxV);
+
+	numOfValues = n;
+	attrLen = sizeof(int);
+	Cheapest(n, (unsigned)maxV - (unsigned)minV, numOfDict, runs, encoding);
+
+	switch (encoding)
+	{
+	case ENC_PLAIN :
+		base = 0;
+		bitWidth = 0;
+		memcpy(data, values, n * sizeof(int));
+		break;
+
+	case ENC_FOR :
+		base = minV;
+		bitWidth = BitsFor((unsigned)maxV - (unsigned)minV);
+		memset(data, 0, COLPAGE_DATA_SIZE);
+		for (int i = 0; i < n; i++)
+			PutBits(data, i, (unsigned)values[i] - (unsigned)minV);
+		break;
+
+	case ENC_DICT :
+	{
+		char *codes = data + numOfDict * sizeof(int);
+
+		base = numOfDict;
+		bitWidth = BitsFor(numOfDict - 1);
+		memset(data, 0, COLPAGE_DATA_SIZE);
+		memcpy(data, dict, numOfDict * sizeof(int));
+		for (int i = 0; i < n; i++)
+		{
+			int d = 0;
+			while (dict[d] != values[i])
+				d++;
+			PutBits(codes, i, d);
+		}
+		break;
+	}
+
+	case ENC_RLE :
+	{
+		int *run = (int *)data;
+
+		base = 0;
+		bitWidth = 0;
+		for (int i = 0; i < n; i++)
+		{
+			if (i == 0 || values[i] != values[i-1])
+			{
+				run[2*base] = values[i];
+				run[2*base + 1] = 0;
+				base++;
+			}
+			run[2*base - 1]++;
+		}
+		break;
+	}
+	}
+}
+
+
+//------------------------------------------------------------------
+// ColumnPage::GetBits, ColumnPage::PutBits
+//
+// Purpose  : Read or write the bitWidth bits of packed value i in buf,
+//            least significant bit first.  PutBits expects the bits
+//            to be zero.
+//------------------------------------------------------------------
+
+unsigned ColumnPage::GetBits(const char *buf, int i)
+{
+	unsigned v = 0;
+	int bit = i * bitWidth;
+
+	for (int k = 0; k < bitWidth; )
+	{
+		int off = (bit + k) % 8;
+		int take = (8 - off < bitWidth - k) ? 8 - off : bitWidth - k;
+
+		v |= ((((unsigned char)buf[(bit + k) / 8]) >> off) & ((1u << take) - 1)) << k;
+		k += take;
+	}
+	return v;
+}
+
+void ColumnPage::PutBits(char *buf, int i, unsigned v)
+{
+	int bit = i * bitWidth;
+
+	for (int k = 0; k < bitWidth; )
+	{
+		int off = (bit + k) % 8;
+		int take = (8 - off < bitWidth - k) ? 8 - off : bitWidth - k;
+
+		buf[(bit + k) / 8] |= ((v >> k) & ((1u << take) - 1)) << off;
+		k += take;
+	}
+}
+
+
+//------------------------------------------------------------------
+// ColumnPage::GetInt
+//
+// Input    : number of a value in the page
+// Return   : the value, decoded
+//------------------------------------------------------------------
+
+int ColumnPage::GetInt(int i)
+{
+	switch (encoding)
+	{
+	case ENC_FOR :
+		return (int)((unsigned)base + GetBits(data, i));
+
+	case ENC_DICT :
+		return ((int *)data)[GetBits(data + base * sizeof(int), i)];
+
+	case ENC_RLE :
+	{
+		int *run = (int *)data;
+		int r = 0;
+
+		while (i >= run[2*r + 1])
+		{
+			i -= run[2*r + 1];
+			r++;
+		}
+		return run[2*r];
+	}
+
+	default :
+		return ((int *)data)[i];
+	}
+}
+
+
+//------------------------------------------------------------------
+// ColumnPage::GetValue
+//
+// Input    : number of a value in the page
+// Output   : a copy of the value
+//------------------------------------------------------------------
+
+void ColumnPage::GetValue(int i, char *valPtr)
+{
+	if (encoding == ENC_PLAIN)
+		memcpy(valPtr, data + i * attrLen, attrLen);
+	else
+	{
+		int v = GetInt(i);
+		memcpy(valPtr, &v, sizeof(int));
+	}
+}
+
+
+//------------------------------------------------------------------
+// ColumnPage::Decode
+//
+// Output   : a copy of all the values of the page, one after the other
+//------------------------------------------------------------------
+
+void ColumnPage::Decode(char *valPtr)
+{
+	int *out = (int *)valPtr;
+
+	switch (encoding)
+	{
+	case ENC_FOR :
+		for (int i = 0; i < numOfValues; i++)
+			out[i] = (int)((unsigned)base + GetBits(data, i));
+		break;
+
+	case ENC_DICT :
+	{
+		int *dict = (int *)data;
+		char *codes = data + base * sizeof(int);
+
+		for (int i = 0; i < numOfValues; i++)
+			out[i] = dict[GetBits(codes, i)];
+		break;
+	}
+
+	case ENC_RLE :
+	{
+		int *run = (int *)data;
+
+		for (int r = 0; r < base; r++)
+			for (int k = 0; k < run[2*r + 1]; k++)
+				*out++ = run[2*r];
+		break;
+	}
+
+	default :
+		memcpy(valPtr, data, numOfValues * attrLen);
+	}
+}
+
+
+//------------------------------------------------------------------
+// ColumnPage::Select
+//
+// Input    : a predicate "value op constant" on an int column
+// Output   : match[i] is 1 if value i of the page satisfies it, else 0
+// Purpose  : Evaluate the predicate without decoding the page: on the
+//            codes for ENC_FOR, once per dictionary entry for ENC_DICT
+//            and once per run for ENC_RLE.
+// Return   : the number of matching values
+//------------------------------------------------------------------
+
+int ColumnPage::Select(AttrOperator op, int value, char *match)
+{
+	int count = 0;
+
+	switch (encoding)
+	{
+	case ENC_FOR :
+	{
+		long long shifted = (long long)value - base;
+
+		for (int i = 0; i < numOfValues; i++)
+			count += (match[i] = Compare(GetBits(data, i), op, shifted));
+		break;
+	}
+
+	case ENC_DICT :
+	{
+		char qualifies[COLPAGE_MAX_DICT];
+		int *dict = (int *)data;
+		char *codes = data + base * sizeof(int);
+
+		for (int d = 0; d < base; d++)
+			qualifies[d] = Compare(dict[d], op, value);
+		for (int i = 0; i < numOfValues; i++)
+			count += (match[i] = qualifies[GetBits(codes, i)]);
+		break;
+	}
+
+	case ENC_RLE :
+	{
+		int *run = (int *)data;
+		int i = 0;
+
+		for (int r = 0; r < base; r++)
+		{
+			char q = Compare(run[2*r], op, value);
+
+			memset(match + i, q, run[2*r + 1]);
+			i += run[2*r + 1];
+			if (q)
+				count += run[2*r + 1];
+		}
+		break;
+	}
+
+	default :
+	{
+		int *v = (int *)data;
+
+		for (int i = 0; i < numOfValues; i++)
+			count += (match[i] = Compare(v[i], op, value));
+	}
+	}
+
+	return count;
+}
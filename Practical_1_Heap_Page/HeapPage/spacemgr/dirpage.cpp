@@ -1,4 +1,5 @@
 #include <string.h>
+#include <limits.h>
 
 #include "../include/bufmgr.h"
 #include "../include/heappage.h"
@@ -7,6 +8,9 @@
 Status DirPage::Init(PageID pid)
 {
 	numOfEntry = 0;
+	recLen = 0;
+	numOfAttr = 0;
+	numOfZones = 0;
 	curr = pid;
 	next = INVALID_PAGE;
 	prev = INVALID_PAGE;
@@ -27,9 +31,9 @@ Status DirPage::InsertPage(PageID pid, HeapPage *page)
 	info.numOfRecords = 0;
 
 	
-	memcpy(&data[numOfEntry*sizeof(PageInfo)], &info, sizeof(PageInfo));
+	memcpy(&data[numOfEntry*EntrySize()], &info, sizeof(PageInfo));
  	numOfEntry++;
-	return OK;
+	return ClearZones(pid);
 }
 
 
@@ -38,12 +42,12 @@ Status DirPage::DeletePage(PageID pid)
 	int toDelete;
 
 	toDelete = FindPageInfoEntry(pid);
-	if (toDelete == 0)
+	if (toDelete == -1)
 		return FAIL;
 	else
-		memmove(&data[toDelete*sizeof(PageInfo)], 
-			&data[(toDelete+1)*sizeof(PageInfo)], 
-			(numOfEntry - toDelete)*sizeof(PageInfo));
+		memmove(&data[toDelete*EntrySize()], 
+			&data[(toDelete+1)*EntrySize()], 
+			(numOfEntry - toDelete - 1)*EntrySize());
 
 	numOfEntry--;
 	return OK;
@@ -58,7 +62,7 @@ PageInfo *DirPage::FindPageInfo(PageID pid)
 	info = (PageInfo *)&data;
 	for (int i = 0; i < numOfEntry; i++)
 	{
-		info = (PageInfo *)&data[i*sizeof(PageInfo)];
+		info = (PageInfo *)&data[i*EntrySize()];
 		if (info->pid == pid)
 			return info;
 	}
@@ -68,7 +72,7 @@ PageInfo *DirPage::FindPageInfo(PageID pid)
 
 Bool DirPage::HasFreeSpace()
 {
-	return (numOfEntry < DIR_PAGE_SIZE/sizeof(PageInfo));
+	return (numOfEntry < DIR_PAGE_SIZE/EntrySize());
 }
 
 
@@ -103,7 +107,7 @@ int DirPage::FindPageInfoEntry(PageID pid)
 	info = (PageInfo *)&data;
 	for (int i = 0; i < numOfEntry; i++)
 	{
-		info = (PageInfo *)&data[i*sizeof(PageInfo)];
+		info = (PageInfo *)&data[i*EntrySize()];
 		if (info->pid == pid)
 			return i;
 	}
@@ -114,7 +118,7 @@ int DirPage::FindPageInfoEntry(PageID pid)
 PageInfo *DirPage::GetPageInfo(int entry)
 {
 	if (entry < numOfEntry)
-		return (PageInfo *)&data[entry*sizeof(PageInfo)];
+		return (PageInfo *)&data[entry*EntrySize()];
 	else
 		return NULL;
 }
@@ -151,6 +155,81 @@ Status DirPage::DeleteRecordFromPage (PageID pid, HeapPage *page)
 	}
 }
 
+Status DirPage::UpdatePage (PageID pid, HeapPage *page)
+{
+	PageInfo *info;
+
+	info = FindPageInfo(pid);
+	if (info == NULL)
+		return FAIL;
+	else
+	{
+		info->spaceAvailable = page->AvailableSpace();
+		return OK;
+	}
+}
+
+void DirPage::SetZoneMap (int num, const int *offsets)
+{
+	// ASSERT : the page has no entries yet.
+
+	numOfZones = num;
+	memcpy(zoneOffset, offsets, num*sizeof(int));
+}
+
+
+//------------------------------------------------------------------
+// DirPage::AddToZones
+//
+// Input    : a data page, a record inserted into it or updated
+// Purpose  : Widen the zones of the page to include the record's
+//            values.  Records too short to hold an attribute do not
+//            change its zone.
+//------------------------------------------------------------------
+
+Status DirPage::AddToZones (PageID pid, const char *recPtr, int recLen)
+{
+	PageInfo *info;
+	Zone *zones;
+	int v;
+
+	info = FindPageInfo(pid);
+	if (info == NULL)
+		return FAIL;
+
+	zones = GetZones(info);
+	for (int z = 0; z < numOfZones; z++)
+	{
+		if (zoneOffset[z] + (int)sizeof(int) > recLen)
+			continue;
+		memcpy(&v, recPtr + zoneOffset[z], sizeof(int));
+		if (v < zones[z].min)
+			zones[z].min = v;
+		if (v > zones[z].max)
+			zones[z].max = v;
+	}
+	return OK;
+}
+
+
+Status DirPage::ClearZones (PageID pid)
+{
+	PageInfo *info;
+	Zone *zones;
+
+	info = FindPageInfo(pid);
+	if (info == NULL)
+		return FAIL;
+
+	zones = GetZones(info);
+	for (int z = 0; z < numOfZones; z++)
+	{
+		zones[z].min = INT_MAX;
+		zones[z].max = INT_MIN;
+	}
+	return OK;
+}
+
 PageID DirPage::GetNextPage()
 {
 	return next;
@@ -0,0 +1,265 @@
+#include <iostream>
+#include <stdlib.h>
+#include <memory.h>
+
+#include "../include/fixedpage.h"
+
+using namespace std;
+
+//------------------------------------------------------------------
+// FixedPage::Init
+//
+// Input     : Page ID, length of the records to be stored, number of
+//             (equally long) attributes the records are made of
+// Output    : None
+// Purpose   : Work out how many records fit in the page, given that
+//             every record costs recLen bytes plus one bit of bitmap.
+//------------------------------------------------------------------
+
+void FixedPage::Init(PageID pageNo, int len, int attrs)
+{
+	prevPage = INVALID_PAGE;
+	nextPage = INVALID_PAGE;
+	pid = pageNo;
+	type = FIXED_PAGE;
+
+	recLen = len;
+	numOfAttr = attrs;
+	numOfRecords = 0;
+	capacity = (8 * FIXEDPAGE_DATA_SIZE) / (8 * len + 1);
+	memset(data, 0, BitmapSize());
+}
+
+
+//------------------------------------------------------------------
+// FixedPage::InsertRecord
+//
+// Input     : Pointer to the record and the record's length
+// Output    : Record ID of the record inserted.
+// Purpose   : Copy the record into the first free position, one
+//             attribute into each minipage.
+// Return    : OK if everything went OK, DONE if the page is full,
+//             FAIL if the record does not have the page's length.
+//------------------------------------------------------------------
+
+Status FixedPage::InsertRecord(char *recPtr, int length, RecordID& rid)
+{
+	if (length != recLen)
+		return FAIL;
+	if (numOfRecords == capacity)
+		return DONE;
+
+	int i = 0;
+	while (IsUsed(i))
+		i++;
+
+	for (int a = 0; a < numOfAttr; a++)
+		memcpy(AttrPtr(i, a), recPtr + a*AttrLen(), AttrLen());
+	data[i/8] |= (1 << (i%8));
+	numOfRecords++;
+
+	rid.pageNo = pid;
+	rid.slotNo = i;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// FixedPage::DeleteRecord
+//
+// Input    : Record ID
+// Output   : None
+// Purpose  : Clear the record's bit; its position can be reused.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status FixedPage::DeleteRecord(const RecordID& rid)
+{
+	if (!IsValid(rid.slotNo))
+		return FAIL;
+
+	data[rid.slotNo/8] &= ~(1 << (rid.slotNo%8));
+	numOfRecords--;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// FixedPage::FirstRecord
+//
+// Input    : None
+// Output   : record id of the first record on a page
+// Return   : OK if successful, DONE otherwise
+//------------------------------------------------------------------
+
+Status FixedPage::FirstRecord(RecordID& rid)
+{
+	RecordID before;
+
+	before.pageNo = pid;
+	before.slotNo = -1;
+	return NextRecord(before, rid);
+}
+
+
+//------------------------------------------------------------------
+// FixedPage::NextRecord
+//
+// Input    : ID of the current record
+// Output   : ID of the next record
+// Return   : DONE if no more records exist on the page; otherwise OK
+//------------------------------------------------------------------
+
+Status FixedPage::NextRecord(RecordID curRid, RecordID& nextRid)
+{
+	if (curRid.slotNo < -1 || curRid.slotNo >= capacity)
+		return FAIL;
+
+	for (int i = curRid.slotNo + 1; i < capacity; i++)
+	{
+		// Skip over empty bytes of the bitmap eight records at a time.
+		if ((i % 8) == 0 && data[i/8] == 0)
+		{
+			i += 7;
+			continue;
+		}
+		if (IsUsed(i))
+		{
+			nextRid.pageNo = pid;
+			nextRid.slotNo = i;
+			return OK;
+		}
+	}
+	return DONE;
+}
+
+
+//------------------------------------------------------------------
+// FixedPage::GetRecord
+//
+// Input    : Record ID
+// Output   : Records length and a copy of the record itself
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status FixedPage::GetRecord(RecordID rid, char *recPtr, int& length)
+{
+	if (!IsValid(rid.slotNo))
+		return FAIL;
+
+	for (int a = 0; a < numOfAttr; a++)
+		memcpy(recPtr + a*AttrLen(), AttrPtr(rid.slotNo, a), AttrLen());
+	length = recLen;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// FixedPage::ReturnRecord
+//
+// Input    : Record ID
+// Output   : pointer to the record, record's length
+// Return   : OK if successful, FAIL otherwise.  Records of a page with
+//            several minipages are not contiguous and cannot be
+//            returned in place.
+//------------------------------------------------------------------
+
+Status FixedPage::ReturnRecord(RecordID rid, char*& recPtr, int& length)
+{
+	if (numOfAttr != 1 || !IsValid(rid.slotNo))
+		return FAIL;
+
+	recPtr = AttrPtr(rid.slotNo, 0);
+	length = recLen;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// FixedPage::UpdateRecord
+//
+// Input    : Record ID, the new value of the record and its length
+// Output   : None
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status FixedPage::UpdateRecord(RecordID rid, char *recPtr, int length)
+{
+	if (length != recLen || !IsValid(rid.slotNo))
+		return FAIL;
+
+	for (int a = 0; a < numOfAttr; a++)
+		memcpy(AttrPtr(rid.slotNo, a), recPtr + a*AttrLen(), AttrLen());
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// FixedPage::GetAttrs
+//
+// Input    : Record ID, the numbers of the attributes wanted
+// Output   : a copy of those attributes, one after the other, and
+//            their total length
+// Purpose  : Projection.  Only the minipages of the wanted attributes
+//            are touched.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status FixedPage::GetAttrs(RecordID rid, int numOfProj, const int *projAttrs, 
+						   char *recPtr, int& length)
+{
+	if (!IsValid(rid.slotNo))
+		return FAIL;
+
+	for (int p = 0; p < numOfProj; p++)
+	{
+		if (projAttrs[p] < 0 || projAttrs[p] >= numOfAttr)
+			return FAIL;
+		memcpy(recPtr + p*AttrLen(), AttrPtr(rid.slotNo, projAttrs[p]), AttrLen());
+	}
+	length = numOfProj * AttrLen();
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// FixedPage::ReturnAttr
+//
+// Input    : Record ID, attribute number
+// Output   : pointer to that attribute of the record, in its minipage
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status FixedPage::ReturnAttr(RecordID rid, int attr, char*& attrPtr)
+{
+	if (!IsValid(rid.slotNo) || attr < 0 || attr >= numOfAttr)
+		return FAIL;
+
+	attrPtr = AttrPtr(rid.slotNo, attr);
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// FixedPage::AvailableSpace
+//
+// Return   : The number of bytes that can still be inserted, which is
+//            always a multiple of the record length.
+//------------------------------------------------------------------
+
+int FixedPage::AvailableSpace(void)
+{
+	return (capacity - numOfRecords) * recLen;
+}
+
+
+bool FixedPage::IsEmpty(void)
+{
+	return (numOfRecords == 0);
+}
+
+
+int FixedPage::GetNumOfRecords()
+{
+	return numOfRecords;
+}
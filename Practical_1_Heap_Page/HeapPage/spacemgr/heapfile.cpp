@@ -2,6 +2,7 @@
 
 #include "../include/heapfile.h"
 #include "../include/heappage.h"
+#include "../include/fixedpage.h"
 #include "../include/dirpage.h"
 #include "../include/scan.h"
 #include "../include/bufmgr.h"
@@ -26,6 +27,51 @@ static int breakpoint()
 //-----------------------------------------------------------------------
 
 HeapFile::HeapFile( const char *name, Status& returnStatus )
+{
+	Open(name, 0, 0, returnStatus);
+}
+
+
+//-----------------------------------------------------------------------
+//  Constructor for a HeapFile of fixed-length records
+//
+//  Input   : name - name of a Heap File
+//            recLen - length of every record of the file
+//            numOfAttr - number of equally long attributes of a record.
+//                        If more than one, each attribute is stored in
+//                        its own minipage (PAX layout).
+//	Output  : status of initialization
+//  Purpose : As above, but a newly created file stores its records in
+//            FixedPages instead of slotted HeapPages.  An existing file
+//            keeps the layout it was created with.
+//-----------------------------------------------------------------------
+
+HeapFile::HeapFile( const char *name, Status& returnStatus, const int recLen, 
+				   const int numOfAttr )
+{
+	if (recLen <= 0 || recLen >= FIXEDPAGE_DATA_SIZE 
+		|| numOfAttr <= 0 || recLen % numOfAttr != 0)
+	{
+		cerr << "HeapFile::HeapFile - Invalid record length " << recLen 
+			<< " for " << numOfAttr << " attributes" << endl;
+		returnStatus = FAIL;
+		return;
+	}
+	Open(name, recLen, numOfAttr, returnStatus);
+}
+
+
+//-----------------------------------------------------------------------
+//  HeapFile::Open
+//
+//  Input   : name - name of a Heap File, NULL for a temporary file
+//            recLen - record length if a new file is to be created with
+//                     FixedPages, 0 for HeapPages
+//            attrs - number of minipages of the FixedPages
+//	Output  : status of initialization
+//-----------------------------------------------------------------------
+
+void HeapFile::Open( const char *name, int recLen, int attrs, Status& returnStatus )
 {
 	DirPage *page;
 	Status s;
@@ -83,6 +129,9 @@ HeapFile::HeapFile( const char *name, Status& returnStatus )
 			return;
 		}
 
+		fixedRecLen = page->GetRecLen();
+		numOfAttr = page->GetNumOfAttr();
+
 		PageID currPid;
 		PageID prevPid = dirPid;
 		while ((currPid = page->GetNextPage()) != INVALID_PAGE)
@@ -121,6 +170,9 @@ HeapFile::HeapFile( const char *name, Status& returnStatus )
 	// HeapFile.
 
 	page->Init (dirPid);
+	page->SetRecLen (recLen, attrs);
+	fixedRecLen = recLen;
+	numOfAttr = attrs;
 	
 	// Initilized the doubly link pointer of the directory page.
 	
@@ -182,6 +234,11 @@ Status HeapFile::DeleteFile()
 
 		while (info = nextPageInfo())
 		{
+			if (fixedRecLen == 0 && DeleteStubs(info->pid) != OK)
+			{
+				UNPIN(currDirPid, CLEAN);
+				return FAIL;
+			}
 			FREEPAGE(info->pid);
 		}
 
@@ -228,6 +285,33 @@ int HeapFile::GetNumOfRecords()
 }
 
 
+//-----------------------------------------------------------------------
+// HeapFile::GetNumOfPages
+// 
+// Return   : the number of data pages of the file, directory pages not
+//            included
+//-----------------------------------------------------------------------
+
+int HeapFile::GetNumOfPages()
+{
+	DirPageIterator nextDirPage(dirPid);
+	DirPage *dirPage;
+	PageID currDirPid;
+	int sum = 0;
+
+	while ((currDirPid = nextDirPage()) != INVALID_PAGE)
+	{
+		PIN(currDirPid, dirPage);
+		PageInfoIterator nextPageInfo(dirPage);
+		while (nextPageInfo() != NULL)
+			sum++;
+		UNPIN(currDirPid, CLEAN);
+	} 
+
+	return sum;
+}
+
+
 //-----------------------------------------------------------------------
 // HeapFile::InsertRecord
 //
@@ -254,6 +338,13 @@ Status HeapFile::InsertRecord(char *recPtr, int recLen, RecordID& outRid)
 		return FAIL;
 	}
 
+	if (fixedRecLen != 0 && recLen != fixedRecLen)
+	{
+		cerr << " Attempting to insert a record of length " << recLen 
+			<< " into a file of fixed length " << fixedRecLen << endl;
+		return FAIL;
+	}
+
 	DirPageIterator  nextDirPage(dirPid);
 	PageInfo *info;
 
@@ -265,7 +356,7 @@ Status HeapFile::InsertRecord(char *recPtr, int recLen, RecordID& outRid)
 		PageInfoIterator nextPageInfo(dirPage);
 		while (info = nextPageInfo())
 		{
-			if (info->spaceAvailable > (short)recLen) 
+			if (info->spaceAvailable >= (short)recLen) 
 				break;
 		}
 
@@ -296,6 +387,7 @@ Status HeapFile::InsertRecord(char *recPtr, int recLen, RecordID& outRid)
 	PIN(pid, page);
 	page->InsertRecord(recPtr, recLen, outRid);
 	dirPage->InsertRecordIntoPage(pid, page);
+	dirPage->AddToZones(pid, recPtr, recLen);
 	
 	UNPIN(pid, DIRTY);
 	UNPIN(currDirPid, DIRTY);
@@ -310,7 +402,8 @@ Status HeapFile::InsertRecord(char *recPtr, int recLen, RecordID& outRid)
 //
 // Input    : Record ID
 // Output   : A copy of the record, record's length
-// Purpose  : Reading record from the file
+// Purpose  : Reading record from the file, following the forwarding
+//            stub if the record has been moved
 // Condition: HeapFile exists
 // Return   : OK if record is found, DONE if record is not found 
 //          : and FAIL otherwise  
@@ -319,12 +412,73 @@ Status HeapFile::InsertRecord(char *recPtr, int recLen, RecordID& outRid)
 Status HeapFile::GetRecord (const RecordID& rid, char *recPtr, int& recLen)
 {
 	HeapPage *page;
+	RecordID newRid;
+	Status s;
 
 	PIN(rid.pageNo, page);
-	page->GetRecord(rid, recPtr, recLen);
+	if (!IsDataPage(page, rid.pageNo))
+	{
+		UNPIN(rid.pageNo, CLEAN);
+		return DONE;
+	}
+	if (page->GetForward(rid, newRid) == OK)
+	{
+		UNPIN(rid.pageNo, CLEAN);
+		return GetRecord(newRid, recPtr, recLen);
+	}
+	s = page->GetRecord(rid, recPtr, recLen);
 	UNPIN(rid.pageNo, CLEAN);
 
-	return OK;
+	return (s == OK) ? OK : DONE;
+}
+
+
+//-----------------------------------------------------------------------
+// HeapFile::IsDataPage
+//
+// Input    : a pinned page and the page ID it was pinned with
+// Return   : TRUE if the page says it is a data page of the layout of
+//            this file, or one of its stub pages, so that a record ID
+//            can be checked without walking the directory
+//-----------------------------------------------------------------------
+
+Bool HeapFile::IsDataPage (HeapPage *page, PageID pid)
+{
+	if (page->PageNo() != pid)
+		return FALSE;
+	if (fixedRecLen != 0)
+		return page->GetType() == FIXED_PAGE;
+	return page->GetType() == SLOTTED_PAGE || page->GetType() == STUB_PAGE;
+}
+
+
+//-----------------------------------------------------------------------
+// HeapFile::FindDirPage
+//
+// Input    : ID of a data page
+// Output   : currDirPid - ID of the directory page holding the PageInfo
+//            of that page
+// Return   : OK if it is found, DONE if the page is not part of the
+//            file, FAIL otherwise
+//-----------------------------------------------------------------------
+
+Status HeapFile::FindDirPage (PageID pid, PageID& currDirPid)
+{
+	DirPageIterator nextDirPage(dirPid);
+	DirPage *dirPage;
+	PageInfo *info;
+
+	while ((currDirPid = nextDirPage()) != INVALID_PAGE)
+	{
+		PIN(currDirPid, dirPage);
+		info = dirPage->FindPageInfo(pid);
+		UNPIN(currDirPid, CLEAN);
+
+		if (info != NULL)
+			return OK;
+	}
+
+	return DONE;
 }
 
 
@@ -334,7 +488,9 @@ Status HeapFile::GetRecord (const RecordID& rid, char *recPtr, int& recLen)
 // Input    : Record ID
 // Output   : None
 // Purpose  : Delete a record from the file, if it was the only
-//          : record on the page, remove the page as well
+//          : record on the page, remove the page as well.  A record
+//            that has been moved is deleted together with its
+//            forwarding stub, and a stub page with its last stub.
 // Condition: Heap File has to exist
 // PostCond : if the record exists it is deleted, if the page becomes 
 //            empty it is deleted as well
@@ -344,91 +500,271 @@ Status HeapFile::GetRecord (const RecordID& rid, char *recPtr, int& recLen)
 
 Status HeapFile::DeleteRecord (const RecordID& rid)
 {
-	DirPageIterator nextDirPage(dirPid);
-	DirPage *dirPage;
-	PageID currDirPid;
-	PageInfo *info;
+	HeapPage *page;
+	RecordID newRid;
+	Bool stubPage;
+	Status s;
 
-	while ((currDirPid = nextDirPage()) != INVALID_PAGE)
+	PIN(rid.pageNo, page);
+	if (!IsDataPage(page, rid.pageNo))
 	{
-		PIN(currDirPid, dirPage);
-		PageInfoIterator nextPageInfo(dirPage);
-		
-		while (info = nextPageInfo())
-		{
-			if (info->pid == rid.pageNo) 
-				break;
-		}
+		UNPIN(rid.pageNo, CLEAN);
+		return DONE;
+	}
+	s = page->GetForward(rid, newRid);
+	stubPage = (page->GetType() == STUB_PAGE);
+	UNPIN(rid.pageNo, CLEAN);
 
-		if (info != NULL)
+	if (s == OK && DeleteFromPage(newRid) != OK)
+		return FAIL;
+
+	return stubPage ? DeleteStub(rid) : DeleteFromPage(rid);
+}
+
+
+//-----------------------------------------------------------------------
+// HeapFile::DeleteStub
+//
+// Input    : Record ID of a forwarding stub
+// Purpose  : Delete the stub if it is on a stub page, which is not in
+//            the directory, and free the page once no stub is left on
+//            it.
+// Return   : OK if the stub is deleted, DONE if there is no such stub
+//            on a stub page, FAIL otherwise
+//-----------------------------------------------------------------------
+
+Status HeapFile::DeleteStub (const RecordID& rid)
+{
+	HeapPage *page;
+
+	PIN(rid.pageNo, page);
+	if (page->GetType() != STUB_PAGE || page->DeleteRecord(rid) != OK)
+	{
+		UNPIN(rid.pageNo, CLEAN);
+		return DONE;
+	}
+
+	if (page->IsEmpty())
+	{
+		FREEPAGE(rid.pageNo);
+		return OK;
+	}
+
+	UNPIN(rid.pageNo, DIRTY);
+	return OK;
+}
+
+
+//-----------------------------------------------------------------------
+// HeapFile::DeleteStubs
+//
+// Input    : ID of a data page
+// Purpose  : Delete the stubs that stub pages hold for the records
+//            moved to the data page, freeing the stub pages with their
+//            last stubs, before the file is deleted.
+//-----------------------------------------------------------------------
+
+Status HeapFile::DeleteStubs (PageID pid)
+{
+	HeapPage *page;
+	RecordID rid, homeRid;
+	Status s;
+
+	PIN(pid, page);
+	for (s = page->FirstRecord(rid); s == OK; s = page->NextRecord(rid, rid))
+	{
+		if (page->GetHome(rid, homeRid) == OK && DeleteStub(homeRid) == FAIL)
 		{
-			break;
+			UNPIN(pid, CLEAN);
+			return FAIL;
 		}
+	}
+	UNPIN(pid, CLEAN);
 
-		UNPIN(currDirPid, CLEAN);
-	} 
+	return (s == DONE) ? OK : FAIL;
+}
 
-	if (currDirPid == INVALID_PAGE)
+
+//-----------------------------------------------------------------------
+// HeapFile::DeleteFromPage
+//
+// Input    : Record ID of a record or of a forwarding stub
+// Purpose  : Delete it from its page, and update the page's PageInfo.
+//            Free the page if it becomes empty.
+// Return   : OK if the record is deleted, DONE if the record was not found,
+//            FAIL otherwise
+//-----------------------------------------------------------------------
+
+Status HeapFile::DeleteFromPage (const RecordID& rid)
+{
+	DirPage *dirPage;
+	PageID currDirPid;
+	HeapPage *page;
+	RecordID newRid;
+	Bool stub;
+	Status s;
+
+	if ((s = FindDirPage(rid.pageNo, currDirPid)) != OK)
+		return s;
+
+	PIN(currDirPid, dirPage);
+	PIN(rid.pageNo, page);
+
+	stub = (page->GetForward(rid, newRid) == OK);
+	if (page->DeleteRecord(rid) != OK)
 	{
+		UNPIN(rid.pageNo, CLEAN);
+		UNPIN(currDirPid, CLEAN);
 		return DONE;
 	}
+
+	// Then update the PageInfo. ARRGGGH ! must update
+	// this everytime we change a page.  Stubs are not counted as
+	// records.
+
+	if (stub)
+		dirPage->UpdatePage(rid.pageNo, page);
 	else
+		dirPage->DeleteRecordFromPage(rid.pageNo, page);
+
+	if (page->IsEmpty())
+	{
+		FREEPAGE(rid.pageNo);
+		return RemovePage(rid.pageNo, currDirPid, dirPage);
+	}
+
+	if (dirPage->GetNumOfZones() > 0 && ComputeZones(dirPage, rid.pageNo, page) != OK)
 	{
-		// Delete the record.
-		// First from the data page.
-		HeapPage *page;
+		UNPIN(rid.pageNo, DIRTY);
+		UNPIN(currDirPid, DIRTY);
+		return FAIL;
+	}
+
+	UNPIN(rid.pageNo, DIRTY);
+	UNPIN(currDirPid, DIRTY);
+	return OK;
+}
 
-		PIN(info->pid, page);
-		page->DeleteRecord(rid);
 
-		// Then update the PageInfo. ARRGGGH ! must update
-		// this everytime we change a page.
+//-----------------------------------------------------------------------
+// HeapFile::ComputeZones
+//
+// Input    : a directory page and the pinned data page of one of its
+//            entries
+// Purpose  : Recompute the zones of the data page from the records
+//            stored on it, those moved there included.
+//-----------------------------------------------------------------------
+
+Status HeapFile::ComputeZones (DirPage *dirPage, PageID pid, HeapPage *page)
+{
+	char recPtr[MAX_SPACE];
+	RecordID rid;
+	int recLen;
+	Status s;
+
+	dirPage->ClearZones(pid);
+	for (s = page->FirstRecord(rid); s == OK; s = page->NextRecord(rid, rid))
+	{
+		if (page->GetRecord(rid, recPtr, recLen) != OK)
+			return FAIL;
+
+		dirPage->AddToZones(pid, recPtr, recLen);
+	}
+
+	return (s == DONE) ? OK : FAIL;
+}
 
-		dirPage->DeleteRecordFromPage(info->pid, page);
 
-		if (page->IsEmpty())
+//-----------------------------------------------------------------------
+// HeapFile::SetZoneMap
+//
+// Input    : numOfZones - number of int attributes to summarize, at most
+//                         DIR_MAX_ZONES
+//            offsets - their byte offsets in the records
+// Purpose  : Keep the minimum and maximum of these attributes for every
+//            data page, so that scans with predicates on them can skip
+//            pages.  The file must not have any record yet.
+// Return   : OK if operation is successful, FAIL otherwise
+//-----------------------------------------------------------------------
+
+Status HeapFile::SetZoneMap (int numOfZones, const int *offsets)
+{
+	DirPageIterator nextDirPage(dirPid);
+	DirPage *dirPage;
+	PageID currDirPid;
+
+	if (numOfZones < 0 || numOfZones > DIR_MAX_ZONES)
+	{
+		cerr << "HeapFile::SetZoneMap - At most " << DIR_MAX_ZONES << " zones" << endl;
+		return FAIL;
+	}
+	for (int z = 0; z < numOfZones; z++)
+	{
+		if (offsets[z] < 0 
+			|| (fixedRecLen != 0 && offsets[z] + (int)sizeof(int) > fixedRecLen))
 		{
-			// If HeapPage is now empty, we have to deallocate it.
-			
-			FREEPAGE(info->pid);
-			dirPage->DeletePage(info->pid);
-			if (dirPage->IsEmpty())
-			{
-				// If DirPage is empty, we have to deallocate it
-				// too, unless it's the one and only dirPage around.
-
-				if (dirPage->Deletable())
-				{
-					// First unattach itself from the link list.
-
-					dirPage->DeleteItSelf();
-					if (dirPage->IsHead())
-					{
-						// If this dirPage is the first page, we have
-						// to change dirPid.  Since it's deletable, the
-						// next pid must be valid.
-
-						dirPid = dirPage->GetNextPage();
-					}
-					FREEPAGE(currDirPid);
-				}
-				else
-				{
-					UNPIN(currDirPid, DIRTY);
-				}
-			}
-			else
-			{
-				UNPIN(currDirPid, DIRTY);
-			}
+			cerr << "HeapFile::SetZoneMap - Invalid offset " << offsets[z] << endl;
+			return FAIL;
+		}
+	}
+
+	while ((currDirPid = nextDirPage()) != INVALID_PAGE)
+	{
+		PIN(currDirPid, dirPage);
+		if (!dirPage->IsEmpty())
+		{
+			UNPIN(currDirPid, CLEAN);
+			cerr << "HeapFile::SetZoneMap - The file is not empty" << endl;
+			return FAIL;
 		}
-		else
+		dirPage->SetZoneMap(numOfZones, offsets);
+		UNPIN(currDirPid, DIRTY);
+	}
+
+	return OK;
+}
+
+
+//-----------------------------------------------------------------------
+// HeapFile::RemovePage
+//
+// Input    : ID of a data page that has been freed or made a stub page,
+//            ID of the directory page that holds its PageInfo and that
+//            directory page, pinned
+// Purpose  : Remove the PageInfo of the data page, and deallocate the
+//            directory page if nothing is left in it.  The directory
+//            page is unpinned.
+//-----------------------------------------------------------------------
+
+Status HeapFile::RemovePage (PageID pid, PageID currDirPid, DirPage *dirPage)
+{
+	dirPage->DeletePage(pid);
+	if (dirPage->IsEmpty())
+	{
+		// If DirPage is empty, we have to deallocate it
+		// too, unless it's the one and only dirPage around.
+
+		if (dirPage->Deletable())
 		{
-			UNPIN(info->pid, DIRTY);
-			UNPIN(currDirPid, DIRTY);
+			// First unattach itself from the link list.
+
+			dirPage->DeleteItSelf();
+			if (dirPage->IsHead())
+			{
+				// If this dirPage is the first page, we have
+				// to change dirPid.  Since it's deletable, the
+				// next pid must be valid.
+
+				dirPid = dirPage->GetNextPage();
+			}
+			if (currDirPid == lastDirPid)
+				lastDirPid = dirPage->GetPrevPage();
+			FREEPAGE(currDirPid);
+			return OK;
 		}
 	}
 
+	UNPIN(currDirPid, DIRTY);
 	return OK;
 }
 
@@ -438,7 +774,8 @@ Status HeapFile::DeleteRecord (const RecordID& rid)
 // 
 // Input    : Record ID, pointer to a record and its length 
 // Output   : none
-// Purpose  : Find a record and update it
+// Purpose  : Find a record and update it, following the forwarding
+//            stub if the record has been moved
 // PostCond : The record is updated and the heap file is updated
 // Return   : OK if the record is updated, DONE if it was not found, 
 //            FAIL otherwise
@@ -446,56 +783,312 @@ Status HeapFile::DeleteRecord (const RecordID& rid)
 
 Status HeapFile::UpdateRecord (const RecordID& rid, char *recPtr, int recLen)
 { 
+	HeapPage *page, *movedPage;
+	RecordID newRid;
+	char *oldPtr;
+	int  oldLen;
+
+	PIN(rid.pageNo, page);
+	if (!IsDataPage(page, rid.pageNo))
+	{
+		UNPIN(rid.pageNo, CLEAN);
+		return DONE;
+	}
+	if (fixedRecLen != 0)
+	{
+		// The record may be spread over several minipages.
+
+		if (((FixedPage *)page)->UpdateRecord(rid, recPtr, recLen) != OK)
+		{
+			UNPIN(rid.pageNo, CLEAN);
+			cerr << " Unable to update records of different length." << endl;
+			return FAIL;
+		}
+		UNPIN(rid.pageNo, DIRTY);
+		return WidenZones(rid.pageNo, recPtr, recLen);
+	}
+
+	if (page->GetForward(rid, newRid) == OK)
+	{
+		// Update the record where it was moved to.  Its zones are
+		// those of that page, where scans find it.
+
+		UNPIN(rid.pageNo, CLEAN);
+		PIN(newRid.pageNo, movedPage);
+		page = movedPage;
+	}
+	else
+		newRid = rid;
+
+	if (page->ReturnRecord(newRid, oldPtr, oldLen) != OK)
+	{
+		UNPIN(newRid.pageNo, CLEAN);
+		return DONE;
+	}
+
+	if (oldLen != recLen)
+	{
+		UNPIN(newRid.pageNo, CLEAN);
+		cerr << " Unable to update records of different length." << endl;
+		return FAIL;
+	}
+
+	memcpy(oldPtr, recPtr, oldLen);	
+	UNPIN(newRid.pageNo, DIRTY);
+          
+	return WidenZones(newRid.pageNo, recPtr, recLen);
+}
+
+
+//-----------------------------------------------------------------------
+// HeapFile::WidenZones
+//
+// Input    : a data page and the new value of one of its records
+// Purpose  : Make sure the zones of the page still cover the record
+//            after an update.  Zones are only ever widened here; they
+//            are narrowed again when a record of the page is deleted.
+// Return   : OK if operation is successful, FAIL otherwise
+//-----------------------------------------------------------------------
+
+Status HeapFile::WidenZones (PageID pid, char *recPtr, int recLen)
+{
+	DirPage *dirPage;
+	PageID currDirPid;
+	int numOfZones;
+
+	// Every directory page has the zones of the first one, so a file
+	// without zones is told from it without walking the directory.
+
+	PIN(dirPid, dirPage);
+	numOfZones = dirPage->GetNumOfZones();
+	UNPIN(dirPid, CLEAN);
+	if (numOfZones == 0)
+		return OK;
+
+	if (FindDirPage(pid, currDirPid) != OK)
+		return FAIL;
+
+	PIN(currDirPid, dirPage);
+	dirPage->AddToZones(pid, recPtr, recLen);
+	UNPIN(currDirPid, DIRTY);
+	return OK;
+}
+
+
+//-----------------------------------------------------------------------
+// HeapFile::Vacuum
+//
+// Purpose  : Empty the sparsely filled data pages.  Every record of a
+//            page less than a quarter full is moved to the fullest page
+//            with room for it (and fuller than its own page).  A record
+//            at home leaves a forwarding stub in its slot, and the stub
+//            of a record moved before is pointed to its new place, so
+//            RecordIDs stay valid.  A page left empty is freed.  A page
+//            left with stubs only becomes a STUB_PAGE: it leaves the
+//            directory, so scans and inserts no longer visit it, and is
+//            freed with its last stub.  Reading a moved record by its
+//            RecordID takes one pin more.
+//            FixedPages are never fragmented and their records cannot
+//            be forwarded, so files of fixed-length records are left
+//            as they are.
+// Return   : OK if operation is successful, FAIL otherwise
+//-----------------------------------------------------------------------
+
+Status HeapFile::Vacuum ()
+{
 	DirPageIterator nextDirPage(dirPid);
 	DirPage *dirPage;
 	PageID currDirPid;
 	PageInfo *info;
+	PageID *sparse;
+	int numOfPages = 0, numOfSparse = 0;
+
+	if (fixedRecLen != 0)
+		return OK;
 
 	while ((currDirPid = nextDirPage()) != INVALID_PAGE)
 	{
 		PIN(currDirPid, dirPage);
 		PageInfoIterator nextPageInfo(dirPage);
-		while (info = nextPageInfo())
+		while ((info = nextPageInfo()))
+			numOfPages++;
+		UNPIN(currDirPid, CLEAN);
+	}
+
+	// Note the sparse pages first, as moving records changes the
+	// directory.
+
+	sparse = new PageID[numOfPages];
+	DirPageIterator nextSparseDirPage(dirPid);
+	while ((currDirPid = nextSparseDirPage()) != INVALID_PAGE)
+	{
+		PIN(currDirPid, dirPage);
+		PageInfoIterator nextPageInfo(dirPage);
+		while ((info = nextPageInfo()))
 		{
-			if (info->pid == rid.pageNo) 
-			{
-				UNPIN(currDirPid, CLEAN);
-				break;
-			}
+			if (info->spaceAvailable > 3 * HEAPPAGE_DATA_SIZE / 4)
+				sparse[numOfSparse++] = info->pid;
 		}
-
-		if (info != NULL)
-			break;
 		UNPIN(currDirPid, CLEAN);
-	} 
+	}
 
-	if (currDirPid == INVALID_PAGE)
+	for (int i = 0; i < numOfSparse; i++)
 	{
-		return DONE;
+		if (VacuumPage(sparse[i]) != OK)
+		{
+			delete [] sparse;
+			return FAIL;
+		}
 	}
-	else
+
+	delete [] sparse;
+	return OK;
+}
+
+
+//-----------------------------------------------------------------------
+// HeapFile::VacuumPage
+//
+// Input    : ID of a sparsely filled data page
+// Purpose  : Move the records of the page to fuller pages, as far as
+//            they have room.  Free the page if it becomes empty, or
+//            make it a stub page if only forwarding stubs are left.
+//-----------------------------------------------------------------------
+
+Status HeapFile::VacuumPage (PageID pid)
+{
+	DirPage *dirPage, *targetDirPage;
+	PageID currDirPid, targetDirPid, targetPid;
+	HeapPage *page, *targetPage, *homePage;
+	RecordID rid, homeRid, newRid;
+	char *recPtr;
+	int recLen;
+	Bool atHome;
+	Status s;
+
+	if ((s = FindDirPage(pid, currDirPid)) != OK)
+		return (s == DONE) ? OK : s;
+
+	PIN(currDirPid, dirPage);
+	PIN(pid, page);
+
+	rid.pageNo = pid;
+	for (rid.slotNo = 0; rid.slotNo < page->GetNumOfSlots(); rid.slotNo++)
 	{
-		HeapPage *page;
-		char *oldPtr;
-		int  oldLen;
+		if (page->ReturnRecord(rid, recPtr, recLen) != OK)
+			continue;   // empty slot or forwarding stub
 
-		PIN(info->pid, page);
-		page->ReturnRecord(rid, oldPtr, oldLen);
-		
-		if (oldLen != recLen)
+		atHome = (page->GetHome(rid, homeRid) != OK);
+		if (atHome)
+			homeRid = rid;
+
+		if (FindTarget(pid, page->AvailableSpace(), recLen + sizeof(RecordID), 
+			targetPid, targetDirPid) != OK)
+			continue;
+
+		PIN(targetDirPid, targetDirPage);
+		PIN(targetPid, targetPage);
+		if (targetPage->InsertMovedRecord(recPtr, recLen, homeRid, newRid) != OK)
 		{
-			cerr << " Unable to update records of different length." << endl;
-			return FAIL;
+			UNPIN(targetPid, CLEAN);
+			UNPIN(targetDirPid, CLEAN);
+			continue;
 		}
+		targetDirPage->InsertRecordIntoPage(targetPid, targetPage);
+		targetDirPage->AddToZones(targetPid, recPtr, recLen);
+
+		// A record at home becomes its own stub.  A record shorter
+		// than a RecordID may not leave room for it.
 
-		memcpy(oldPtr, recPtr, oldLen);	
-		UNPIN(info->pid, DIRTY);
+		if (atHome && page->Forward(rid, newRid) != OK)
+		{
+			targetPage->DeleteRecord(newRid);
+			targetDirPage->DeleteRecordFromPage(targetPid, targetPage);
+			UNPIN(targetPid, DIRTY);
+			UNPIN(targetDirPid, DIRTY);
+			continue;
+		}
+		UNPIN(targetPid, DIRTY);
+		UNPIN(targetDirPid, DIRTY);
+
+		if (!atHome)
+		{
+			PIN(homeRid.pageNo, homePage);
+			homePage->Forward(homeRid, newRid);
+			UNPIN(homeRid.pageNo, DIRTY);
+			page->DeleteRecord(rid);
+		}
+		dirPage->DeleteRecordFromPage(pid, page);
 	}
-          
+
+	if (page->IsEmpty())
+	{
+		FREEPAGE(pid);
+		return RemovePage(pid, currDirPid, dirPage);
+	}
+
+	if (page->GetNumOfRecords() == 0)
+	{
+		page->SetType(STUB_PAGE);
+		UNPIN(pid, DIRTY);
+		return RemovePage(pid, currDirPid, dirPage);
+	}
+
+	if (dirPage->GetNumOfZones() > 0 && ComputeZones(dirPage, pid, page) != OK)
+	{
+		UNPIN(pid, DIRTY);
+		UNPIN(currDirPid, DIRTY);
+		return FAIL;
+	}
+
+	UNPIN(pid, DIRTY);
+	UNPIN(currDirPid, DIRTY);
 	return OK;
 }
 
 
+//-----------------------------------------------------------------------
+// HeapFile::FindTarget
+//
+// Input    : ID of a page being vacuumed and its free space, space needed
+//            for a record moved from it
+// Output   : ID of the fullest other page that still has that space
+//            but less free space than the page being vacuumed, and of
+//            the directory page holding its PageInfo
+// Return   : OK if there is such a page, DONE otherwise
+//-----------------------------------------------------------------------
+
+Status HeapFile::FindTarget (PageID pid, int space, int needed, PageID& targetPid,
+							 PageID& targetDirPid)
+{
+	DirPageIterator nextDirPage(dirPid);
+	DirPage *dirPage;
+	PageID currDirPid;
+	PageInfo *info;
+	int best = space;
+
+	targetPid = INVALID_PAGE;
+	while ((currDirPid = nextDirPage()) != INVALID_PAGE)
+	{
+		PIN(currDirPid, dirPage);
+		PageInfoIterator nextPageInfo(dirPage);
+		while ((info = nextPageInfo()))
+		{
+			if (info->pid != pid && info->spaceAvailable >= needed 
+				&& info->spaceAvailable < best)
+			{
+				best = info->spaceAvailable;
+				targetPid = info->pid;
+				targetDirPid = currDirPid;
+			}
+		}
+		UNPIN(currDirPid, CLEAN);
+	}
+
+	return (targetPid == INVALID_PAGE) ? DONE : OK;
+}
+
+
 //-----------------------------------------------------------------------
 // HeapFile::OpenScan
 // 
@@ -518,6 +1111,95 @@ Scan *HeapFile::OpenScan(Status& status)
 }
 
 
+//-----------------------------------------------------------------------
+// HeapFile::OpenScan
+// 
+// Input    : numOfProj - number of attributes wanted
+//            projAttrs - their attribute numbers
+// Purpose  : Initiate a sequential scan that returns only the given
+//            attributes of each record, in the given order.  The file
+//            must have been created with FixedPages.
+//-----------------------------------------------------------------------
+
+Scan *HeapFile::OpenScan(Status& status, int numOfProj, const int *projAttrs)
+{
+	Scan *newScan;
+
+	if (fixedRecLen == 0)
+	{
+		cerr << "HeapFile::OpenScan - Projection needs a fixed-length file" << endl;
+		status = FAIL;
+		return NULL;
+	}
+	for (int p = 0; p < numOfProj; p++)
+	{
+		if (projAttrs[p] < 0 || projAttrs[p] >= numOfAttr)
+		{
+			cerr << "HeapFile::OpenScan - No attribute " << projAttrs[p] << endl;
+			status = FAIL;
+			return NULL;
+		}
+	}
+	
+	newScan = new Scan(this, status, numOfProj, projAttrs);
+	
+	if (status == OK)
+	    return newScan;
+	else 
+	{
+	    delete newScan;
+	    return NULL;
+	}
+}
+
+
+//-----------------------------------------------------------------------
+// HeapFile::OpenScan
+// 
+// Input    : numOfPreds - number of conditions
+//            preds - the conditions, each on an int at a byte offset of
+//                    the record
+// Purpose  : Initiate a sequential scan that returns only the records
+//            satisfying all the conditions.  In a file with several
+//            minipages, an int may not straddle two attributes.
+//-----------------------------------------------------------------------
+
+Scan *HeapFile::OpenScan(Status& status, int numOfPreds, const ScanPredicate *preds)
+{
+	Scan *newScan;
+
+	for (int p = 0; p < numOfPreds; p++)
+	{
+		int offset = preds[p].offset;
+		Bool invalid = (offset < 0);
+
+		if (fixedRecLen != 0)
+		{
+			int attrLen = fixedRecLen / numOfAttr;
+
+			invalid = invalid || offset + (int)sizeof(int) > fixedRecLen
+				|| offset % attrLen + (int)sizeof(int) > attrLen;
+		}
+		if (invalid)
+		{
+			cerr << "HeapFile::OpenScan - Invalid offset " << preds[p].offset << endl;
+			status = FAIL;
+			return NULL;
+		}
+	}
+	
+	newScan = new Scan(this, status, numOfPreds, preds);
+	
+	if (status == OK)
+	    return newScan;
+	else 
+	{
+	    delete newScan;
+	    return NULL;
+	}
+}
+
+
 PageID HeapFile::NextPage(PageID pid)
 {
 	HeapPage *page;
@@ -554,6 +1236,7 @@ Status HeapFile::NewPage(PageID &pid, PageID &currDirPid)
 
 		NEWPAGE (currDirPid, dirPage);
 		dirPage->Init(currDirPid);
+		dirPage->SetRecLen(fixedRecLen, numOfAttr);
 		dirPage->SetNextPage(INVALID_PAGE);
 		dirPage->SetPrevPage(lastDirPid);
 
@@ -561,6 +1244,7 @@ Status HeapFile::NewPage(PageID &pid, PageID &currDirPid)
 		
 		PIN(lastDirPid, lastPage);
 		lastPage->SetNextPage(currDirPid);
+		dirPage->SetZoneMap(lastPage->GetNumOfZones(), lastPage->GetZoneOffsets());
 		UNPIN(lastDirPid, DIRTY);
 
 		lastDirPid = currDirPid;
@@ -568,7 +1252,10 @@ Status HeapFile::NewPage(PageID &pid, PageID &currDirPid)
 	
 	NEWPAGE (pid, newDataPage);
 	
-	newDataPage->Init(pid);
+	if (fixedRecLen != 0)
+		((FixedPage *)newDataPage)->Init(pid, fixedRecLen, numOfAttr);
+	else
+		newDataPage->Init(pid);
 
 	// Create a new page
 	dirPage->InsertPage(pid, newDataPage);
@@ -3,6 +3,7 @@
 #include <memory.h>
 
 #include "../include/heappage.h"
+#include "../include/fixedpage.h"
 #include "../include/heapfile.h"
 #include "../include/bufmgr.h"
 #include "../include/db.h"
@@ -14,15 +15,20 @@ using namespace std;
 //
 // Input     : Page ID
 // Output    : None
+// Purpose   : Make an empty page.  Slot 0 lies before the data area,
+//             so it is counted as free space as well.
 //------------------------------------------------------------------
 
 void HeapPage::Init(PageID pageNo)
 {
-    this->prevPage = INVALID_PAGE;
-    this->nextPage = INVALID_PAGE;
-    this->pid = pageNo; // page number
-    fillPtr = sizeof(Slot); //data area offset
-    freeSpace = HEAPPAGE_DATA_SIZE - sizeof(Slot); //minus preserved slot space
+	prevPage = INVALID_PAGE;
+	nextPage = INVALID_PAGE;
+	pid = pageNo;
+	type = SLOTTED_PAGE;
+
+	numOfSlots = 0;
+	fillPtr = HEAPPAGE_DATA_SIZE;
+	freeSpace = HEAPPAGE_DATA_SIZE + sizeof(Slot);
 }
 
 void HeapPage::SetNextPage(PageID pageNo)
@@ -47,37 +53,129 @@ PageID HeapPage::GetPrevPage()
 }
 
 
+//------------------------------------------------------------------
+// HeapPage::SlotDirEnd
+//
+// Input     : a number of slots
+// Return    : the offset in the data area where a slot directory of
+//             that many slots ends.  Slot 0 is not in the data area.
+//------------------------------------------------------------------
+
+int HeapPage::SlotDirEnd(int slots)
+{
+	return (slots > 1) ? (slots - 1) * sizeof(Slot) : 0;
+}
+
+
+//------------------------------------------------------------------
+// HeapPage::SlotBytes
+//
+// Input     : number of a used slot
+// Return    : the number of bytes of the data area the slot points to
+//------------------------------------------------------------------
+
+int HeapPage::SlotBytes(int slotNo)
+{
+	if (SLOT_IS_FORWARD(slots[slotNo]))
+		return sizeof(RecordID);
+	return slots[slotNo].length & ~MOVED_RECORD;
+}
+
+
+Bool HeapPage::IsValidSlot(int slotNo)
+{
+	return (slotNo >= 0 && slotNo < numOfSlots && !SLOT_IS_EMPTY(slots[slotNo]));
+}
+
+
+//------------------------------------------------------------------
+// HeapPage::Allocate
+//
+// Input     : number of bytes wanted, size of the slot directory once
+//             they are allocated
+// Purpose   : Take the bytes from the free space in front of the
+//             records.  If deleted records have left that too small,
+//             the page is compacted first.  There must be enough free
+//             space in total.
+// Return    : offset of the bytes in the data area
+//------------------------------------------------------------------
+
+int HeapPage::Allocate(int length, int slots)
+{
+	if (fillPtr - length < SlotDirEnd(slots))
+		Compact();
+
+	fillPtr -= length;
+	freeSpace -= length + (slots - numOfSlots) * sizeof(Slot);
+	numOfSlots = slots;
+
+	return fillPtr;
+}
+
+
 //------------------------------------------------------------------
 // HeapPage::InsertRecord
 //
 // Input     : Pointer to the record and the record's length 
 // Output    : Record ID of the record inserted.
-// Purpose   : Insert a record into the page
+// Purpose   : Insert a record into the page, reusing the first empty
+//             slot if there is one.
 // Return    : OK if everything went OK, DONE if sufficient space 
 //             does not exist
 //------------------------------------------------------------------
 
 Status HeapPage::InsertRecord(char *recPtr, int length, RecordID& rid)
 {
-    //not sufficient space
-    if (length > this->AvailableSpace())
-        return DONE;
-    //sufficient space
-    this->freeSpace -= length;
-    for (int i = 0;  i< length; i++)
-        this->data[fillPtr+i] = recPtr[i];
-    
-    int slotNum = (sizeof(slots)/sizeof(Slot)) + 1;
-    this->slots[slotNum].offset = fillPtr;
-    this->slots[slotNum].length = length;
-    
-    this->fillPtr += length;
-    
-    rid.pageNo = this->pid;
-    rid.slotNo = slotNum;
-    
-    numOfSlots++;
-    return OK;
+	int slotNo;
+	int offset;
+
+	if (type == FIXED_PAGE)
+		return ((FixedPage *)this)->InsertRecord(recPtr, length, rid);
+
+	if (length > AvailableSpace())
+		return DONE;
+
+	slotNo = 0;
+	while (slotNo < numOfSlots && !SLOT_IS_EMPTY(slots[slotNo]))
+		slotNo++;
+
+	offset = Allocate(length, (slotNo == numOfSlots) ? numOfSlots + 1 : numOfSlots);
+	memcpy(&data[offset], recPtr, length);
+	SLOT_FILL(slots[slotNo], offset, length);
+
+	rid.pageNo = pid;
+	rid.slotNo = slotNo;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// HeapPage::InsertMovedRecord
+//
+// Input     : Pointer to the record and the record's length, ID of the
+//             forwarding stub that will point to it
+// Output    : Record ID of the record inserted.
+// Purpose   : Insert a record moved here from another page.
+// Return    : OK if everything went OK, DONE if sufficient space 
+//             does not exist
+//------------------------------------------------------------------
+
+Status HeapPage::InsertMovedRecord(char *recPtr, int length, RecordID homeRid,
+								   RecordID& rid)
+{
+	char buf[MAX_SPACE];
+	Status s;
+
+	if (type == FIXED_PAGE || length + (int)sizeof(RecordID) > HEAPPAGE_DATA_SIZE)
+		return FAIL;
+
+	memcpy(buf, &homeRid, sizeof(RecordID));
+	memcpy(buf + sizeof(RecordID), recPtr, length);
+
+	s = InsertRecord(buf, length + sizeof(RecordID), rid);
+	if (s == OK)
+		slots[rid.slotNo].length |= MOVED_RECORD;
+	return s;
 }
 
 
@@ -86,20 +184,106 @@ Status HeapPage::InsertRecord(char *recPtr, int length, RecordID& rid)
 //
 // Input    : Record ID
 // Output   : None
-// Purpose  : Delete a record from the page
+// Purpose  : Delete a record from the page.  Its bytes are only
+//            counted as free; they are reclaimed when the page is
+//            next compacted.
 // Return   : OK if successful, FAIL otherwise  
 //------------------------------------------------------------------ 
 
 Status HeapPage::DeleteRecord(const RecordID& rid)
 {
-    int slotSize = (sizeof(slots)/sizeof(Slot));
-    if (rid.slotNo > slotSize || rid.slotNo < 0) //invalid slot
-        return FAIL;
-    if (this->slots[rid.slotNo].offset == -1) //empty slot
-        return FAIL;
-    this->slots[rid.slotNo].offset = -1;
-    numOfSlots--;
-    return OK;
+	int bytes;
+
+	if (type == FIXED_PAGE)
+		return ((FixedPage *)this)->DeleteRecord(rid);
+
+	if (!IsValidSlot(rid.slotNo))
+		return FAIL;
+
+	bytes = SlotBytes(rid.slotNo);
+	freeSpace += bytes;
+	if (slots[rid.slotNo].offset == fillPtr)
+		fillPtr += bytes;
+	SLOT_SET_EMPTY(slots[rid.slotNo]);
+
+	CompactSlotDir();
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// HeapPage::Forward
+//
+// Input    : ID of a record, or of a forwarding stub, of this page and
+//            the ID of the record's new place
+// Purpose  : Replace the record with a forwarding stub, or point an
+//            existing stub to newRid.
+// Return   : OK if successful, DONE if there is no space for the stub,
+//            FAIL otherwise
+//------------------------------------------------------------------
+
+Status HeapPage::Forward(RecordID rid, RecordID newRid)
+{
+	int offset;
+
+	if (type == FIXED_PAGE || !IsValidSlot(rid.slotNo) 
+		|| SLOT_IS_MOVED(slots[rid.slotNo]))
+		return FAIL;
+
+	if (!SLOT_IS_FORWARD(slots[rid.slotNo]))
+	{
+		if (freeSpace + SlotBytes(rid.slotNo) < (int)sizeof(RecordID))
+			return DONE;
+
+		freeSpace += SlotBytes(rid.slotNo);
+		if (slots[rid.slotNo].offset == fillPtr)
+			fillPtr += SlotBytes(rid.slotNo);
+		SLOT_SET_EMPTY(slots[rid.slotNo]);
+
+		offset = Allocate(sizeof(RecordID), numOfSlots);
+		SLOT_FILL(slots[rid.slotNo], offset, FORWARD_SLOT);
+	}
+
+	memcpy(&data[slots[rid.slotNo].offset], &newRid, sizeof(RecordID));
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// HeapPage::GetForward
+//
+// Input    : Record ID
+// Output   : the ID the record has been moved to
+// Return   : OK if rid is a forwarding stub, FAIL otherwise
+//------------------------------------------------------------------
+
+Status HeapPage::GetForward(RecordID rid, RecordID& newRid)
+{
+	if (type == FIXED_PAGE || !IsValidSlot(rid.slotNo) 
+		|| !SLOT_IS_FORWARD(slots[rid.slotNo]))
+		return FAIL;
+
+	memcpy(&newRid, &data[slots[rid.slotNo].offset], sizeof(RecordID));
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// HeapPage::GetHome
+//
+// Input    : Record ID
+// Output   : the ID of the forwarding stub of the record
+// Return   : OK if the record was moved here, FAIL otherwise
+//------------------------------------------------------------------
+
+Status HeapPage::GetHome(RecordID rid, RecordID& homeRid)
+{
+	if (type == FIXED_PAGE || !IsValidSlot(rid.slotNo) 
+		|| !SLOT_IS_MOVED(slots[rid.slotNo]))
+		return FAIL;
+
+	memcpy(&homeRid, &data[slots[rid.slotNo].offset], sizeof(RecordID));
+	return OK;
 }
 
 
@@ -114,14 +298,14 @@ Status HeapPage::DeleteRecord(const RecordID& rid)
 
 Status HeapPage::FirstRecord(RecordID& rid)
 {
-    int slotSize = (sizeof(slots)/sizeof(Slot));
-    for (int i = 0 ; i <= slotSize ; i++)
-        if (this->slots[i].offset != -1){
-            rid.pageNo = this->pid;
-            rid.slotNo = i;
-            return OK;
-        }
-    return DONE;
+	RecordID before;
+
+	if (type == FIXED_PAGE)
+		return ((FixedPage *)this)->FirstRecord(rid);
+
+	before.pageNo = pid;
+	before.slotNo = -1;
+	return NextRecord(before, rid);
 }
 
 
@@ -130,23 +314,30 @@ Status HeapPage::FirstRecord(RecordID& rid)
 //
 // Input    : ID of the current record
 // Output   : ID of the next record
+// Purpose  : Forwarding stubs are skipped; the records they point to
+//            are found on the pages they were moved to.
 // Return   : Return DONE if no more records exist on the page; 
 //            otherwise OK
 //------------------------------------------------------------------
 
 Status HeapPage::NextRecord (RecordID curRid, RecordID& nextRid)
 {
-    int curSlot = curRid.slotNo;
-    int slotSize = (sizeof(slots)/sizeof(Slot));
-    if (curSlot > slotSize || curSlot < 0)
-        return FAIL;
-    for (int i = curSlot + 1 ; i <= slotSize ; i++)
-        if (this->slots[i].offset != -1){
-            nextRid.pageNo = this->pid;
-            nextRid.slotNo = i;
-            return OK;
-        }
-    return DONE;
+	if (type == FIXED_PAGE)
+		return ((FixedPage *)this)->NextRecord(curRid, nextRid);
+
+	if (curRid.slotNo < -1 || curRid.slotNo >= numOfSlots)
+		return FAIL;
+
+	for (int i = curRid.slotNo + 1; i < numOfSlots; i++)
+	{
+		if (!SLOT_IS_EMPTY(slots[i]) && !SLOT_IS_FORWARD(slots[i]))
+		{
+			nextRid.pageNo = pid;
+			nextRid.slotNo = i;
+			return OK;
+		}
+	}
+	return DONE;
 }
 
 
@@ -156,23 +347,22 @@ Status HeapPage::NextRecord (RecordID curRid, RecordID& nextRid)
 // Input    : Record ID
 // Output   : Records length and a copy of the record itself
 // Purpose  : To retrieve a _copy_ of a record with ID rid from a page
-// Return   : OK if successful, FAIL otherwise
+// Return   : OK if successful, FAIL otherwise (also for a forwarding
+//            stub)
 //------------------------------------------------------------------
 
 Status HeapPage::GetRecord(RecordID rid, char *recPtr, int& length)
 {
-    int slotSize = (sizeof(slots)/sizeof(Slot));
-    if (rid.slotNo > slotSize || rid.slotNo < 0)
-        return FAIL;
-    int index = slots[rid.slotNo].offset;
-    if (index == -1)
-        return FAIL;
-    int len = slots[rid.slotNo].length;
-    for (int i = 0; i < len; i++){
-        recPtr[i] = data[index+i];
-    }
-    length = len;
-    return OK;
+	char *ptr;
+
+	if (type == FIXED_PAGE)
+		return ((FixedPage *)this)->GetRecord(rid, recPtr, length);
+
+	if (ReturnRecord(rid, ptr, length) != OK)
+		return FAIL;
+
+	memcpy(recPtr, ptr, length);
+	return OK;
 }
 
 
@@ -182,22 +372,26 @@ Status HeapPage::GetRecord(RecordID rid, char *recPtr, int& length)
 // Input    : Record ID
 // Output   : pointer to the record, record's length
 // Purpose  : To output a _pointer_ to the record
-// Return   : OK if successful, FAIL otherwise
+// Return   : OK if successful, FAIL otherwise (also for a forwarding
+//            stub)
 //------------------------------------------------------------------
 
 Status HeapPage::ReturnRecord(RecordID rid, char*& recPtr, int& length)
 {
-    int slotSize = (sizeof(slots)/sizeof(Slot));
-    if (rid.slotNo > slotSize || rid.slotNo < 0)
-        return FAIL;
-    int index = slots[rid.slotNo].offset;
-    if (index == -1)
-        return FAIL;
-    int len = slots[rid.slotNo].length;
-    
-    length = len;
-    recPtr = &data[index];
-    return OK;
+	if (type == FIXED_PAGE)
+		return ((FixedPage *)this)->ReturnRecord(rid, recPtr, length);
+
+	if (!IsValidSlot(rid.slotNo) || SLOT_IS_FORWARD(slots[rid.slotNo]))
+		return FAIL;
+
+	recPtr = &data[slots[rid.slotNo].offset];
+	length = SlotBytes(rid.slotNo);
+	if (SLOT_IS_MOVED(slots[rid.slotNo]))
+	{
+		recPtr += sizeof(RecordID);
+		length -= sizeof(RecordID);
+	}
+	return OK;
 }
 
 
@@ -207,13 +401,22 @@ Status HeapPage::ReturnRecord(RecordID rid, char*& recPtr, int& length)
 // Input    : None
 // Output   : None
 // Purpose  : To return the amount of available space
-// Return   : The amount of available space on the heap file page.
+// Return   : The amount of available space on the heap file page,
+//            i.e. the longest record that can still be inserted,
+//            compacting the page if need be.
 //------------------------------------------------------------------
 
 int HeapPage::AvailableSpace(void)
 {
-    return freeSpace - sizeof(Slot);
-
+	if (type == FIXED_PAGE)
+		return ((FixedPage *)this)->AvailableSpace();
+
+	for (int i = 0; i < numOfSlots; i++)
+	{
+		if (SLOT_IS_EMPTY(slots[i]))
+			return freeSpace;
+	}
+	return (freeSpace > (int)sizeof(Slot)) ? freeSpace - sizeof(Slot) : 0;
 }
 
 
@@ -224,29 +427,86 @@ int HeapPage::AvailableSpace(void)
 // Output   : None
 // Purpose  : Check if there is any record in the page.
 // Return   : true if the HeapPage is empty, and false otherwise.
+//            Forwarding stubs keep a page from being empty.
 //------------------------------------------------------------------
 
 bool HeapPage::IsEmpty(void)
 {
-    if (this->numOfSlots == 0)
-        return TRUE;
-    else return FALSE;
+	if (type == FIXED_PAGE)
+		return ((FixedPage *)this)->IsEmpty();
+
+	return (numOfSlots == 0);
 }
 
 
+//------------------------------------------------------------------
+// HeapPage::CompactSlotDir
+//
+// Purpose  : Give the empty slots at the end of the slot directory
+//            back to the free space.  Other empty slots are kept, as
+//            the records after them must keep their IDs.
+//------------------------------------------------------------------
+
 void HeapPage::CompactSlotDir()
 {
-  // Complete this method to get the S+ mark.
-  // This method is not required for an S mark.
+	while (numOfSlots > 0 && SLOT_IS_EMPTY(slots[numOfSlots - 1]))
+	{
+		numOfSlots--;
+		freeSpace += sizeof(Slot);
+	}
+	if (numOfSlots == 0)
+		fillPtr = HEAPPAGE_DATA_SIZE;
+}
+
+
+//------------------------------------------------------------------
+// HeapPage::Compact
+//
+// Purpose  : Move all the records to the end of the data area, so
+//            that the holes left by deleted records become one block
+//            of free space.  Record IDs do not change.
+//------------------------------------------------------------------
+
+void HeapPage::Compact()
+{
+	char buf[HEAPPAGE_DATA_SIZE];
+	int ptr = HEAPPAGE_DATA_SIZE;
+
+	if (type == FIXED_PAGE)
+		return;
+
+	for (int i = 0; i < numOfSlots; i++)
+	{
+		if (!SLOT_IS_EMPTY(slots[i]))
+		{
+			ptr -= SlotBytes(i);
+			memcpy(&buf[ptr], &data[slots[i].offset], SlotBytes(i));
+			slots[i].offset = ptr;
+		}
+	}
+	memcpy(&data[ptr], &buf[ptr], HEAPPAGE_DATA_SIZE - ptr);
+	fillPtr = ptr;
 }
 
+
+//------------------------------------------------------------------
+// HeapPage::GetNumOfRecords
+//
+// Return   : the number of records stored in the page, including the
+//            ones moved here and not counting forwarding stubs.
+//------------------------------------------------------------------
+
 int HeapPage::GetNumOfRecords()
 {
-    int slotSize = (sizeof(slots)/sizeof(Slot));
-    int cnt = 0;
-    for (int i =0 ; i <= slotSize; i++)
-        if (slots[i].offset != -1)
-            cnt++;
-    
-    return cnt;
+	int count = 0;
+
+	if (type == FIXED_PAGE)
+		return ((FixedPage *)this)->GetNumOfRecords();
+
+	for (int i = 0; i < numOfSlots; i++)
+	{
+		if (!SLOT_IS_EMPTY(slots[i]) && !SLOT_IS_FORWARD(slots[i]))
+			count++;
+	}
+	return count;
 }
@@ -12,6 +12,7 @@
 #include "../include/db.h"
 #include "../include/heapfile.h"
 #include "../include/scan.h"
+#include "../include/colfile.h"
 #include "../include/heaptest.h"
 #include "../include/bufmgr.h"
 
@@ -524,5 +525,1168 @@ int HeapDriver::Test5()
 
 int HeapDriver::Test6()
 {
-    return TRUE;
+    cout << "\n  Test 6: Fixed-length and PAX record pages\n";
+    Status status = OK;
+    Scan* scan = 0;
+    RecordID rid;
+	
+    cout << "  - Create a heap file of fixed-length records\n";
+    HeapFile f("file_6", status, reclen);
+	
+    if (status != OK)
+        cerr << "*** Could not create heap file\n";
+	
+    if ( status == OK )
+	{
+        cout << "  - Add " << choice << " records to the file\n";
+        for (int i =0; i<choice && status == OK; i++)
+		{
+            Rec rec = { i, i*2.5 };
+            sprintf(rec.name, "record %i",i);
+			
+            status = f.InsertRecord((char *)&rec, reclen, rid);
+            if (status != OK)
+                cerr << "*** Error inserting record " << i << endl;
+		}
+		
+        if ( status == OK && f.GetNumOfRecords() != choice )
+		{
+            status = FAIL;
+            cerr << "*** File reports " << f.GetNumOfRecords() << " records, not "
+				<< choice << endl;
+		}
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Try to insert a record of a different length\n";
+        char record[2*reclen] = "";
+        status = f.InsertRecord( record, reclen+1, rid );
+        TestFailure( status, HEAPFILE, "Inserting a record of the wrong length" );
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Delete the odd-numbered records\n";
+        scan = f.OpenScan(status);
+        if (status != OK)
+            cerr << "*** Error opening scan\n";
+	}
+    if ( status == OK )
+	{
+        int len, i = 0;
+        Rec rec;
+		
+        while ( (status = scan->GetNext(rid, (char *)&rec, len)) == OK )
+		{
+            if ( i & 1 )
+			{
+                status = f.DeleteRecord( rid );
+                if ( status != OK )
+				{
+                    cerr << "*** Error deleting record " << i << endl;
+                    break;
+				}
+			}
+            ++i;
+		}
+		
+        if ( status == DONE )
+            status = OK;
+	}
+	
+    delete scan;
+    scan = 0;
+	
+    if ( status == OK )
+	{
+        cout << "  - Scan the remaining records in insertion order\n";
+        scan = f.OpenScan(status);
+        if (status != OK)
+            cerr << "*** Error opening scan\n";
+	}
+    if ( status == OK )
+	{
+        int len, i = 0;
+        Rec rec;
+		
+        while ( (status = scan->GetNext(rid, (char *)&rec, len)) == OK )
+		{
+            char name[ sizeof rec.name ];
+            sprintf( name, "record %i", i );
+            if ( len != reclen || rec.ival != i || 0 != strcmp( rec.name, name ) )
+			{
+                cerr << "*** Record " << i << " differs from what we inserted\n";
+                status = FAIL;
+                break;
+			}
+            i += 2;
+		}
+		
+        if ( status == DONE )
+		{
+            if ( i == choice )
+                status = OK;
+            else
+                cerr << "*** Scanned " << i/2 << " records instead of "
+				<< choice/2 << endl;
+		}
+	}
+	
+    delete scan;
+	
+    if ( status == OK
+		&& MINIBASE_BM->GetNumOfUnpinnedBuffers() != MINIBASE_BM->GetNumOfBuffers() )
+	{
+        cerr << "*** The fixed-length file has left pages pinned\n";
+        status = FAIL;
+	}
+	
+    if ( status == OK )
+        status = f.DeleteFile();
+	
+    struct IntRec { int a, b, c, d; };
+	
+    if ( status == OK )
+	{
+        cout << "  - Create a heap file with one minipage per attribute\n";
+        HeapFile g("file_6_pax", status, sizeof(IntRec), 4);
+		
+        for (int i =0; i<choice && status == OK; i++)
+		{
+            IntRec rec = { i, 2*i, 3*i, 4*i };
+            status = g.InsertRecord((char *)&rec, sizeof(IntRec), rid);
+            if (status != OK)
+                cerr << "*** Error inserting record " << i << endl;
+		}
+		
+        if ( status == OK )
+		{
+            cout << "  - Scan attributes 3 and 1 only\n";
+            int proj[2] = { 3, 1 };
+            scan = g.OpenScan(status, 2, proj);
+            if (status != OK)
+                cerr << "*** Error opening scan\n";
+		}
+        if ( status == OK )
+		{
+            int len, i = 0;
+            int attrs[2];
+			
+            while ( (status = scan->GetNext(rid, (char *)attrs, len)) == OK )
+			{
+                if ( len != 2*sizeof(int) || attrs[0] != 4*i || attrs[1] != 2*i )
+				{
+                    cerr << "*** Attributes of record " << i << " differ from what we inserted\n";
+                    status = FAIL;
+                    break;
+				}
+                ++i;
+			}
+			
+            if ( status == DONE )
+			{
+                if ( i == choice )
+                    status = OK;
+                else
+                    cerr << "*** Scanned " << i << " records instead of "
+					<< choice << endl;
+			}
+		}
+		
+        delete scan;
+        scan = 0;
+		
+        if ( status == OK )
+            status = g.DeleteFile();
+	}
+	
+    if ( status == OK )
+        cout << "  Test 6 completed successfully.\n";
+    return (status == OK);
+}
+
+
+//********************************************************
+
+// Fill a variable-length record of Test7: its number, then bytes
+// derived from it.
+static int FillRec7( char *record, int i )
+{
+    int len = sizeof(int) + 8 + (i*37) % 90;
+
+    memcpy( record, &i, sizeof i );
+    for ( int k = sizeof i; k < len; k++ )
+        record[k] = (char)(i + k);
+    return len;
+}
+
+int HeapDriver::Test7()
+{
+    cout << "\n  Test 7: Compaction and vacuuming of variable-length records\n";
+    Status status = OK;
+    Scan* scan = 0;
+    const int numRecs = 10 * choice;
+    RecordID *rids = new RecordID[numRecs];
+    int *alive = new int[numRecs];
+    char record[MINIBASE_PAGESIZE], found[MINIBASE_PAGESIZE];
+    int len, foundLen, numOfPages = 0;
+	
+    cout << "  - Create a heap file\n";
+    HeapFile f("file_7", status);
+	
+    if (status != OK)
+        cerr << "*** Could not create heap file\n";
+	
+    if ( status == OK )
+	{
+        cout << "  - Add " << numRecs << " variable-sized records\n";
+        for (int i = 0; i < numRecs && status == OK; i++)
+		{
+            len = FillRec7( record, i );
+            status = f.InsertRecord( record, len, rids[i] );
+            alive[i] = TRUE;
+            if (status != OK)
+                cerr << "*** Error inserting record " << i << endl;
+		}
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Delete most records of the first half, a few of the rest\n";
+        for (int i = 0; i < numRecs && status == OK; i++)
+		{
+            if ( (i < numRecs/2) ? (i % 10 != 0) : (i % 4 == 0) )
+			{
+                status = f.DeleteRecord( rids[i] );
+                alive[i] = FALSE;
+                if (status != OK)
+                    cerr << "*** Error deleting record " << i << endl;
+			}
+		}
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Insert the deleted records of the second half again\n";
+        for (int i = numRecs/2; i < numRecs && status == OK; i += 4)
+		{
+            len = FillRec7( record, i );
+            status = f.InsertRecord( record, len, rids[i] );
+            alive[i] = TRUE;
+            if (status != OK)
+                cerr << "*** Error inserting record " << i << endl;
+		}
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Vacuum the file\n";
+        numOfPages = f.GetNumOfPages();
+        status = f.Vacuum();
+        if (status != OK)
+            cerr << "*** Error vacuuming the file\n";
+        else if ( MINIBASE_BM->GetNumOfUnpinnedBuffers() != MINIBASE_BM->GetNumOfBuffers() )
+		{
+            cerr << "*** Vacuuming left a page pinned\n";
+            status = FAIL;
+		}
+        else if ( f.GetNumOfPages() >= numOfPages )
+		{
+            cerr << "*** The file still has " << f.GetNumOfPages() << " of its "
+				<< numOfPages << " pages, with live records on sparse pages\n";
+            status = FAIL;
+		}
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Read the records of the sparse pages, moved ones through their stubs\n";
+        long pins, misses;
+        int moved = 0;
+        for (int i = 0; i < numRecs/2 && status == OK; i++)
+		{
+            if ( !alive[i] )
+                continue;
+            MINIBASE_BM->ResetStat();
+            status = f.GetRecord( rids[i], found, foundLen );
+            MINIBASE_BM->GetStat( pins, misses );
+            len = FillRec7( record, i );
+            if ( status != OK || foundLen != len || memcmp( record, found, len ) )
+			{
+                cerr << "*** Record " << i << " differs from what we inserted\n";
+                status = FAIL;
+			}
+            else if ( pins > 2 )
+			{
+                cerr << "*** Reading record " << i << " took " << pins << " pins\n";
+                status = FAIL;
+			}
+            moved += (pins == 2);
+		}
+        if ( status == OK && moved == 0 )
+		{
+            cerr << "*** No record was moved off its sparse page\n";
+            status = FAIL;
+		}
+        numOfPages = f.GetNumOfPages();
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Delete the second half and vacuum again\n";
+        for (int i = numRecs/2; i < numRecs && status == OK; i++)
+		{
+            if ( alive[i] )
+			{
+                status = f.DeleteRecord( rids[i] );
+                alive[i] = FALSE;
+			}
+		}
+        if ( status == OK )
+            status = f.Vacuum();
+        if (status != OK)
+            cerr << "*** Error deleting records or vacuuming the file\n";
+        else if ( f.GetNumOfPages() >= numOfPages )
+		{
+            cerr << "*** The file still has " << f.GetNumOfPages() << " of its "
+				<< numOfPages << " pages\n";
+            status = FAIL;
+		}
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Check the records by their old record IDs\n";
+        int count = 0;
+        for (int i = 0; i < numRecs && status == OK; i++)
+		{
+            if ( !alive[i] )
+                continue;
+            count++;
+            len = FillRec7( record, i );
+            status = f.GetRecord( rids[i], found, foundLen );
+            if ( status != OK || foundLen != len || memcmp( record, found, len ) )
+			{
+                cerr << "*** Record " << i << " differs from what we inserted\n";
+                status = FAIL;
+			}
+		}
+        if ( status == OK && f.GetNumOfRecords() != count )
+		{
+            cerr << "*** File reports " << f.GetNumOfRecords() << " records, not "
+				<< count << endl;
+            status = FAIL;
+		}
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Update a record through its old record ID\n";
+        int i = numRecs/2 - 10;
+        len = FillRec7( record, i );
+        record[len-1] = 'x';
+        status = f.UpdateRecord( rids[i], record, len );
+        if ( status == OK )
+            status = f.GetRecord( rids[i], found, foundLen );
+        if ( status != OK || found[len-1] != 'x' )
+		{
+            cerr << "*** Record " << i << " was not updated\n";
+            status = FAIL;
+		}
+        record[len-1] = (char)(i + len - 1);
+        if ( status == OK )
+            status = f.UpdateRecord( rids[i], record, len );
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Scan the records, each must be seen once\n";
+        scan = f.OpenScan(status);
+        if (status != OK)
+            cerr << "*** Error opening scan\n";
+	}
+    if ( status == OK )
+	{
+        RecordID rid;
+        int i, count = 0;
+		
+        while ( (status = scan->GetNext(rid, found, foundLen)) == OK )
+		{
+            memcpy( &i, found, sizeof i );
+            len = FillRec7( record, i );
+            if ( i < 0 || i >= numRecs || !alive[i] || rids[i] != rid
+                 || foundLen != len || memcmp( record, found, len ) )
+			{
+                cerr << "*** Scanned record " << i << " is wrong\n";
+                status = FAIL;
+                break;
+			}
+            alive[i] = 2;
+            count++;
+		}
+		
+        if ( status == DONE )
+		{
+            status = OK;
+            for (i = 0; i < numRecs; i++)
+			{
+                if ( alive[i] == TRUE )
+				{
+                    cerr << "*** Scan missed record " << i << endl;
+                    status = FAIL;
+                    break;
+				}
+			}
+		}
+	}
+	
+    delete scan;
+	
+    if ( status == OK )
+	{
+        cout << "  - Delete all the records through their old record IDs\n";
+        for (int i = 0; i < numRecs && status == OK; i++)
+		{
+            if ( alive[i] )
+                status = f.DeleteRecord( rids[i] );
+            if (status != OK)
+                cerr << "*** Error deleting record " << i << endl;
+		}
+        if ( status == OK && f.GetNumOfRecords() != 0 )
+		{
+            cerr << "*** File reports " << f.GetNumOfRecords() << " records, not 0\n";
+            status = FAIL;
+		}
+	}
+	
+    if ( status == OK
+		&& MINIBASE_BM->GetNumOfUnpinnedBuffers() != MINIBASE_BM->GetNumOfBuffers() )
+	{
+        cerr << "*** The file has left pages pinned\n";
+        status = FAIL;
+	}
+	
+    if ( status == OK )
+        status = f.DeleteFile();
+	
+    delete [] rids;
+    delete [] alive;
+	
+    if ( status == OK )
+        cout << "  Test 7 completed successfully.\n";
+    return (status == OK);
+}
+
+
+//********************************************************
+
+int HeapDriver::Test8()
+{
+    cout << "\n  Test 8: Scans with predicates\n";
+    Status status = OK;
+    Scan* scan = 0;
+    RecordID rid;
+	
+    cout << "  - Create a heap file\n";
+    HeapFile f("file_8", status);
+	
+    if (status != OK)
+        cerr << "*** Could not create heap file\n";
+	
+    for (int i =0; i<choice && status == OK; i++)
+	{
+        Rec rec = { i, i*2.5 };
+        sprintf(rec.name, "record %i",i);
+		
+        status = f.InsertRecord((char *)&rec, reclen, rid);
+        if (status != OK)
+            cerr << "*** Error inserting record " << i << endl;
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Scan the records with 20 <= ival < 50\n";
+        ScanPredicate preds[2] = { { 0, aopGE, 20 }, { 0, aopLT, 50 } };
+        scan = f.OpenScan(status, 2, preds);
+        if (status != OK)
+            cerr << "*** Error opening scan\n";
+	}
+    if ( status == OK )
+	{
+        int len, i = 20;
+        Rec rec;
+		
+        while ( (status = scan->GetNext(rid, (char *)&rec, len)) == OK )
+		{
+            if ( len != reclen || rec.ival != i || rec.fval != i*2.5 )
+			{
+                cerr << "*** Record " << rec.ival << " should not have been returned\n";
+                status = FAIL;
+                break;
+			}
+            ++i;
+		}
+		
+        if ( status == DONE )
+		{
+            if ( i == 50 )
+                status = OK;
+            else
+                cerr << "*** Scanned " << i-20 << " records instead of 30\n";
+		}
+	}
+	
+    delete scan;
+    scan = 0;
+	
+    if ( status == OK )
+        status = f.DeleteFile();
+	
+    struct IntRec { int a, b, c, d; };
+	
+    if ( status == OK )
+	{
+        cout << "  - Create a heap file with one minipage per attribute\n";
+        HeapFile g("file_8_pax", status, sizeof(IntRec), 4);
+		
+        for (int i =0; i<choice && status == OK; i++)
+		{
+            IntRec rec = { i, 2*i, 3*i, 4*i };
+            status = g.InsertRecord((char *)&rec, sizeof(IntRec), rid);
+            if (status != OK)
+                cerr << "*** Error inserting record " << i << endl;
+		}
+		
+        if ( status == OK )
+		{
+            cout << "  - Try a predicate on an int straddling two attributes\n";
+            ScanPredicate bad = { 6, aopEQ, 0 };
+            scan = g.OpenScan(status, 1, &bad);
+            TestFailure( status, HEAPFILE, "Opening a scan with a misplaced predicate" );
+		}
+		
+        if ( status == OK )
+		{
+            cout << "  - Scan the records with c > 150 and d <= 300\n";
+            ScanPredicate preds[2] = { { 8, aopGT, 150 }, { 12, aopLE, 300 } };
+            scan = g.OpenScan(status, 2, preds);
+            if (status != OK)
+                cerr << "*** Error opening scan\n";
+		}
+        if ( status == OK )
+		{
+            int len, i = 51;
+            IntRec rec;
+			
+            while ( (status = scan->GetNext(rid, (char *)&rec, len)) == OK )
+			{
+                if ( rec.a != i || rec.d != 4*i )
+				{
+                    cerr << "*** Record " << rec.a << " should not have been returned\n";
+                    status = FAIL;
+                    break;
+				}
+                ++i;
+			}
+			
+            if ( status == DONE )
+			{
+                if ( i == 76 )
+                    status = OK;
+                else
+                    cerr << "*** Scanned " << i-51 << " records instead of 25\n";
+			}
+		}
+		
+        delete scan;
+        scan = 0;
+		
+        if ( status == OK )
+            status = g.DeleteFile();
+	}
+	
+    if ( status == OK
+		&& MINIBASE_BM->GetNumOfUnpinnedBuffers() != MINIBASE_BM->GetNumOfBuffers() )
+	{
+        cerr << "*** The scans have left pages pinned\n";
+        status = FAIL;
+	}
+	
+    if ( status == OK )
+        cout << "  Test 8 completed successfully.\n";
+    return (status == OK);
+}
+
+
+//********************************************************
+
+// Pins done by a scan until it returns DONE, and the number of
+// records it returned.
+
+static Status CountScan(Scan *scan, long& pins, int& count)
+{
+    Status status;
+    RecordID rid;
+    Rec rec;
+    long misses;
+    int len;
+	
+    count = 0;
+    while ( (status = scan->GetNext(rid, (char *)&rec, len)) == OK )
+        count++;
+    MINIBASE_BM->GetStat(pins, misses);
+    return (status == DONE) ? OK : status;
+}
+
+
+int HeapDriver::Test9()
+{
+    cout << "\n  Test 9: Zone maps\n";
+    Status status = OK;
+    Scan* scan = 0;
+    RecordID *rids = new RecordID[choice];
+    long fullPins = 0, pins = 0;
+    int count = 0;
+    int offset = 0;
+    ScanPredicate pred = { 0, aopGE, choice - 10 };
+	
+    cout << "  - Create a heap file with a zone map on ival\n";
+    HeapFile f("file_9", status);
+	
+    if (status != OK)
+        cerr << "*** Could not create heap file\n";
+    else if ((status = f.SetZoneMap(1, &offset)) != OK)
+        cerr << "*** Could not set the zone map\n";
+	
+    for (int i =0; i<choice && status == OK; i++)
+	{
+        Rec rec = { i, i*2.5 };
+        sprintf(rec.name, "record %i",i);
+		
+        status = f.InsertRecord((char *)&rec, reclen, rids[i]);
+        if (status != OK)
+            cerr << "*** Error inserting record " << i << endl;
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Try to set a zone map on a non-empty file\n";
+        status = f.SetZoneMap(1, &offset);
+        TestFailure( status, HEAPFILE, "Setting the zone map of a non-empty file" );
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Scan the whole file, then the records with ival >= " 
+             << choice - 10 << endl;
+        MINIBASE_BM->ResetStat();
+        scan = f.OpenScan(status);
+        if (status == OK)
+            status = CountScan(scan, fullPins, count);
+        delete scan;
+        scan = 0;
+		
+        if (status == OK)
+		{
+            MINIBASE_BM->ResetStat();
+            scan = f.OpenScan(status, 1, &pred);
+            if (status == OK)
+                status = CountScan(scan, pins, count);
+            delete scan;
+            scan = 0;
+		}
+		
+        if (status != OK)
+            cerr << "*** Error scanning the file\n";
+        else if (count != 10)
+		{
+            cerr << "*** Scanned " << count << " records instead of 10\n";
+            status = FAIL;
+		}
+        else if (pins >= fullPins)
+		{
+            cerr << "*** The scan pinned " << pins << " pages, a full scan " 
+                 << fullPins << "\n";
+            status = FAIL;
+		}
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Delete the records with ival >= " << choice - 10 
+             << " and move record 0 into their range\n";
+        Rec rec = { choice, 0.0, "record 0" };
+		
+        for (int i = choice - 10; i < choice && status == OK; i++)
+            status = f.DeleteRecord(rids[i]);
+        if (status == OK)
+            status = f.UpdateRecord(rids[0], (char *)&rec, reclen);
+        if (status == OK)
+		{
+            scan = f.OpenScan(status, 1, &pred);
+            if (status == OK)
+                status = CountScan(scan, pins, count);
+            delete scan;
+            scan = 0;
+		}
+		
+        if (status != OK)
+            cerr << "*** Error updating the file\n";
+        else if (count != 1)
+		{
+            cerr << "*** Scanned " << count << " records instead of 1\n";
+            status = FAIL;
+		}
+	}
+	
+    if ( status == OK )
+        status = f.DeleteFile();
+    delete [] rids;
+	
+    if ( status == OK
+		&& MINIBASE_BM->GetNumOfUnpinnedBuffers() != MINIBASE_BM->GetNumOfBuffers() )
+	{
+        cerr << "*** The scans have left pages pinned\n";
+        status = FAIL;
+	}
+	
+    if ( status == OK )
+        cout << "  Test 9 completed successfully.\n";
+    return (status == OK);
+}
+
+
+//********************************************************
+
+struct ColRec { int id, grade, flag, noise; };
+
+static const int colAttrs = sizeof(ColRec) / sizeof(int);
+
+// Fill record i of Test10: its position, one of a few values, a
+// constant, and a value that does not compress.
+static void FillRec10( ColRec& rec, int i )
+{
+    rec.id = i;
+    rec.grade = (i * 7) % 13;
+    rec.flag = 5;
+    rec.noise = (int)(i * 2654435761u);
+}
+
+// Scan the columns proj of f, checking every record against FillRec10,
+// and count the pins the scan makes.
+static Status CheckColumnScan( ColumnFile *f, int numOfProj, const int *proj,
+                               int numRecs, long& pins )
+{
+    Status status;
+    ColumnScan *scan;
+    ColRec rec;
+    int found[colAttrs];
+    int pos, len, i = 0;
+    long misses;
+
+    MINIBASE_BM->ResetStat();
+    scan = f->OpenScan(status, numOfProj, proj);
+    if (status != OK)
+	{
+        cerr << "*** Error opening scan\n";
+        return status;
+	}
+
+    while ( (status = scan->GetNext(pos, (char *)found, len)) == OK )
+	{
+        FillRec10( rec, i );
+        int bad = ( pos != i || len != numOfProj * (int)sizeof(int) );
+        for (int p = 0; p < numOfProj; p++)
+            bad |= ( found[p] != ((int *)&rec)[proj[p]] );
+        if ( bad )
+		{
+            cerr << "*** Record " << i << " differs from what we loaded\n";
+            status = FAIL;
+            break;
+		}
+        ++i;
+	}
+    delete scan;
+    MINIBASE_BM->GetStat(pins, misses);
+	
+    if ( status == DONE )
+	{
+        if ( i == numRecs )
+            status = OK;
+        else
+            cerr << "*** Scanned " << i << " records instead of " << numRecs << endl;
+	}
+    return status;
+}
+
+int HeapDriver::Test10()
+{
+    cout << "\n  Test 10: Column files\n";
+    Status status = OK;
+    const int numRecs = 10 * choice;
+    const int proj[colAttrs] = { 0, 1, 2, 3 };
+    long pins[colAttrs], allPins = 0, sumPins = 0;
+    ColumnFile *f = 0;
+    RecordID rid;
+    ColRec rec, found;
+    int len;
+	
+    cout << "  - Create a heap file of " << numRecs << " records\n";
+    HeapFile src("file_10_src", status);
+	
+    for (int i = 0; i < numRecs && status == OK; i++)
+	{
+        FillRec10( rec, i );
+        status = src.InsertRecord( (char *)&rec, sizeof rec, rid );
+        if (status != OK)
+            cerr << "*** Error inserting record " << i << endl;
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Bulk load a column file from it\n";
+        f = new ColumnFile("file_10", status, sizeof(ColRec), colAttrs);
+        if (status == OK)
+            status = f->BulkLoad( &src );
+        if (status != OK)
+            cerr << "*** Could not load the column file\n";
+        else if ( f->GetNumOfRecords() != numRecs )
+		{
+            cerr << "*** File reports " << f->GetNumOfRecords() << " records, not "
+				<< numRecs << endl;
+            status = FAIL;
+		}
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Scan each column alone\n";
+        for (int a = 0; a < colAttrs && status == OK; a++)
+		{
+            status = CheckColumnScan( f, 1, &proj[a], numRecs, pins[a] );
+            sumPins += pins[a];
+		}
+		
+        // A constant column fits in one data page, which with the header
+        // and its position index page makes three pins.
+        if ( status == OK && pins[2] != 3 )
+		{
+            cerr << "*** Scanning the constant column made " << pins[2] << " pins, not 3\n";
+            status = FAIL;
+		}
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Scan all the columns, putting the records back together\n";
+        status = CheckColumnScan( f, colAttrs, proj, numRecs, allPins );
+		
+        // Every scan pins the header page once, and otherwise only the
+        // pages of its own columns.
+        if ( status == OK && allPins != sumPins - (colAttrs - 1) )
+		{
+            cerr << "*** Scanning all the columns made " << allPins
+				<< " pins, the columns alone " << sumPins << endl;
+            status = FAIL;
+		}
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Get the records by position, last first\n";
+        for (int i = numRecs - 1; i >= 0 && status == OK; i -= 7)
+		{
+            FillRec10( rec, i );
+            status = f->GetRecord( i, (char *)&found, len );
+            if ( status != OK || len != sizeof rec || memcmp( &rec, &found, sizeof rec ) )
+			{
+                cerr << "*** Record " << i << " differs from what we loaded\n";
+                status = FAIL;
+			}
+		}
+	}
+	
+    if ( f != 0 )
+	{
+        if ( status == OK )
+            status = f->DeleteFile();
+        delete f;
+        f = 0;
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Try to bulk load a record of a different length\n";
+        HeapFile bad("file_10_bad", status);
+		
+        for (int i = 0; i < choice && status == OK; i++)
+		{
+            FillRec10( rec, i );
+            len = (i == choice - 1) ? sizeof rec - sizeof(int) : sizeof rec;
+            status = bad.InsertRecord( (char *)&rec, len, rid );
+		}
+		
+        // Two columns of two ints each are not compressed, so every
+        // value goes to its data page as soon as it is read, and the
+        // failed load has written pages that must be thrown away.
+        if ( status == OK )
+		{
+            f = new ColumnFile("file_10_bad_col", status, sizeof(ColRec), 2);
+            if ( status == OK )
+			{
+                status = f->BulkLoad( &bad );
+                TestFailure( status, HEAPFILE, "Bulk loading a record of the wrong length" );
+			}
+            if ( status == OK && f->GetNumOfRecords() != 0 )
+			{
+                cerr << "*** The failed load left " << f->GetNumOfRecords() << " records\n";
+                status = FAIL;
+			}
+			
+            if ( status == OK )
+			{
+                cout << "  - Load the same column file again, from the good records\n";
+                status = f->BulkLoad( &src );
+                if ( status != OK )
+                    cerr << "*** Could not load the column file again\n";
+                else if ( f->GetNumOfRecords() != numRecs )
+				{
+                    cerr << "*** File reports " << f->GetNumOfRecords() << " records, not "
+						<< numRecs << endl;
+                    status = FAIL;
+				}
+			}
+            for (int i = 0; i < numRecs && status == OK; i++)
+			{
+                FillRec10( rec, i );
+                status = f->GetRecord( i, (char *)&found, len );
+                if ( status != OK || len != sizeof rec || memcmp( &rec, &found, sizeof rec ) )
+				{
+                    cerr << "*** Record " << i << " differs from what we loaded\n";
+                    status = FAIL;
+				}
+			}
+			
+            if ( status == OK )
+                status = f->DeleteFile();
+            delete f;
+		}
+        if ( status == OK )
+            status = bad.DeleteFile();
+	}
+	
+    if ( status == OK )
+        status = src.DeleteFile();
+	
+    if ( status == OK
+		&& MINIBASE_BM->GetNumOfUnpinnedBuffers() != MINIBASE_BM->GetNumOfBuffers() )
+	{
+        cerr << "*** The column file has left pages pinned\n";
+        status = FAIL;
+	}
+	
+    if ( status == OK )
+        cout << "  Test 10 completed successfully.\n";
+    return (status == OK);
+}
+
+
+//********************************************************
+
+// The columns of Test11, and the encoding a full page of each must get.
+// A constant needs no bits at all in a frame of reference, and a few
+// values spread far apart are cheaper in a dictionary.
+static const int numCols11 = 6;
+static const char *colNames11[numCols11] =
+    { "age 20-39", "rating 0-4", "salary of 4 grades", "constant", "dept, sorted", "random" };
+static const int encodings11[numCols11] =
+    { ENC_FOR, ENC_FOR, ENC_DICT, ENC_FOR, ENC_RLE, ENC_PLAIN };
+
+static int Value11( int col, int i )
+{
+    static const int grades[4] = { 18000, 26500, 41000, 250000 };
+    unsigned h = i * 2654435761u;
+	
+    switch (col)
+	{
+    case 0 : return 20 + (h >> 8) % 20;
+    case 1 : return (h >> 8) % 5;
+    case 2 : return grades[(h >> 8) % 4];
+    case 3 : return 7;
+    case 4 : return i / 150;
+    default: return (int)h;
+	}
+}
+
+static const int numOps11 = 6;
+static const AttrOperator ops11[numOps11] = { aopEQ, aopLT, aopGT, aopNE, aopLE, aopGE };
+
+// "v op value", as ColumnPage::Select must evaluate it.
+static int Compare11( int v, AttrOperator op, int value )
+{
+    switch (op)
+	{
+    case aopEQ : return v == value;
+    case aopLT : return v < value;
+    case aopGT : return v > value;
+    case aopNE : return v != value;
+    case aopLE : return v <= value;
+    default    : return v >= value;
+	}
+}
+
+int HeapDriver::Test11()
+{
+    cout << "\n  Test 11: Compressed column pages\n";
+    Status status = OK;
+    int *values = new int[COLPAGE_MAX_VALUES];
+    int *decoded = new int[COLPAGE_MAX_VALUES];
+    char *match = new char[COLPAGE_MAX_VALUES];
+    ColumnPage *page = new ColumnPage;
+	
+    cout << "  - Encode a full page of each column, decode it and filter it\n";
+    for (int col = 0; col < numCols11 && status == OK; col++)
+	{
+        for (int i = 0; i < COLPAGE_MAX_VALUES; i++)
+            values[i] = Value11( col, i );
+		
+        int n = ColumnPage::Fit( values, COLPAGE_MAX_VALUES );
+        page->Encode( values, n );
+        if ( page->GetEncoding() != encodings11[col] || page->GetNumOfValues() != n )
+		{
+            cerr << "*** The " << colNames11[col] << " column got encoding "
+				<< page->GetEncoding() << ", not " << encodings11[col] << endl;
+            status = FAIL;
+            break;
+		}
+		
+        page->Decode( (char *)decoded );
+        if ( memcmp( values, decoded, n * sizeof(int) ) )
+		{
+            cerr << "*** The " << colNames11[col] << " column does not decode to its values\n";
+            status = FAIL;
+            break;
+		}
+		
+        int constants[5] = { values[0], values[n/2], values[n-1], 0, 30 };
+        for (int k = 0; k < 5 && status == OK; k++)
+		{
+            for (int o = 0; o < numOps11; o++)
+			{
+                int count = page->Select( ops11[o], constants[k], match );
+                int expected = 0;
+                int bad = 0;
+				
+                for (int i = 0; i < n; i++)
+				{
+                    int q = Compare11( decoded[i], ops11[o], constants[k] );
+                    expected += q;
+                    bad |= ( match[i] != q );
+				}
+                if ( bad || count != expected )
+				{
+                    cerr << "*** Filtering the " << colNames11[col] << " column on "
+						<< constants[k] << " differs from filtering its values\n";
+                    status = FAIL;
+                    break;
+				}
+			}
+		}
+	}
+	
+    struct Rec11 { int cols[numCols11]; };
+    const int numRecs = 10 * choice;
+    HeapFile *src = 0;
+    ColumnFile *f = 0;
+	
+    if ( status == OK )
+	{
+        cout << "  - Bulk load " << numRecs << " records of those columns\n";
+        src = new HeapFile("file_11_src", status);
+        for (int i = 0; i < numRecs && status == OK; i++)
+		{
+            Rec11 rec;
+            RecordID rid;
+            for (int col = 0; col < numCols11; col++)
+                rec.cols[col] = Value11( col, i );
+            status = src->InsertRecord( (char *)&rec, sizeof rec, rid );
+		}
+        if ( status == OK )
+            f = new ColumnFile("file_11", status, sizeof(Rec11), numCols11);
+        if ( status == OK )
+            status = f->BulkLoad( src );
+        if (status != OK)
+            cerr << "*** Could not load the column file\n";
+	}
+	
+    if ( status == OK )
+	{
+        cout << "  - Scan the records of each column >= its middle value\n";
+        for (int col = 0; col < numCols11 && status == OK; col++)
+		{
+            int value = Value11( col, numRecs/2 );
+            int proj[2] = { col, 4 };
+            ColumnScan *scan = f->OpenScan( status, 2, proj, col, aopGE, value );
+            int pos, len, attrs[2];
+            int i = 0;
+			
+            while ( status == OK && (status = scan->GetNext(pos, (char *)attrs, len)) == OK )
+			{
+                while ( i < pos && Value11( col, i ) < value )
+                    i++;
+                if ( i != pos || attrs[0] != Value11( col, i ) || attrs[1] != Value11( 4, i ) )
+				{
+                    cerr << "*** The scan of the " << colNames11[col] << " column returned record "
+						<< pos << " instead of " << i << endl;
+                    status = FAIL;
+                    break;
+				}
+                i++;
+			}
+            delete scan;
+			
+            if ( status == DONE )
+			{
+                status = OK;
+                while ( i < numRecs && Value11( col, i ) < value )
+                    i++;
+                if ( i != numRecs )
+				{
+                    cerr << "*** The scan of the " << colNames11[col] << " column missed record "
+						<< i << endl;
+                    status = FAIL;
+				}
+			}
+		}
+	}
+	
+    if ( f != 0 )
+	{
+        if ( status == OK )
+            status = f->DeleteFile();
+        delete f;
+	}
+    if ( src != 0 )
+	{
+        if ( status == OK )
+            status = src->DeleteFile();
+        delete src;
+	}
+	
+    delete page;
+    delete [] values;
+    delete [] decoded;
+    delete [] match;
+	
+    if ( status == OK
+		&& MINIBASE_BM->GetNumOfUnpinnedBuffers() != MINIBASE_BM->GetNumOfBuffers() )
+	{
+        cerr << "*** The column file has left pages pinned\n";
+        status = FAIL;
+	}
+	
+    if ( status == OK )
+        cout << "  Test 11 completed successfully.\n";
+    return (status == OK);
 }
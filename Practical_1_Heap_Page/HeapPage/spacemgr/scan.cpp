@@ -1,10 +1,12 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "../include/heapfile.h"
 #include "../include/scan.h"
 #include "../include/heappage.h"
+#include "../include/fixedpage.h"
 #include "../include/bufmgr.h"
 
 
@@ -15,33 +17,72 @@
 //------------------------------------------------------------------
 
 Scan::Scan (HeapFile *hf, Status& status)
+{
+	numOfProj = 0;
+	projAttrs = NULL;
+	numOfPreds = 0;
+	preds = NULL;
+	Init(hf, status);
+}
+
+//------------------------------------------------------------------
+// Constructor of a projecting Scan
+//
+// Input    : numOfProj, projAttrs - attributes GetNext has to return.
+//            The HeapFile must consist of FixedPages.
+//------------------------------------------------------------------
+
+Scan::Scan (HeapFile *hf, Status& status, int numOfProj, const int *projAttrs)
+{
+	this->numOfProj = numOfProj;
+	this->projAttrs = new int[numOfProj];
+	memcpy(this->projAttrs, projAttrs, numOfProj*sizeof(int));
+	numOfPreds = 0;
+	preds = NULL;
+	Init(hf, status);
+}
+
+//------------------------------------------------------------------
+// Constructor of a filtering Scan
+//
+// Input    : numOfPreds, preds - conditions a record must satisfy to
+//            be returned by GetNext.  They are evaluated on the pinned
+//            page, so records that fail them are never copied.
+//------------------------------------------------------------------
+
+Scan::Scan (HeapFile *hf, Status& status, int numOfPreds, const ScanPredicate *preds)
+{
+	numOfProj = 0;
+	projAttrs = NULL;
+	this->numOfPreds = numOfPreds;
+	this->preds = new ScanPredicate[numOfPreds];
+	memcpy(this->preds, preds, numOfPreds*sizeof(ScanPredicate));
+	Init(hf, status);
+}
+
+//------------------------------------------------------------------
+// Scan::Init
+//
+// Purpose  : Pin the first directory page and the first data page.
+//------------------------------------------------------------------
+
+void Scan::Init (HeapFile *hf, Status& status)
 {
 	currDirPid = hf->GetFirstDirPage();
 	firstDirPid = currDirPid;
 	currEntry = 0;
+	page = NULL;
 	
 	noMore = FALSE;
 	
-	MINIBASE_BM->PinPage(currDirPid, (Page *&)dirPage);
-	
-	PageInfo *info;
+	if (hf->fixedRecLen != 0 && hf->numOfAttr > 1)
+		attrLen = hf->fixedRecLen / hf->numOfAttr;
+	else
+		attrLen = 0;
 	
-	info = dirPage->GetPageInfo(currEntry);
-	currEntry++;
+	MINIBASE_BM->PinPage(currDirPid, (Page *&)dirPage);
 	
-	if (info == NULL)
-	{
-		noMore = TRUE;
-		status = OK;
-	}
-	else
-	{
-		currPid = info->pid;
-		MINIBASE_BM->PinPage(currPid, (Page *&)page);
-		status = page->FirstRecord(currRid);
-		if (status != OK)
-			return;
-	}
+	status = NextPage();
 }
 
 //------------------------------------------------------------------
@@ -58,6 +99,8 @@ Scan::~Scan()
 		MINIBASE_BM->UnpinPage(currPid, CLEAN);
 	if (dirPage)
 		MINIBASE_BM->UnpinPage(currDirPid, CLEAN);
+	delete [] projAttrs;
+	delete [] preds;
 }
 
 
@@ -66,7 +109,9 @@ Scan::~Scan()
 // 
 // Input    : recPtr: pointer to the copy of record, you must allocate
 //				space for this pointer before calling this function
-// Output   : a copy of the record, its length and its RecordID
+// Output   : a copy of the record, its length and its RecordID; a
+//            record moved by HeapFile::Vacuum is returned with the
+//            RecordID of its forwarding stub
 // Purpose  : to retrieve next record
 // Return   : OK if successful, DONE if no more records, FAIL if error 
 // Result	: If there are more records left, retrieve the record with
@@ -83,25 +128,154 @@ Status Scan::GetNext(RecordID& rid, char *recPtr, int& recLen)
 		return DONE;
 	}
 	
-	rid = currRid;
-	s = page->GetRecord(rid, recPtr, recLen);
+	while (numOfPreds > 0 && (s = Matches(currRid)) != OK)
+	{
+		if (s == FAIL || Advance() != OK)
+			return FAIL;
+		if (noMore)
+			return DONE;
+	}
+	
+	if (numOfProj > 0)
+		s = ((FixedPage *)page)->GetAttrs(currRid, numOfProj, projAttrs, recPtr, recLen);
+	else
+		s = page->GetRecord(currRid, recPtr, recLen);
 	if (s != OK)
 		return FAIL;
+	if (page->GetHome(currRid, rid) != OK)
+		rid = currRid;
 	
 	// Prepare for next GetNext call..
 	
+	return Advance();
+}
+
+
+//------------------------------------------------------------------
+// Scan::Advance
+// 
+// Purpose  : Move currRid to the next record of the file.
+// Return   : OK if successful (noMore is set at the end of the file),
+//            FAIL if error
+//------------------------------------------------------------------
+
+Status Scan::Advance()
+{
+	Status s;
+	
 	s = page->NextRecord(currRid, currRid);
 	if (s == DONE)
 	{
 		// No more record on page currPid
 		
-		PageInfo *info;
+		return NextPage();
+	}
+	
+	return s;
+}
+
+
+//------------------------------------------------------------------
+// Compare
+//
+// Return   : whether "v op value" holds
+//------------------------------------------------------------------
+
+static int Compare(int v, AttrOperator op, int value)
+{
+	switch (op)
+	{
+	case aopEQ : return v == value;
+	case aopLT : return v < value;
+	case aopGT : return v > value;
+	case aopNE : return v != value;
+	case aopLE : return v <= value;
+	case aopGE : return v >= value;
+	case aopNOP: return 1;
+	default    : return 0;
+	}
+}
+
+
+//------------------------------------------------------------------
+// Scan::Matches
+// 
+// Input    : ID of a record of the pinned page
+// Purpose  : Evaluate the predicates of the scan on the record, in
+//            place.  Records too short to hold an attribute do not
+//            match.
+// Return   : OK if the record satisfies all the predicates, DONE if it
+//            does not, FAIL if error
+//------------------------------------------------------------------
+
+Status Scan::Matches(RecordID rid)
+{
+	char *recPtr, *ptr;
+	int recLen, v;
+	Status s = OK;
+	
+	if (attrLen == 0 && page->ReturnRecord(rid, recPtr, recLen) != OK)
+		s = FAIL;
+	
+	for (int p = 0; p < numOfPreds && s == OK; p++)
+	{
+		if (attrLen != 0)
+		{
+			// The record is spread over the minipages.
+			
+			if (((FixedPage *)page)->ReturnAttr(rid, preds[p].offset / attrLen, ptr) != OK)
+			{
+				s = FAIL;
+				break;
+			}
+			ptr += preds[p].offset % attrLen;
+		}
+		else if (preds[p].offset + (int)sizeof(int) > recLen)
+		{
+			s = DONE;
+			break;
+		}
+		else
+			ptr = recPtr + preds[p].offset;
+		
+		memcpy(&v, ptr, sizeof(int));
+		if (!Compare(v, preds[p].op, preds[p].value))
+			s = DONE;
+	}
+	
+	return s;
+}
+
+
+//------------------------------------------------------------------
+// Scan::NextPage
+// 
+// Purpose  : Unpin the current data page and pin the next one that 
+//            has a record to return, skipping pages that only hold
+//            forwarding stubs.  currRid is set to the first record of
+//            that page.  Pages whose zones show that none of their
+//            records satisfies the predicates are skipped without being
+//            pinned.
+// Return   : OK if successful (noMore is set at the end of the file),
+//            FAIL if error
+//------------------------------------------------------------------
+
+Status Scan::NextPage()
+{
+	PageInfo *info;
+	Status s;
+	
+	do
+	{
+		if (page != NULL)
+		{
+			UNPIN(currPid, CLEAN);
+			page = NULL;
+		}
 		
-		UNPIN(currPid, CLEAN);
-		page = NULL;
 		info = dirPage->GetPageInfo(currEntry);
 		currEntry++;
-		if (info == NULL)
+		while (info == NULL)
 		{
 			// No more record on page currDirPid
 			
@@ -123,15 +297,64 @@ Status Scan::GetNext(RecordID& rid, char *recPtr, int& recLen)
 			info = dirPage->GetPageInfo(currEntry);
 			currEntry++;
 		}
+		if (numOfPreds > 0 && !MayMatch(info))
+		{
+			s = DONE;
+			continue;
+		}
 		currPid = info->pid;
 		PIN(currPid, page);
 		
 		s = page->FirstRecord(currRid);
-		if (s != OK)
-			return FAIL;
+	} while (s == DONE);
+	
+	return s;
+}
+
+
+//------------------------------------------------------------------
+// Scan::MayMatch
+// 
+// Input    : directory entry of a data page
+// Return   : FALSE if the zones of the page show that no record of it
+//            satisfies the predicates, TRUE otherwise.  Predicates on
+//            attributes outside the zone map are not checked.
+//------------------------------------------------------------------
+
+Bool Scan::MayMatch(PageInfo *info)
+{
+	const int *offsets = dirPage->GetZoneOffsets();
+	Zone *zones = dirPage->GetZones(info);
+	
+	for (int p = 0; p < numOfPreds; p++)
+	{
+		int c = preds[p].value;
+		
+		for (int z = 0; z < dirPage->GetNumOfZones(); z++)
+		{
+			if (offsets[z] != preds[p].offset)
+				continue;
+			
+			// An empty zone (min > max) fails every test.
+			
+			Zone& zone = zones[z];
+			if (zone.min > zone.max)
+				return FALSE;
+			
+			switch (preds[p].op)
+			{
+			case aopEQ : if (c < zone.min || c > zone.max) return FALSE; break;
+			case aopLT : if (zone.min >= c) return FALSE; break;
+			case aopGT : if (zone.max <= c) return FALSE; break;
+			case aopNE : if (zone.min == c && zone.max == c) return FALSE; break;
+			case aopLE : if (zone.min > c) return FALSE; break;
+			case aopGE : if (zone.max < c) return FALSE; break;
+			default    : break;
+			}
+		}
 	}
 	
-	return OK;
+	return TRUE;
 }
 
 // Scan:: MoveTO
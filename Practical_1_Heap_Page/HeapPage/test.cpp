@@ -67,6 +67,31 @@ bool TestDriver::Test6()
     return true;
 }
 
+bool TestDriver::Test7()
+{
+    return true;
+}
+
+bool TestDriver::Test8()
+{
+    return true;
+}
+
+bool TestDriver::Test9()
+{
+    return true;
+}
+
+bool TestDriver::Test10()
+{
+    return true;
+}
+
+bool TestDriver::Test11()
+{
+    return true;
+}
+
 
 const char* TestDriver::TestName()
 {
@@ -183,24 +208,24 @@ Status TestDriver::RunAllTests()
 {
     Status status = OK;
 	int result;
-	int i;
+	int test;
+	char *next, *end;
 	const int inTxtLen = 32;
 	char *inputTxt = new char[inTxtLen];
 
-	//there are really 6 tests but the last one doesn't do anything so I'll only mention 1-5
 	cout << "Input a space separated test sequence (ie. a list of numbers " << endl <<
-		" in the range 1-5: 1 5 2 3) or hit ENTER to run all tests: ";
+		" in the range 1-11: 1 5 2 3) or hit ENTER to run all tests: ";
 
 	cin.getline ( inputTxt, inTxtLen );
 	if ( strlen(inputTxt) == 0 )
 	{
-		inputTxt = "12345";
+		inputTxt = "1 2 3 4 5 6 7 8 9 10 11";
 	}	
-	for ( i = 0; i < (int)strlen(inputTxt); i++)
+	for ( next = inputTxt; (test = strtol(next, &end, 10)), end != next; next = end )
 	{
-		switch ( inputTxt[i] )
+		switch ( test )
 		{
-		case '1' : 
+		case 1 : 
 			minibase_errors.clear_errors();
 			result = Test1();
 			if ( !result || minibase_errors.error() )
@@ -212,7 +237,7 @@ Status TestDriver::RunAllTests()
 				minibase_errors.show_errors(cerr);
 			}
 			break;
-		case '2' :
+		case 2 :
 			minibase_errors.clear_errors();
 			result = Test2();
 			if ( !result || minibase_errors.error() )
@@ -224,7 +249,7 @@ Status TestDriver::RunAllTests()
 				minibase_errors.show_errors(cerr);
 			}
 			break;
-		case '3' :
+		case 3 :
 			minibase_errors.clear_errors();
 			result = Test3();
 			if ( !result || minibase_errors.error() )
@@ -236,7 +261,7 @@ Status TestDriver::RunAllTests()
 				minibase_errors.show_errors(cerr);
 			}    
 			break;
-		case '4' :
+		case 4 :
 			minibase_errors.clear_errors();
 			result = Test4();
 			if ( !result || minibase_errors.error() )
@@ -248,7 +273,7 @@ Status TestDriver::RunAllTests()
 				minibase_errors.show_errors(cerr);
 			}
 			break;
-		case '5' :
+		case 5 :
 			minibase_errors.clear_errors();
 			result = Test5();
 			if ( !result || minibase_errors.error() )
@@ -260,7 +285,7 @@ Status TestDriver::RunAllTests()
 				minibase_errors.show_errors(cerr);
 			}
 			break;
-		case '6' :
+		case 6 :
 			minibase_errors.clear_errors();
 			result = Test6();
 			if ( !result || minibase_errors.error() )
@@ -272,6 +297,76 @@ Status TestDriver::RunAllTests()
 				minibase_errors.show_errors(cerr);
 			}
 
+			minibase_errors.clear_errors();
+			break;
+		case 7 :
+			minibase_errors.clear_errors();
+			result = Test7();
+			if ( !result || minibase_errors.error() )
+			{
+				status = FAIL;
+				if ( minibase_errors.error() )
+					cerr << (result? "*** Unexpected error(s) logged, test failed:\n"
+					: "Errors logged:\n");
+				minibase_errors.show_errors(cerr);
+			}
+
+			minibase_errors.clear_errors();
+			break;
+		case 8 :
+			minibase_errors.clear_errors();
+			result = Test8();
+			if ( !result || minibase_errors.error() )
+			{
+				status = FAIL;
+				if ( minibase_errors.error() )
+					cerr << (result? "*** Unexpected error(s) logged, test failed:\n"
+					: "Errors logged:\n");
+				minibase_errors.show_errors(cerr);
+			}
+
+			minibase_errors.clear_errors();
+			break;
+		case 9 :
+			minibase_errors.clear_errors();
+			result = Test9();
+			if ( !result || minibase_errors.error() )
+			{
+				status = FAIL;
+				if ( minibase_errors.error() )
+					cerr << (result? "*** Unexpected error(s) logged, test failed:\n"
+					: "Errors logged:\n");
+				minibase_errors.show_errors(cerr);
+			}
+
+			minibase_errors.clear_errors();
+			break;
+		case 10 :
+			minibase_errors.clear_errors();
+			result = Test10();
+			if ( !result || minibase_errors.error() )
+			{
+				status = FAIL;
+				if ( minibase_errors.error() )
+					cerr << (result? "*** Unexpected error(s) logged, test failed:\n"
+					: "Errors logged:\n");
+				minibase_errors.show_errors(cerr);
+			}
+
+			minibase_errors.clear_errors();
+			break;
+		case 11 :
+			minibase_errors.clear_errors();
+			result = Test11();
+			if ( !result || minibase_errors.error() )
+			{
+				status = FAIL;
+				if ( minibase_errors.error() )
+					cerr << (result? "*** Unexpected error(s) logged, test failed:\n"
+					: "Errors logged:\n");
+				minibase_errors.show_errors(cerr);
+			}
+
 			minibase_errors.clear_errors();
 			break;
 		}
@@ -0,0 +1,155 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "include/minirel.h"
+#include "include/bufmgr.h"
+#include "include/heapfile.h"
+#include "include/scan.h"
+#include "include/join.h"
+#include "include/relation.h"
+#include "include/keymatch.h"
+
+int MINIBASE_RESTART_FLAG = 0;// used in minibase part
+
+//
+// BlockNestedLoopJoin with each MatchKeys kernel, for blocks of 1, 2,
+// 4, ... pages up to what the buffer pool leaves free.  For each block
+// size and kernel, the time of the join, and that of the comparisons
+// alone: the proj of every employee, a block at a time, against the id
+// of every project, in memory, as the join compares them.
+//
+// Usage: minibase-blockbench [frames in buffer pool]
+//
+
+#define DEFAULT_NUM_OF_BUFS 50
+#define NUM_OF_DB_PAGES     2000
+#define RESERVED_FRAMES     (3*3)   // as main.cpp leaves to the scans and inserts
+
+static const char *kernelNames[] = { "scalar", "SSE2", "AVX2" };
+
+
+//------------------------------------------------------------------
+// ReadKeys
+//
+// Purpose  : Read the join attribute of every record of a relation.
+// Output   : numOfKeys - how many there are.
+// Return   : the keys, for the caller to delete [].
+//------------------------------------------------------------------
+
+static int *ReadKeys(JoinSpec spec, int& numOfKeys)
+{
+	Status s;
+	Scan *scan = spec.file->OpenScan(s);
+	int *keys = new int[spec.file->GetNumOfRecords()];
+	char *rec = new char[spec.recLen];
+	int len = spec.recLen;
+	RecordID rid;
+
+	numOfKeys = 0;
+	while (scan->GetNext(rid, rec, len) == OK)
+		memcpy(&keys[numOfKeys++], rec + spec.offset, sizeof(int));
+
+	delete scan;
+	delete [] rec;
+	return keys;
+}
+
+
+//------------------------------------------------------------------
+// TimeKernel
+//
+// Purpose  : Compare every key of s with the keys of r, blockSize of
+//            them at a time, with MatchKeys.
+// Output   : numOfMatches - the number of matches.
+// Return   : the time it took, in seconds.
+//------------------------------------------------------------------
+
+static double TimeKernel(const int *r, int numOfR, const int *s, int numOfS, int blockSize, long& numOfMatches)
+{
+	KeyArray block(blockSize);
+	int *keys = block.GetKeys();
+	int *matches = new int[blockSize];
+	clock_t begin = clock();
+
+	numOfMatches = 0;
+	for (int from = 0; from < numOfR; from += blockSize)
+	{
+		int n = (numOfR - from < blockSize) ? numOfR - from : blockSize;
+
+		memcpy(keys, r + from, n * sizeof(int));
+		for (int j = 0; j < numOfS; j++)
+			numOfMatches += MatchKeys(keys, n, s[j], matches);
+	}
+
+	double duration = double(clock() - begin)/CLOCKS_PER_SEC;
+	delete [] matches;
+	return duration;
+}
+
+
+int main(int argc, char **argv)
+{
+	int numOfBufs = (argc > 1) ? atoi(argv[1]) : DEFAULT_NUM_OF_BUFS;
+	Status s;
+
+	minibase_globals = new SystemDefs(s, "BLOCKBENCH.DB", "BLOCKBENCH.LOG",
+		NUM_OF_DB_PAGES, 500, numOfBufs, NULL);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot create the database.\n";
+		return 1;
+	}
+
+	srand(1);
+	CreateR(1, 1);
+	CreateS(1, 1);
+
+	JoinSpec specOfR, specOfS;
+	CreateSpecForR(specOfR);
+	CreateSpecForS(specOfS);
+
+	int numOfR, numOfS;
+	int *keysR = ReadKeys(specOfR, numOfR);
+	int *keysS = ReadKeys(specOfS, numOfS);
+
+	KeyMatchKernel best = GetKeyMatchKernel();
+	cout << numOfR << " employees, " << numOfS << " projects, " << numOfBufs
+		<< " frames, best kernel " << kernelNames[best] << endl;
+	printf("%6s %8s %7s %10s %10s %8s\n", "pages", "records", "kernel", "join", "compare", "speedup");
+
+	for (int pages = 1; pages <= numOfBufs - RESERVED_FRAMES; pages *= 2)
+	{
+		int B = pages * MINIBASE_PAGESIZE;
+		double scalarCompare = 0;
+
+		for (int k = kmScalar; k <= best; k++)
+		{
+			SetKeyMatchKernel((KeyMatchKernel)k);
+			if (GetKeyMatchKernel() != k)
+				continue;
+
+			long pins, misses, numOfMatches;
+			double duration;
+
+			MINIBASE_BM->ResetStat();
+			HeapFile *T = BlockNestedLoopJoin(specOfR, specOfS, B, pins, misses, duration);
+			double compare = TimeKernel(keysR, numOfR, keysS, numOfS, B / specOfR.recLen, numOfMatches);
+			if (k == kmScalar)
+				scalarCompare = compare;
+			if (numOfMatches != T->GetNumOfRecords())
+				cerr << "ERROR : " << numOfMatches << " matches, but " << T->GetNumOfRecords() << " records.\n";
+			delete T;
+
+			printf("%6d %8d %7s %9.4fs %9.4fs %7.1fx\n", pages, B / specOfR.recLen, kernelNames[k],
+				duration, compare, compare > 0 ? scalarCompare / compare : 0);
+		}
+	}
+	SetKeyMatchKernel(best);
+
+	delete [] keysR;
+	delete [] keysS;
+	remove("BLOCKBENCH.DB");
+	return 0;
+}
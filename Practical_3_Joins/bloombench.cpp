@@ -0,0 +1,131 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "include/minirel.h"
+#include "include/bufmgr.h"
+#include "include/heapfile.h"
+#include "include/scan.h"
+#include "include/join.h"
+#include "include/relation.h"
+#include "include/bloom.h"
+
+int MINIBASE_RESTART_FLAG = 0;// used in minibase part
+
+//
+// Block, index and hash joins of R with a filtered S, with and without
+// a Bloom filter on S.  Only the projects of S whose id is below a
+// given percentage of the ids are kept, so that most employees of R
+// work on a project that is filtered out, and the filter lets the
+// joins skip them.  For each join, the pins, misses and time, with the
+// building of the filter, and how many records of R passed it.
+//
+// Usage: minibase-bloombench [percentage of S kept] [frames in buffer pool]
+//
+
+#define DEFAULT_PERCENT_KEPT 10
+#define DEFAULT_NUM_OF_BUFS  32
+
+#define NUM_OF_DB_PAGES 2000
+
+
+//------------------------------------------------------------------
+// FilterS
+//
+// Purpose  : Make a temporary relation of the projects of S whose id is
+//            below percent of NUM_OF_REC_IN_S.
+//------------------------------------------------------------------
+
+static HeapFile *FilterS(JoinSpec specOfS, int percent)
+{
+	Status s;
+	HeapFile *F = new HeapFile(NULL, s);
+	Scan *scan = specOfS.file->OpenScan(s);
+	Project p;
+	int len = sizeof(Project);
+	RecordID rid;
+
+	while (scan->GetNext(rid, (char *)&p, len) == OK)
+	{
+		if (p.id < NUM_OF_REC_IN_S / 100 * percent)
+			F->InsertRecord((char *)&p, len, rid);
+	}
+	delete scan;
+	return F;
+}
+
+
+static HeapFile *RunJoin(int join, JoinSpec specOfR, JoinSpec specOfS, long& pins, long& misses,
+                         double& duration, BloomFilter *filter)
+{
+	if (join == 0)
+	{
+		int B = (MINIBASE_BM->GetNumOfBuffers()-3*3)*MINIBASE_PAGESIZE;
+		return BlockNestedLoopJoin(specOfR, specOfS, B, pins, misses, duration, filter);
+	}
+	if (join == 1)
+		return IndexNestedLoopJoin(specOfR, specOfS, pins, misses, duration, filter);
+	return HashJoin(specOfR, specOfS, pins, misses, duration, filter);
+}
+
+
+int main(int argc, char **argv)
+{
+	int percent = (argc > 1) ? atoi(argv[1]) : DEFAULT_PERCENT_KEPT;
+	int numOfBufs = (argc > 2) ? atoi(argv[2]) : DEFAULT_NUM_OF_BUFS;
+	Status s;
+
+	minibase_globals = new SystemDefs(s, "BLOOMBENCH.DB", "BLOOMBENCH.LOG",
+		NUM_OF_DB_PAGES, 500, numOfBufs, NULL);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot create the database.\n";
+		return 1;
+	}
+
+	srand(1);
+	CreateR(1, 1);
+	CreateS(1, 1);
+
+	JoinSpec specOfR, specOfS;
+	CreateSpecForR(specOfR);
+	CreateSpecForS(specOfS);
+	specOfS.file = FilterS(specOfS, percent);
+
+	cout << specOfR.file->GetNumOfRecords() << " employees, "
+		<< specOfS.file->GetNumOfRecords() << " projects kept, "
+		<< numOfBufs << " frames" << endl;
+
+	const char *names[] = { "Block", "Index", "Hash " };
+	for (int join = 0; join < 3; join++)
+	{
+		long pins, misses;
+		double duration;
+
+		MINIBASE_BM->ResetStat();
+		HeapFile *T = RunJoin(join, specOfR, specOfS, pins, misses, duration, NULL);
+		cout << names[join] << "       " << pins << " pins, " << misses << " misses, "
+			<< duration << "s, " << T->GetNumOfRecords() << " records" << endl;
+		delete T;
+
+		long pinsWithout = pins;
+
+		MINIBASE_BM->ResetStat();
+		clock_t begin = clock();
+		BloomFilter *filter = BuildBloomFilter(specOfS);
+		double buildDuration = double(clock() - begin)/CLOCKS_PER_SEC;
+
+		T = RunJoin(join, specOfR, specOfS, pins, misses, duration, filter);
+		cout << names[join] << "+Bloom " << pins << " pins, " << misses << " misses, "
+			<< buildDuration + duration << "s, " << T->GetNumOfRecords() << " records, "
+			<< 100.0 * filter->GetNumOfPasses() / filter->GetNumOfLookups() << "% passed, "
+			<< pinsWithout - pins << " pins saved" << endl;
+		delete T;
+		delete filter;
+	}
+
+	delete specOfS.file;
+	remove("BLOOMBENCH.DB");
+	return 0;
+}
@@ -0,0 +1,209 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "include/minirel.h"
+#include "include/bufmgr.h"
+#include "include/btfile.h"
+#include "include/btfilescan.h"
+#include "include/intbtree.h"
+#include "include/inthash.h"
+
+int MINIBASE_RESTART_FLAG = 0;// used in minibase part
+
+//
+// Lookups per second on a BTreeFile, an IntBTreeFile and an IntHashFile
+// holding the same int keys.  Both trees are bulk loaded, and the hash
+// index built by inserting the keys one by one.  The buffer pool holds
+// all their pages, so that what is measured is the search within the
+// pages rather than I/O.
+//
+// The default of a million keys runs in half a minute.  Ten million,
+// with "minibase-btbench 10000000", take 47 minutes on one core:
+//
+//   BTreeFile    built in 783s,   16443 lookups/s
+//   IntBTreeFile built in 436s,   24409 lookups/s, height 4
+//   IntHashFile  built in 1166s,   6166 lookups/s, depth 15
+//
+// against about 100000, 204000 and 157000 lookups/s with a million.
+// A lookup of the IntHashFile pins as many pages at either size, so
+// what the larger run mostly measures is a pin among 650000 frames of
+// the buffer manager, not the search within the pages.
+//
+// Usage: minibase-btbench [number of keys] [number of lookups]
+//
+
+#define DEFAULT_NUM_OF_KEYS    1000000
+#define DEFAULT_NUM_OF_LOOKUPS 1000000
+
+// Feeds the keys 0, 2, 4, ... to BulkLoad, with made up record ids.
+class EvenKeys : public BTreeLoadSource
+{
+public:
+
+	EvenKeys(int n) : n(n), i(0) {}
+
+	Status GetNext(RecordID& rid, void *keyptr)
+	{
+		if (i == n)
+			return DONE;
+		rid.pageNo = i / 100;
+		rid.slotNo = i % 100;
+		*(int *)keyptr = 2*i;
+		i++;
+		return OK;
+	}
+
+private:
+
+	int n, i;
+};
+
+
+//------------------------------------------------------------------
+// Lookup
+//
+// Purpose  : Look up each key with an equality scan.
+// Return   : the number of keys found
+//------------------------------------------------------------------
+
+static int Lookup(IndexFile *index, IndexFileScan *(*open)(IndexFile *, int *),
+                  const int *keys, int numOfLookups)
+{
+	int found = 0;
+
+	for (int i = 0; i < numOfLookups; i++)
+	{
+		int key = keys[i], k;
+		RecordID rid;
+		IndexFileScan *scan = open(index, &key);
+
+		if (scan->GetNext(rid, &k) == OK)
+			found++;
+		delete scan;
+	}
+	return found;
+}
+
+static IndexFileScan *OpenBTree(IndexFile *index, int *key)
+{
+	return ((BTreeFile *)index)->OpenScan(key, key);
+}
+
+static IndexFileScan *OpenIntBTree(IndexFile *index, int *key)
+{
+	return ((IntBTreeFile *)index)->OpenScan(key, key);
+}
+
+static IndexFileScan *OpenIntHash(IndexFile *index, int *key)
+{
+	return ((IntHashFile *)index)->OpenScan(key, key);
+}
+
+
+static double Seconds(clock_t begin)
+{
+	return double(clock() - begin)/CLOCKS_PER_SEC;
+}
+
+
+int main(int argc, char **argv)
+{
+	int numOfKeys = (argc > 1) ? atoi(argv[1]) : DEFAULT_NUM_OF_KEYS;
+	int numOfLookups = (argc > 2) ? atoi(argv[2]) : DEFAULT_NUM_OF_LOOKUPS;
+	Status s;
+
+	// A BTreeFile leaf holds about 60 int entries, an IntNodePage 84,
+	// and an IntHashBucket 84 but is split when full.
+	int numOfPages = numOfKeys/40 + numOfKeys/70 + numOfKeys/40 + 300;
+
+	minibase_globals = new SystemDefs(s, "BTBENCH.DB", "BTBENCH.LOG",
+		numOfPages, 500, numOfPages, NULL);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot create the database.\n";
+		return 1;
+	}
+
+	// Half the lookups hit a key, half fall between two keys.
+
+	int *keys = new int[numOfLookups];
+	srand(1);
+	for (int i = 0; i < numOfLookups; i++)
+		keys[i] = rand() % (2*numOfKeys);
+
+	clock_t begin;
+	double seconds;
+	int found;
+
+	BTreeFile *btree = new BTreeFile(s, "BTBENCH", ATTR_INT, sizeof(int));
+	EvenKeys btreeKeys(numOfKeys);
+	begin = clock();
+	if (s != OK || btree->BulkLoad(&btreeKeys) != OK)
+	{
+		cerr << "ERROR : cannot build the BTreeFile.\n";
+		return 1;
+	}
+	cout << "BTreeFile    built in " << Seconds(begin) << "s" << endl;
+
+	begin = clock();
+	found = Lookup(btree, OpenBTree, keys, numOfLookups);
+	seconds = Seconds(begin);
+	cout << "BTreeFile    " << found << " found, "
+		<< numOfLookups/seconds << " lookups/s" << endl;
+
+	btree->DestroyFile();
+	delete btree;
+
+	IntBTreeFile *intTree = new IntBTreeFile(s, "INTBENCH");
+	EvenKeys intKeys(numOfKeys);
+	begin = clock();
+	if (s != OK || intTree->BulkLoad(&intKeys) != OK)
+	{
+		cerr << "ERROR : cannot build the IntBTreeFile.\n";
+		return 1;
+	}
+	cout << "IntBTreeFile built in " << Seconds(begin) << "s, height "
+		<< intTree->GetHeight() << endl;
+
+	begin = clock();
+	found = Lookup(intTree, OpenIntBTree, keys, numOfLookups);
+	seconds = Seconds(begin);
+	cout << "IntBTreeFile " << found << " found, "
+		<< numOfLookups/seconds << " lookups/s" << endl;
+
+	intTree->DestroyFile();
+	delete intTree;
+
+	IntHashFile *hash = new IntHashFile(s, "HASHBENCH");
+	begin = clock();
+	for (int i = 0; s == OK && i < numOfKeys; i++)
+	{
+		int key = 2*i;
+		RecordID rid;
+
+		rid.pageNo = i / 100;
+		rid.slotNo = i % 100;
+		s = hash->Insert(&key, rid);
+	}
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot build the IntHashFile.\n";
+		return 1;
+	}
+	cout << "IntHashFile  built in " << Seconds(begin) << "s, depth "
+		<< hash->GetGlobalDepth() << endl;
+
+	begin = clock();
+	found = Lookup(hash, OpenIntHash, keys, numOfLookups);
+	seconds = Seconds(begin);
+	cout << "IntHashFile  " << found << " found, "
+		<< numOfLookups/seconds << " lookups/s" << endl;
+
+	hash->DestroyFile();
+	delete hash;
+
+	delete [] keys;
+	remove("BTBENCH.DB");
+	return 0;
+}
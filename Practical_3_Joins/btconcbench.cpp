@@ -0,0 +1,265 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <pthread.h>
+
+#include "include/minirel.h"
+#include "include/bufmgr.h"
+#include "include/intbtree.h"
+
+int MINIBASE_RESTART_FLAG = 0;// used in minibase part
+
+//
+// IntBTreeFile shared by several threads.  For 1, 2, 4, ... threads, up
+// to the number of cores or the number given, a fresh tree is grown by
+// inserting the keys 0, 2, 4, ... in random order, each thread taking
+// its share of them; the keys are then looked up, half of the lookups
+// hitting a key and half falling between two; last comes a mix of nine
+// lookups to one insert of a new key.  Each phase is timed on the
+// wall clock, and the tree is checked after every run.
+//
+// The buffer pool has a frame for every node, so the disk is out of
+// it.  The threads pin the nodes through LatchedBufMgr, behind one
+// mutex that every pin takes, so what the speedup column shows is how
+// the threads fare against each other on that mutex, not how the tree
+// would scale with a buffer manager that let them pin at once.
+//
+// Usage: minibase-btconcbench [number of keys] [most threads]
+//
+
+#define DEFAULT_NUM_OF_KEYS 1000000
+
+enum Phase { phInsert, phLookup, phMixed };
+
+static const char *phaseNames[] = { "inserts", "lookups", "mixed" };
+
+struct BenchWork
+{
+	IntBTreeFile *tree;
+	Phase         phase;
+	const int    *keys;
+	int           from, to;
+	int           found;
+	Status        status;
+};
+
+
+static double WallClock()
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+
+static void *RunPhase(void *arg)
+{
+	BenchWork *w = (BenchWork *)arg;
+	RecordID rid;
+
+	w->found = 0;
+	w->status = OK;
+	for (int i = w->from; w->status == OK && i < w->to; i++)
+	{
+		int key = w->keys[i];
+
+		if (w->phase == phInsert || (w->phase == phMixed && i % 10 == 0))
+		{
+			if (w->phase == phMixed)
+				key = -1 - i;   // below every key looked up
+			rid.pageNo = i / 100;
+			rid.slotNo = i % 100;
+			w->status = w->tree->Insert(&key, rid);
+		}
+		else
+		{
+			Status s = w->tree->Search(&key, rid);
+
+			if (s == OK)
+				w->found++;
+			else if (s != DONE)
+				w->status = s;
+		}
+	}
+	return NULL;
+}
+
+
+//------------------------------------------------------------------
+// TimePhase
+//
+// Purpose  : Run a phase over keys[0..n) with numOfThreads threads,
+//            the calling one among them, each taking a slice of the
+//            keys.
+// Output   : found - the lookups that found their key
+// Return   : the time it took, in seconds; a negative time if a
+//            thread could not be started, or failed
+//------------------------------------------------------------------
+
+static double TimePhase(IntBTreeFile *tree, Phase phase, const int *keys, int n,
+                        int numOfThreads, int& found)
+{
+	BenchWork *work = new BenchWork[numOfThreads];
+	pthread_t *threads = new pthread_t[numOfThreads];
+	Bool *started = new Bool[numOfThreads];
+	Bool failed = FALSE;
+	double begin = WallClock();
+
+	for (int t = 0; t < numOfThreads; t++)
+	{
+		work[t].tree = tree;
+		work[t].phase = phase;
+		work[t].keys = keys;
+		work[t].from = (long)t * n / numOfThreads;
+		work[t].to = (long)(t + 1) * n / numOfThreads;
+		started[t] = (t > 0 && pthread_create(&threads[t], NULL, RunPhase, &work[t]) == 0);
+		if (t > 0 && !started[t])
+			failed = TRUE;
+	}
+	RunPhase(&work[0]);
+
+	found = 0;
+	for (int t = 0; t < numOfThreads; t++)
+	{
+		if (started[t])
+			pthread_join(threads[t], NULL);
+		if ((t == 0 || started[t]) && work[t].status != OK)
+			failed = TRUE;
+		found += work[t].found;
+	}
+	double seconds = WallClock() - begin;
+
+	delete [] work;
+	delete [] threads;
+	delete [] started;
+	return failed ? -1 : seconds;
+}
+
+
+//------------------------------------------------------------------
+// CountEntries
+//
+// Return   : the number of entries of the tree, -1 if a scan of it
+//            finds them out of order
+//------------------------------------------------------------------
+
+static int CountEntries(IntBTreeFile *tree)
+{
+	IndexFileScan *scan = tree->OpenScan();
+	RecordID rid;
+	int key, lastKey = 0, n = 0;
+
+	while (n >= 0 && scan->GetNext(rid, &key) == OK)
+	{
+		n = (n > 0 && key < lastKey) ? -1 : n + 1;
+		lastKey = key;
+	}
+	delete scan;
+	return n;
+}
+
+
+int main(int argc, char **argv)
+{
+	int numOfKeys = (argc > 1) ? atoi(argv[1]) : DEFAULT_NUM_OF_KEYS;
+	int maxThreads = (argc > 2) ? atoi(argv[2]) : sysconf(_SC_NPROCESSORS_ONLN);
+	Status s;
+
+	if (numOfKeys < 10)
+		numOfKeys = 10;
+	if (maxThreads < 1)
+		maxThreads = 1;
+
+	// Leaves split by inserts in random order are about 70% full, 58
+	// entries of 83; the mixed phase adds a tenth more.
+	int numOfPages = numOfKeys/40 + 500;
+
+	minibase_globals = new SystemDefs(s, "BTCONCBENCH.DB", "BTCONCBENCH.LOG",
+		numOfPages, 500, numOfPages, NULL);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot create the database.\n";
+		return 1;
+	}
+
+	// The even keys 0, 2, ... 2*(numOfKeys - 1), shuffled, and as many
+	// lookups of keys below 2*numOfKeys.
+
+	int *inserts = new int[numOfKeys];
+	int *lookups = new int[numOfKeys];
+	int hits = 0, mixedHits = 0;
+
+	srand(1);
+	for (int i = 0; i < numOfKeys; i++)
+		inserts[i] = 2*i;
+	for (int i = numOfKeys - 1; i > 0; i--)
+	{
+		int j = rand() % (i + 1), key = inserts[i];
+
+		inserts[i] = inserts[j];
+		inserts[j] = key;
+	}
+	for (int i = 0; i < numOfKeys; i++)
+	{
+		lookups[i] = rand() % (2*numOfKeys);
+		hits += (lookups[i] % 2 == 0);
+		mixedHits += (lookups[i] % 2 == 0 && i % 10 != 0);
+	}
+
+	cout << numOfKeys << " keys, " << sysconf(_SC_NPROCESSORS_ONLN) << " cores" << endl;
+	printf("%7s %8s %10s %12s %8s\n", "threads", "phase", "seconds", "ops/s", "speedup");
+
+	double single[3] = { 0, 0, 0 };
+	for (int threads = 1; ; threads *= 2)
+	{
+		if (threads > maxThreads)
+			threads = maxThreads;
+
+		IntBTreeFile *tree = new IntBTreeFile(s, "BTCONCBENCH");
+		if (s != OK)
+		{
+			cerr << "ERROR : cannot create the IntBTreeFile.\n";
+			return 1;
+		}
+
+		const int *keys[3] = { inserts, lookups, lookups };
+		int expected[3] = { 0, hits, mixedHits };
+		for (int p = phInsert; p <= phMixed; p++)
+		{
+			int found;
+			double seconds = TimePhase(tree, (Phase)p, keys[p], numOfKeys, threads, found);
+
+			if (seconds < 0 || found != expected[p])
+			{
+				cerr << "ERROR : " << phaseNames[p] << " with " << threads << " threads failed, or found "
+					<< found << " keys, not " << expected[p] << ".\n";
+				return 1;
+			}
+			if (threads == 1)
+				single[p] = seconds;
+			printf("%7d %8s %9.3fs %12.0f %7.2fx\n", threads, phaseNames[p], seconds,
+				numOfKeys / seconds, single[p] / seconds);
+		}
+
+		int numOfEntries = CountEntries(tree);
+		if (numOfEntries != numOfKeys + (numOfKeys + 9) / 10)
+		{
+			cerr << "ERROR : the tree holds " << numOfEntries << " entries, not "
+				<< numOfKeys + (numOfKeys + 9) / 10 << ", or out of order.\n";
+			return 1;
+		}
+
+		tree->DestroyFile();
+		delete tree;
+
+		if (threads == maxThreads)
+			break;
+	}
+
+	delete [] inserts;
+	delete [] lookups;
+	remove("BTCONCBENCH.DB");
+	return 0;
+}
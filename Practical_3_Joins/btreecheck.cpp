@@ -0,0 +1,801 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "include/minirel.h"
+#include "include/bufmgr.h"
+#include "include/db.h"
+#include "include/btfile.h"
+#include "include/btfilescan.h"
+#include "include/intbtree.h"
+#include "include/heapfile.h"
+#include "include/scan.h"
+#include "include/relation.h"
+
+int MINIBASE_RESTART_FLAG = 0;// used in minibase part
+
+//
+// Checks of the B+-Trees of the joins, each on a tree of its own in a
+// fresh database: the trees BTreeFile::BulkLoad builds from string
+// keys, an IntBTreeFile grown and shrunk by inserts and deletes, by one
+// thread and by several at once, the leaves a scan of one reads ahead,
+// and one covering attributes of the records of a HeapFile.
+// Prints what is wrong, and exits with 1 if anything is.
+//
+// Usage: minibase-btreecheck
+//
+
+#define NUM_OF_DB_PAGES 3000
+#define NUM_OF_BUFS     500
+
+#define NUM_OF_WAREHOUSES 10
+#define NUM_OF_DISTRICTS  10
+#define NUM_OF_CUSTOMERS  40
+
+#define NUM_OF_ENTRIES   20000  // inserted into the IntBTreeFile
+#define NUM_OF_VALUES    5000   // of their keys, so that most have duplicates
+#define NUM_OF_RANGES    200
+#define NUM_OF_THREADS   4      // inserting and deleting in the same IntBTreeFile
+
+#define NUM_OF_SCANNED_KEYS 100000  // bulk loaded, for leaves enough to fill the pool twice
+
+#define NUM_OF_EMPLOYEES 5000   // indexed on proj by a tree covering salary and rating
+
+
+// Feeds BulkLoad the string keys
+// "warehouse-WW/district-DD/customer-CCCC/orders" in ascending order,
+// which share long prefixes and differ before their last bytes, with
+// the record id of their number.
+class CustomerKeys : public BTreeLoadSource
+{
+public:
+
+	CustomerKeys() : i(0) {}
+
+	static int Count() { return NUM_OF_WAREHOUSES * NUM_OF_DISTRICTS * NUM_OF_CUSTOMERS; }
+
+	static void Key(int i, char *key)
+	{
+		sprintf(key, "warehouse-%02d/district-%02d/customer-%04d/orders",
+			i / (NUM_OF_DISTRICTS * NUM_OF_CUSTOMERS),
+			i / NUM_OF_CUSTOMERS % NUM_OF_DISTRICTS, i % NUM_OF_CUSTOMERS);
+	}
+
+	Status GetNext(RecordID& rid, void *keyptr)
+	{
+		if (i == Count())
+			return DONE;
+		rid.pageNo = i / 100;
+		rid.slotNo = i % 100;
+		Key(i++, (char *)keyptr);
+		return OK;
+	}
+
+private:
+
+	int i;
+};
+
+
+//------------------------------------------------------------------
+// LeafKeys
+//
+// Input    : a leaf of a BTreeFile of string keys
+// Output   : its first and last keys
+// Return   : OK if successful, DONE if the leaf is empty
+//------------------------------------------------------------------
+
+static Status LeafKeys(PageID pid, char *first, char *last)
+{
+	BTLeafPage *leaf;
+	RecordID rid, dataRid;
+	Status s;
+
+	PIN(pid, leaf);
+	s = leaf->GetFirst(rid, first, dataRid);
+	if (s == OK)
+	{
+		strcpy(last, first);
+		while (leaf->GetNext(rid, last, dataRid) == OK)
+			;
+	}
+	UNPIN(pid, CLEAN);
+	return s;
+}
+
+
+//------------------------------------------------------------------
+// CheckSeparators
+//
+// Input    : a node of a BTreeFile of string keys
+// Output   : numOfSeps - separators of leaves below the node
+//            sepBytes, keyBytes - their lengths, and those of the
+//            first keys of the leaves they separate
+// Purpose  : Check that the key of every leaf but the first in its
+//            parent is the shortest prefix of its first key greater
+//            than the last key of the leaf before it.
+// Return   : the number of separators that are not
+//------------------------------------------------------------------
+
+static int CheckSeparators(PageID pid, int& numOfSeps, int& sepBytes, int& keyBytes)
+{
+	BTIndexPage *page;
+	SortedPage *child;
+	RecordID rid;
+	PageID childPid;
+	char sep[MAX_KEY_SIZE], first[MAX_KEY_SIZE], last[MAX_KEY_SIZE], prefix[MAX_KEY_SIZE];
+	int numOfWrong = 0;
+	Status s;
+
+	if (MINIBASE_BM->PinPage(pid, (Page *&)page) != OK)
+		return 1;
+	if (page->GetType() != INDEX_NODE)
+	{
+		MINIBASE_BM->UnpinPage(pid, CLEAN);
+		return 0;
+	}
+
+	numOfWrong += CheckSeparators(page->GetLeftLink(), numOfSeps, sepBytes, keyBytes);
+	for (s = page->GetFirst(rid, sep, childPid); s == OK; s = page->GetNext(rid, sep, childPid))
+	{
+		Bool leaf;
+
+		MINIBASE_BM->PinPage(childPid, (Page *&)child);
+		leaf = (child->GetType() == LEAF_NODE);
+		PageID prevPid = child->GetPrevPage();
+		MINIBASE_BM->UnpinPage(childPid, CLEAN);
+
+		if (!leaf)
+		{
+			numOfWrong += CheckSeparators(childPid, numOfSeps, sepBytes, keyBytes);
+			continue;
+		}
+
+		if (LeafKeys(prevPid, prefix, last) != OK || LeafKeys(childPid, first, prefix) != OK)
+		{
+			cerr << "ERROR : empty leaf next to separator \"" << sep << "\"\n";
+			numOfWrong++;
+			continue;
+		}
+
+		int i = 0;
+		while (last[i] != '\0' && last[i] == first[i])
+			i++;
+		strncpy(prefix, first, i + 1);
+		prefix[i + 1] = '\0';
+
+		if (strcmp(sep, prefix) != 0)
+		{
+			cerr << "ERROR : separator \"" << sep << "\" between \"" << last
+				<< "\" and \"" << first << "\", not \"" << prefix << "\"\n";
+			numOfWrong++;
+		}
+		numOfSeps++;
+		sepBytes += strlen(sep) + 1;
+		keyBytes += strlen(first) + 1;
+	}
+
+	MINIBASE_BM->UnpinPage(pid, CLEAN);
+	return numOfWrong;
+}
+
+
+//------------------------------------------------------------------
+// CheckStringBulkLoad
+//
+// Purpose  : Bulk load a BTreeFile with string keys sharing long
+//            prefixes, check its separators, and look up every key.
+// Return   : OK if the tree is right, FAIL otherwise
+//------------------------------------------------------------------
+
+static Status CheckStringBulkLoad()
+{
+	Status s;
+	BTreeFile *tree = new BTreeFile(s, "BTCHECK_STRING", ATTR_STRING, MAX_KEY_SIZE);
+	CustomerKeys source;
+	PageID headerID, root;
+	Page *header;
+	int numOfSeps = 0, sepBytes = 0, keyBytes = 0, numOfWrong, numOfMissing = 0;
+
+	cout << "  - Bulk load " << CustomerKeys::Count() << " string keys with shared prefixes\n";
+	if (s != OK || tree->BulkLoad(&source) != OK)
+	{
+		cerr << "ERROR : cannot build the BTreeFile.\n";
+		return FAIL;
+	}
+
+	// The root is the first field of the header page.
+
+	if (MINIBASE_DB->GetFileEntry("BTCHECK_STRING", headerID) != OK
+		|| MINIBASE_BM->PinPage(headerID, header) != OK)
+	{
+		cerr << "ERROR : cannot read the header of the BTreeFile.\n";
+		return FAIL;
+	}
+	memcpy(&root, header, sizeof(PageID));
+	MINIBASE_BM->UnpinPage(headerID, CLEAN);
+
+	numOfWrong = CheckSeparators(root, numOfSeps, sepBytes, keyBytes);
+	cout << "  - " << numOfSeps << " separators of " << (double)sepBytes / numOfSeps
+		<< " bytes on average, for keys of " << (double)keyBytes / numOfSeps << " bytes\n";
+	if (numOfSeps == 0 || sepBytes >= keyBytes)
+	{
+		cerr << "ERROR : no separator was truncated.\n";
+		numOfWrong++;
+	}
+
+	cout << "  - Look up every key\n";
+	for (int i = 0; i < CustomerKeys::Count(); i++)
+	{
+		char key[MAX_KEY_SIZE], found[MAX_KEY_SIZE];
+		RecordID rid;
+		IndexFileScan *scan;
+
+		CustomerKeys::Key(i, key);
+		scan = tree->OpenScan(key, key);
+		if (scan == NULL || scan->GetNext(rid, found) != OK || strcmp(found, key) != 0
+			|| rid.pageNo != i / 100 || rid.slotNo != i % 100)
+		{
+			if (numOfMissing++ == 0)
+				cerr << "ERROR : key \"" << key << "\" not found\n";
+		}
+		delete scan;
+	}
+	if (numOfMissing > 0)
+		cerr << "ERROR : " << numOfMissing << " keys not found\n";
+
+	tree->DestroyFile();
+	delete tree;
+	return (numOfWrong == 0 && numOfMissing == 0) ? OK : FAIL;
+}
+
+
+// An entry of an IntBTreeFile, as the scans return them.
+struct Entry
+{
+	int      key;
+	RecordID rid;
+};
+
+static int CompareEntries(const void *a, const void *b)
+{
+	const Entry *x = (const Entry *)a, *y = (const Entry *)b;
+
+	if (x->key != y->key)
+		return (x->key < y->key) ? -1 : 1;
+	if (x->rid.pageNo != y->rid.pageNo)
+		return (x->rid.pageNo < y->rid.pageNo) ? -1 : 1;
+	return x->rid.slotNo - y->rid.slotNo;
+}
+
+
+//------------------------------------------------------------------
+// CheckScan
+//
+// Input    : a tree, bounds of a scan of it (NULL for none), and the
+//            entries it holds, sorted
+// Purpose  : Check that the scan returns the entries of the reference
+//            within the bounds, in key order.  Equal keys may come in
+//            any order.
+// Return   : OK if it does, FAIL otherwise
+//------------------------------------------------------------------
+
+static Status CheckScan(IntBTreeFile *tree, const int *low, const int *high,
+                        const Entry *ref, int numOfRef)
+{
+	IndexFileScan *scan = tree->OpenScan(low, high);
+	Entry *found = new Entry[numOfRef + 1];
+	int numOfFound = 0, from = 0, to = numOfRef;
+	Status s = OK;
+
+	while (low != NULL && from < numOfRef && ref[from].key < *low)
+		from++;
+	while (high != NULL && to > from && ref[to - 1].key > *high)
+		to--;
+
+	while (scan != NULL && numOfFound <= numOfRef
+		&& scan->GetNext(found[numOfFound].rid, &found[numOfFound].key) == OK)
+	{
+		if (numOfFound > 0 && found[numOfFound].key < found[numOfFound - 1].key)
+			s = FAIL;
+		numOfFound++;
+	}
+	delete scan;
+
+	qsort(found, numOfFound, sizeof(Entry), CompareEntries);
+	if (scan == NULL || s != OK || numOfFound != to - from
+		|| memcmp(found, ref + from, numOfFound * sizeof(Entry)) != 0)
+	{
+		cerr << "ERROR : the scan of [" << (low ? *low : -1) << ", " << (high ? *high : -1)
+			<< "] returned " << numOfFound << " entries, not the " << to - from << " expected\n";
+		s = FAIL;
+	}
+
+	delete [] found;
+	return s;
+}
+
+
+//------------------------------------------------------------------
+// CheckIntInsertDelete
+//
+// Purpose  : Insert entries with random, mostly duplicate keys into an
+//            IntBTreeFile one by one, so that leaves and index nodes
+//            split, delete a third of them, and check full and range
+//            scans against the entries sorted.
+// Return   : OK if the tree is right, FAIL otherwise
+//------------------------------------------------------------------
+
+static Status CheckIntInsertDelete()
+{
+	Status s;
+	IntBTreeFile *tree = new IntBTreeFile(s, "BTCHECK_INT");
+	Entry *entries = new Entry[NUM_OF_ENTRIES];
+	Entry *ref = new Entry[NUM_OF_ENTRIES];
+	int numOfRef = 0;
+
+	cout << "  - Insert " << NUM_OF_ENTRIES << " entries with random keys below "
+		<< NUM_OF_VALUES << endl;
+	srand(1);
+	for (int i = 0; s == OK && i < NUM_OF_ENTRIES; i++)
+	{
+		entries[i].key = rand() % NUM_OF_VALUES;
+		entries[i].rid.pageNo = i / 100;
+		entries[i].rid.slotNo = i % 100;
+		s = tree->Insert(&entries[i].key, entries[i].rid);
+	}
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot insert into the IntBTreeFile.\n";
+		return FAIL;
+	}
+	if (tree->GetHeight() < 3)
+	{
+		cerr << "ERROR : the tree has " << tree->GetHeight() << " levels, no index node split\n";
+		s = FAIL;
+	}
+
+	cout << "  - Delete every third entry\n";
+	for (int i = 0; i < NUM_OF_ENTRIES; i++)
+	{
+		if (i % 3 != 0)
+			ref[numOfRef++] = entries[i];
+		else if (tree->Delete(&entries[i].key, entries[i].rid) != OK)
+		{
+			cerr << "ERROR : cannot delete entry " << i << endl;
+			s = FAIL;
+		}
+	}
+	if (tree->Delete(&entries[0].key, entries[0].rid) != DONE)
+	{
+		cerr << "ERROR : a deleted entry was deleted again\n";
+		s = FAIL;
+	}
+	qsort(ref, numOfRef, sizeof(Entry), CompareEntries);
+
+	cout << "  - Scan the whole tree and " << NUM_OF_RANGES << " ranges of it\n";
+	if (CheckScan(tree, NULL, NULL, ref, numOfRef) != OK)
+		s = FAIL;
+	for (int i = 0; i < NUM_OF_RANGES; i++)
+	{
+		int low = rand() % (NUM_OF_VALUES + 10) - 5;
+		int high = (i % 4 == 0) ? low : low + rand() % (NUM_OF_VALUES / 10);
+
+		if (CheckScan(tree, &low, &high, ref, numOfRef) != OK
+			|| CheckScan(tree, &low, NULL, ref, numOfRef) != OK
+			|| CheckScan(tree, NULL, &high, ref, numOfRef) != OK)
+		{
+			s = FAIL;
+			break;
+		}
+	}
+
+	tree->DestroyFile();
+	delete tree;
+	delete [] entries;
+	delete [] ref;
+	return s;
+}
+
+
+// The entries one thread of CheckConcurrentInsertDelete inserts, then
+// deletes a third of.
+struct InsertWork
+{
+	IntBTreeFile *tree;
+	const Entry  *entries;
+	int           from, to;
+	Status        status;
+};
+
+static void *InsertAndDelete(void *arg)
+{
+	InsertWork *w = (InsertWork *)arg;
+	RecordID rid;
+
+	w->status = OK;
+	for (int i = w->from; w->status == OK && i < w->to; i++)
+	{
+		if (w->tree->Insert(&w->entries[i].key, w->entries[i].rid) != OK
+			|| w->tree->Search(&w->entries[i].key, rid) != OK)
+			w->status = FAIL;
+	}
+	for (int i = w->from; w->status == OK && i < w->to; i += 3)
+	{
+		if (w->tree->Delete(&w->entries[i].key, w->entries[i].rid) != OK)
+			w->status = FAIL;
+	}
+	return NULL;
+}
+
+
+//------------------------------------------------------------------
+// CheckConcurrentInsertDelete
+//
+// Purpose  : Let NUM_OF_THREADS threads insert entries with random,
+//            mostly duplicate keys into the same IntBTreeFile, each
+//            looking up the key of every entry it inserts, then delete
+//            a third of their own entries while the others still
+//            insert.  Check scans and lookups of the tree against the
+//            entries left, sorted.
+// Return   : OK if the tree is right, FAIL otherwise
+//------------------------------------------------------------------
+
+static Status CheckConcurrentInsertDelete()
+{
+	Status s;
+	IntBTreeFile *tree = new IntBTreeFile(s, "BTCHECK_CONC");
+	Entry *entries = new Entry[NUM_OF_ENTRIES];
+	Entry *ref = new Entry[NUM_OF_ENTRIES];
+	InsertWork work[NUM_OF_THREADS];
+	pthread_t threads[NUM_OF_THREADS];
+	Bool started[NUM_OF_THREADS];
+	int numOfRef = 0;
+
+	srand(3);
+	for (int i = 0; i < NUM_OF_ENTRIES; i++)
+	{
+		entries[i].key = rand() % NUM_OF_VALUES;
+		entries[i].rid.pageNo = i / 100;
+		entries[i].rid.slotNo = i % 100;
+	}
+
+	cout << "  - " << NUM_OF_THREADS << " threads insert " << NUM_OF_ENTRIES
+		<< " entries, then delete a third of them\n";
+	for (int t = 0; t < NUM_OF_THREADS; t++)
+	{
+		work[t].tree = tree;
+		work[t].entries = entries;
+		work[t].from = t * NUM_OF_ENTRIES / NUM_OF_THREADS;
+		work[t].to = (t + 1) * NUM_OF_ENTRIES / NUM_OF_THREADS;
+		work[t].status = FAIL;
+		started[t] = (s == OK && pthread_create(&threads[t], NULL, InsertAndDelete, &work[t]) == 0);
+		if (!started[t])
+			s = FAIL;
+	}
+	for (int t = 0; t < NUM_OF_THREADS; t++)
+	{
+		if (started[t])
+			pthread_join(threads[t], NULL);
+		if (work[t].status != OK)
+			s = FAIL;
+	}
+	if (s != OK)
+	{
+		cerr << "ERROR : an insert, lookup or delete of a thread failed\n";
+		tree->DestroyFile();
+		delete tree;
+		delete [] entries;
+		delete [] ref;
+		return FAIL;
+	}
+
+	for (int t = 0; t < NUM_OF_THREADS; t++)
+	{
+		for (int i = work[t].from; i < work[t].to; i++)
+		{
+			if ((i - work[t].from) % 3 != 0)
+				ref[numOfRef++] = entries[i];
+		}
+	}
+	qsort(ref, numOfRef, sizeof(Entry), CompareEntries);
+
+	cout << "  - Scan the whole tree and " << NUM_OF_RANGES << " ranges of it, and look up every key\n";
+	if (CheckScan(tree, NULL, NULL, ref, numOfRef) != OK)
+		s = FAIL;
+	for (int i = 0; s == OK && i < NUM_OF_RANGES; i++)
+	{
+		int low = rand() % NUM_OF_VALUES;
+		int high = low + rand() % (NUM_OF_VALUES / 10);
+
+		s = CheckScan(tree, &low, &high, ref, numOfRef);
+	}
+	// Equal keys are in the order they were inserted in, so the entry a
+	// lookup finds may be any of those of its key.
+	for (int key = -1, i = 0; s == OK && key <= NUM_OF_VALUES; key++)
+	{
+		RecordID rid;
+		Status found;
+		int j;
+
+		while (i < numOfRef && ref[i].key < key)
+			i++;
+		found = tree->Search(&key, rid);
+		for (j = i; j < numOfRef && ref[j].key == key && !(ref[j].rid == rid); j++)
+			;
+		if (found != ((i < numOfRef && ref[i].key == key) ? OK : DONE)
+			|| (found == OK && (j == numOfRef || ref[j].key != key)))
+		{
+			cerr << "ERROR : the lookup of " << key << " went wrong\n";
+			s = FAIL;
+		}
+	}
+
+	tree->DestroyFile();
+	delete tree;
+	delete [] entries;
+	delete [] ref;
+	return s;
+}
+
+
+// Feeds BulkLoad the keys 0, 1, 2, ... n-1.
+class AscendingKeys : public BTreeLoadSource
+{
+public:
+
+	AscendingKeys(int n) : n(n), i(0) {}
+
+	Status GetNext(RecordID& rid, void *keyptr)
+	{
+		if (i == n)
+			return DONE;
+		rid.pageNo = i / 100;
+		rid.slotNo = i % 100;
+		*(int *)keyptr = i++;
+		return OK;
+	}
+
+private:
+
+	int n, i;
+};
+
+
+//------------------------------------------------------------------
+// CheckReadAhead
+//
+// Purpose  : Scan an IntBTreeFile of more leaves than the buffer pool
+//            holds, and check that the leaves it reads ahead are the
+//            ones it goes to next: a step to the next leaf that pins
+//            nothing else must find that leaf in the pool.
+// Return   : OK if it does, FAIL otherwise
+//------------------------------------------------------------------
+
+static Status CheckReadAhead()
+{
+	Status s;
+	IntBTreeFile *tree = new IntBTreeFile(s, "BTCHECK_SCAN");
+	AscendingKeys source(NUM_OF_SCANNED_KEYS);
+
+	cout << "  - Bulk load " << NUM_OF_SCANNED_KEYS << " keys\n";
+	if (s != OK || tree->BulkLoad(&source) != OK)
+	{
+		cerr << "ERROR : cannot bulk load the IntBTreeFile.\n";
+		delete tree;
+		return FAIL;
+	}
+
+	cout << "  - Scan it, counting the leaves that miss the pool\n";
+	IndexFileScan *scan = tree->OpenScan();
+	RecordID rid;
+	long pins, misses, lastPins = 0, lastMisses = 0;
+	int key, lastKey = -1, numOfSteps = 0, numOfMissed = 0;
+
+	MINIBASE_BM->ResetStat();
+	while (scan->GetNext(rid, &key) == OK)
+	{
+		if (key != lastKey + 1)
+			s = FAIL;
+		lastKey = key;
+
+		MINIBASE_BM->GetStat(pins, misses);
+		if (pins == lastPins + 1)
+		{
+			numOfSteps++;
+			numOfMissed += (misses == lastMisses + 1);
+		}
+		lastPins = pins;
+		lastMisses = misses;
+	}
+	delete scan;
+
+	if (s != OK || lastKey != NUM_OF_SCANNED_KEYS - 1)
+	{
+		cerr << "ERROR : the scan stopped at " << lastKey << ", or returned a key out of order\n";
+		s = FAIL;
+	}
+	if (misses < NUM_OF_BUFS)
+	{
+		cerr << "ERROR : only " << misses << " pins missed the pool; the check needs it cold\n";
+		s = FAIL;
+	}
+	if (numOfMissed > 0)
+	{
+		cerr << "ERROR : " << numOfMissed << " of " << numOfSteps
+			<< " leaves the scan went to without reading ahead were not read ahead\n";
+		s = FAIL;
+	}
+
+	tree->DestroyFile();
+	delete tree;
+	return s;
+}
+
+
+//------------------------------------------------------------------
+// CheckCovering
+//
+// Purpose  : Index the employees of a HeapFile on proj with a tree
+//            covering their salary and rating, and check that a scan
+//            of it returns those of every record without reading the
+//            records: it pins no more pages than a scan of the keys
+//            alone.
+// Return   : OK if it does, FAIL otherwise
+//------------------------------------------------------------------
+
+static Status CheckCovering()
+{
+	const int coverLen = 2*sizeof(int);
+	const int coverOffset = (char *)&((Employee *)0)->salary - (char *)0;
+	Status s;
+	HeapFile *file = new HeapFile("BTCHECK_EMP", s);
+	IntBTreeFile *tree = NULL;
+	Employee emp;
+	RecordID rid;
+
+	cout << "  - Index " << NUM_OF_EMPLOYEES << " employees on proj, covering salary and rating\n";
+	srand(2);
+	for (int i = 0; s == OK && i < NUM_OF_EMPLOYEES; i++)
+	{
+		emp.id = i;
+		emp.age = 20 + rand() % 40;
+		emp.proj = rand() % (NUM_OF_EMPLOYEES / 10);
+		emp.salary = 1000 + rand() % 9000;
+		emp.rating = rand() % 10;
+		emp.dept = rand() % 20;
+		s = file->InsertRecord((char *)&emp, sizeof(Employee), rid);
+	}
+	if (s == OK)
+		tree = new IntBTreeFile(s, "BTCHECK_COVER", coverLen);
+	if (s == OK)
+	{
+		Scan *scan = file->OpenScan(s);
+		int len = sizeof(Employee);
+
+		while (s == OK && scan->GetNext(rid, (char *)&emp, len) == OK)
+			s = tree->Insert(&emp.proj, rid, (char *)&emp + coverOffset);
+		delete scan;
+	}
+	if (s != OK || tree->GetCoverLen() != coverLen)
+	{
+		cerr << "ERROR : cannot build the covering IntBTreeFile.\n";
+		if (tree != NULL)
+		{
+			tree->DestroyFile();
+			delete tree;
+		}
+		file->DeleteFile();
+		delete file;
+		return FAIL;
+	}
+
+	cout << "  - Scan the keys alone, then the keys and the covered bytes\n";
+	IntBTreeFileScan *scan;
+	RecordID *rids = new RecordID[NUM_OF_EMPLOYEES + 1];
+	char *covered = new char[(NUM_OF_EMPLOYEES + 1) * coverLen];
+	int *keys = new int[NUM_OF_EMPLOYEES + 1];
+	long keyPins, coverPins, recordPins, misses;
+	int numOfFound = 0;
+
+	MINIBASE_BM->ResetStat();
+	scan = (IntBTreeFileScan *)tree->OpenScan();
+	while (numOfFound <= NUM_OF_EMPLOYEES && scan->GetNext(rids[numOfFound], &keys[numOfFound]) == OK)
+		numOfFound++;
+	delete scan;
+	MINIBASE_BM->GetStat(keyPins, misses);
+
+	MINIBASE_BM->ResetStat();
+	numOfFound = 0;
+	scan = (IntBTreeFileScan *)tree->OpenScan();
+	while (numOfFound <= NUM_OF_EMPLOYEES
+		&& scan->GetNext(rids[numOfFound], &keys[numOfFound], covered + numOfFound*coverLen) == OK)
+		numOfFound++;
+	delete scan;
+	MINIBASE_BM->GetStat(coverPins, misses);
+
+	cout << "  - " << keyPins << " and " << coverPins << " pins, for "
+		<< numOfFound << " entries\n";
+	if (numOfFound != NUM_OF_EMPLOYEES)
+	{
+		cerr << "ERROR : the scan returned " << numOfFound << " entries, not "
+			<< NUM_OF_EMPLOYEES << endl;
+		s = FAIL;
+	}
+	if (coverPins != keyPins)
+	{
+		cerr << "ERROR : the covered bytes cost " << coverPins - keyPins << " more pins\n";
+		s = FAIL;
+	}
+
+	cout << "  - Compare the covered bytes with the records\n";
+	MINIBASE_BM->ResetStat();
+	for (int i = 0; s == OK && i < numOfFound; i++)
+	{
+		int len = sizeof(Employee);
+
+		if (file->GetRecord(rids[i], (char *)&emp, len) != OK || emp.proj != keys[i]
+			|| memcmp(covered + i*coverLen, (char *)&emp + coverOffset, coverLen) != 0)
+		{
+			cerr << "ERROR : entry " << i << " does not cover its record\n";
+			s = FAIL;
+		}
+	}
+	MINIBASE_BM->GetStat(recordPins, misses);
+	if (s == OK)
+		cout << "  - " << recordPins << " pins to read the records instead\n";
+
+	delete [] rids;
+	delete [] covered;
+	delete [] keys;
+	tree->DestroyFile();
+	delete tree;
+	file->DeleteFile();
+	delete file;
+	return s;
+}
+
+
+int main()
+{
+	Status s;
+	int numOfFailed = 0;
+
+	minibase_globals = new SystemDefs(s, "BTCHECK.DB", "BTCHECK.LOG",
+		NUM_OF_DB_PAGES, 500, NUM_OF_BUFS, NULL);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot create the database.\n";
+		return 1;
+	}
+
+	cout << "Separators of a bulk loaded BTreeFile of strings\n";
+	if (CheckStringBulkLoad() != OK)
+		numOfFailed++;
+
+	cout << "Inserts and deletes of an IntBTreeFile\n";
+	if (CheckIntInsertDelete() != OK)
+		numOfFailed++;
+
+	cout << "Inserts and deletes of an IntBTreeFile by " << NUM_OF_THREADS << " threads at once\n";
+	if (CheckConcurrentInsertDelete() != OK)
+		numOfFailed++;
+
+	cout << "Read ahead of an IntBTreeFile scan\n";
+	if (CheckReadAhead() != OK)
+		numOfFailed++;
+
+	cout << "An IntBTreeFile covering the records of a HeapFile\n";
+	if (CheckCovering() != OK)
+		numOfFailed++;
+
+	remove("BTCHECK.DB");
+	if (numOfFailed > 0)
+	{
+		cout << numOfFailed << " checks failed\n";
+		return 1;
+	}
+	cout << "All checks passed\n";
+	return 0;
+}
@@ -0,0 +1,53 @@
+/* -*- C++ -*- */
+/*
+ * bloom.h - class BloomFilter
+ *
+ * A blocked Bloom filter on int keys.  The bits that a key sets all
+ * lie in one block of a cache line, picked by the hash of the key, so
+ * that a lookup touches one cache line whatever the number of bits it
+ * checks.  This costs a few more false positives than spreading the
+ * bits over the whole filter.
+ *
+ * Built on the join attribute of the inner relation by
+ * BuildBloomFilter (join.h), a filter lets a join skip the records of
+ * the outer relation that cannot match before it does any work on
+ * them.  It counts its lookups, and how many passed.
+ */
+
+#ifndef _BLOOM_H
+#define _BLOOM_H
+
+#include "minirel.h"
+
+#define BLOOM_BITS_PER_KEY   10
+#define BLOOM_NUM_OF_HASHES  6
+#define BLOOM_BLOCK_SIZE     64    // bytes, a cache line
+
+class BloomFilter {
+
+public:
+
+	// A filter for about numOfKeys keys, with BLOOM_BITS_PER_KEY bits
+	// for each.
+	BloomFilter(int numOfKeys);
+	~BloomFilter();
+
+	void Add(int key);
+
+	// FALSE if key was never added.  TRUE if it was, and, rarely, if
+	// it was not.
+	Bool MayContain(int key);
+
+	long GetNumOfLookups() { return numOfLookups; }
+	long GetNumOfPasses()  { return numOfPasses; }
+
+private:
+
+	char         *mem;
+	unsigned int *blocks;       // mem, aligned to a block
+	unsigned int  numOfBlocks;
+	long          numOfLookups;
+	long          numOfPasses;
+};
+
+#endif
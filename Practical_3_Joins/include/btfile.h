@@ -12,6 +12,27 @@ enum PrintOption
   RECURSIVE
 };
 
+//
+// A stream of <key, rid> pairs in ascending key order, as read by
+// BTreeFile::BulkLoad.  GetNext returns DONE after the last pair.
+// Sources for a covering IntBTreeFile also give the covered bytes of
+// each pair; by default they are zero.
+//
+class BTreeLoadSource {
+
+public:
+
+	virtual ~BTreeLoadSource() {}
+
+	virtual Status GetNext (RecordID& rid, void *keyptr) = 0;
+	virtual Status GetNext (RecordID& rid, void *keyptr, char *covered, int coverLen)
+	{
+		for (int i = 0; i < coverLen; i++)
+			covered[i] = 0;
+		return GetNext(rid, keyptr);
+	}
+};
+
 class BTreeFile: public IndexFile {
 	
 public:
@@ -26,6 +47,10 @@ public:
 	
     Status Insert(const void *key, const RecordID rid); 
     Status Delete(const void *key, const RecordID rid);
+
+	Status BulkLoad(BTreeLoadSource *source, float fillFactor = 1.0);
+	Status SearchBatch(int numOfKeys, const int *keys, int *matchStart,
+			   RecordID *&matches);
     
 	IndexFileScan *OpenScan(const void *lowKey = NULL, const void *highKey = NULL);
 
@@ -95,6 +120,12 @@ private:
 
     Status FindRunStart (const void *lo_key, BTLeafPage **ppage, RecordID *prid);
     Status _DestroyFile (PageID pageno);
+
+	// Bulk loading
+	Status _BulkLoadLeaves (BTreeLoadSource *source, float fillFactor,
+				PageID *&pids, KeyType *&lowKeys, int& numOfPages);
+	Status _BulkLoadIndex (float fillFactor, PageID *&pids, KeyType *&lowKeys,
+			       int& numOfPages);
 };
 
 
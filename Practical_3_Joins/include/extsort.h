@@ -0,0 +1,49 @@
+/* -*- C++ -*- */
+/*
+ * extsort.h - class ExternalSortScan
+ *
+ * The records of a HeapFile in the order of an int attribute, by an
+ * external merge sort.  Sorted runs are made and merged into longer
+ * ones until few enough are left to be merged at once, within the
+ * memory of the sort.  That last merge is not written out: GetNext
+ * gives out its records as they are merged, so that an operator that
+ * reads them in order, such as a sort-merge join, does not pay for
+ * writing the sorted relation and reading it back.
+ *
+ * ExternalSort (relation.h) writes them to a HeapFile.
+ */
+
+#ifndef _EXTSORT_H
+#define _EXTSORT_H
+
+#include "minirel.h"
+#include "heapfile.h"
+
+// Pages that an open Scan of a HeapFile keeps pinned: a directory page
+// and a data page.  Inserting into a HeapFile pins as many, for a
+// while.
+#define SORT_SCAN_PAGES 2
+
+struct RunList;
+struct LoserTree;
+
+class ExternalSortScan {
+
+public:
+
+	// numOfPages - memory of the sort, in pages, at least
+	//              4*SORT_SCAN_PAGES; 0 for half the buffer pool.
+	ExternalSortScan(HeapFile *S, int len, int offset, int numOfPages, Status& status);
+	~ExternalSortScan();
+
+	// The next record, and its key.  recPtr points into the scan, and
+	// is good until the next call.  DONE after the last record.
+	Status GetNext(char *&recPtr, int& key);
+
+private:
+
+	RunList   *runs;   // runs not merged yet
+	LoserTree *merge;  // the last merge
+};
+
+#endif
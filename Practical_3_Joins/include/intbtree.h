@@ -0,0 +1,212 @@
+/* -*- C++ -*- */
+/*
+ * intbtree.h - class IntNodePage, class IntBTreeFile, class IntBTreeFileScan
+ *
+ * A B+-Tree specialised for attrInteger keys.  BTLeafPage and
+ * BTIndexPage keep their <key, data> pairs in the slots of a HeapPage,
+ * so every probe of a binary search follows a slot to a key somewhere
+ * in the page and goes through KeyCmp.  An IntNodePage instead keeps
+ * the keys of a node in one contiguous array, with the record ids (or
+ * child page ids) in a second array beside it.  A search only touches
+ * the key array, a few cache lines of it, and compares ints directly
+ * without branching on the outcome.
+ *
+ * Deletion removes the entry from its leaf but never merges pages: the
+ * trees are meant to be bulk loaded and mostly read.
+ *
+ * A scan that goes past its first leaf reads the next leaves ahead, a
+ * few at a time: their page ids come from the index node above them,
+ * and they are brought into the buffer pool in page order, so that a
+ * long range scan reads the file in runs rather than a page at each
+ * step of the leaf chain.
+ *
+ * A tree may cover some attributes of the records it indexes: each leaf
+ * entry then also holds coverLen bytes copied from the record, which a
+ * scan returns with the key.  Queries that only need the key and these
+ * bytes are answered from the leaves without reading the records.
+ *
+ * Insert, Delete and Search may be called by several threads at once,
+ * with optimistic lock coupling: every node, and the header, carries a
+ * version that a writer makes odd while it changes them.  Readers lock
+ * nothing.  They read the version of a node, then the node, and check
+ * that the version has not moved before they follow what they read, so
+ * that a search goes down the tree without writing to any node it
+ * passes.  An insert splits the full nodes it meets on the way down,
+ * each with its parent locked, and starts over, so that no split ever
+ * has to go back up the tree.
+ *
+ * This makes the tree safe to share, not fast to share: every node is
+ * still pinned and unpinned through LatchedBufMgr, behind one mutex, so
+ * the threads take turns at each node they visit.
+ *
+ * OpenScan, BulkLoad and DestroyFile are for one thread, while no other
+ * uses the tree.
+ */
+
+#ifndef _INTBTREE_H
+#define _INTBTREE_H
+
+#include "minirel.h"
+#include "page.h"
+#include "index.h"
+#include "bt.h"
+#include "btfile.h"
+#include "latchbm.h"
+
+//
+// CHANGE these constants whenever you update the structure of IntNodePage.
+//
+const int INTNODE_DATA_SIZE = (MAX_SPACE - 4*sizeof(short) - sizeof(int) - 3*sizeof(PageID));
+
+// Largest number of covered bytes per entry; a leaf holds at least four
+// entries.
+const int INTLEAF_MAX_COVER = INTNODE_DATA_SIZE/4 - sizeof(int) - sizeof(RecordID);
+
+// Keys of an index node, which has one more child than keys.
+const int INTINDEX_CAPACITY = (INTNODE_DATA_SIZE - sizeof(PageID)) / (sizeof(int) + sizeof(PageID));
+
+// Leaves a scan reads ahead at a time.
+#define INTSCAN_READAHEAD 8
+
+
+class IntNodePage {
+
+private:
+
+	short  type;          // LEAF_NODE or INDEX_NODE.
+	short  numOfKeys;
+	short  coverLen;      // Covered bytes of each entry of a leaf.
+	short  unused;
+	unsigned int version; // Odd while a thread changes the node.
+	PageID pid;
+	PageID nextPage;      // Leaves are chained in key order.
+	PageID prevPage;
+
+	// The keys, in ascending order, then the record ids and covered
+	// bytes of a leaf or the children of an index node.  Child i of an
+	// index node holds the keys between key i-1 and key i.
+	char   data[INTNODE_DATA_SIZE];
+
+public:
+
+	void   Init(PageID pageNo, NodeType t, int coverLen);
+
+	// Entries of a leaf: a key, a RecordID and the covered bytes each.
+	static int LeafCapacity(int coverLen)
+		{ return INTNODE_DATA_SIZE / (sizeof(int) + sizeof(RecordID) + coverLen); }
+
+	unsigned int *Version()   { return &version; }
+	short  GetType()          { return type; }
+	int    GetNumOfKeys()     { return numOfKeys; }
+	int    Capacity()         { return type == LEAF_NODE ? LeafCapacity(coverLen) : INTINDEX_CAPACITY; }
+	Bool   IsFull()           { return numOfKeys == Capacity(); }
+	PageID PageNo()           { return pid; }
+	PageID GetNextPage()      { return nextPage; }
+	PageID GetPrevPage()      { return prevPage; }
+	void   SetNextPage(PageID pageNo) { nextPage = pageNo; }
+	void   SetPrevPage(PageID pageNo) { prevPage = pageNo; }
+
+	int      *Keys()     { return (int *)data; }
+	RecordID *Rids()     { return (RecordID *)(data + Capacity()*sizeof(int)); }
+	char     *Covered(int i)
+		{ return data + Capacity()*(sizeof(int) + sizeof(RecordID)) + i*coverLen; }
+	PageID   *Children() { return (PageID *)(data + INTINDEX_CAPACITY*sizeof(int)); }
+
+	int    LowerBound(int key);
+	int    UpperBound(int key);
+	PageID GetChild(int key) { return Children()[LowerBound(key)]; }
+
+	void   InsertAt(int i, int key, RecordID rid, const char *covered);
+	void   InsertAt(int i, int key, PageID child);
+	void   DeleteAt(int i);
+	int    MoveHalf(IntNodePage *right);
+};
+
+
+class IntBTreeFileScan;
+
+class IntBTreeFile : public IndexFile {
+
+	friend class IntBTreeFileScan;
+
+public:
+
+	IntBTreeFile(Status& status, const char *filename, int coverLen = 0);
+	~IntBTreeFile();
+
+	Status DestroyFile();
+
+	Status Insert(const void *key, const RecordID rid);
+	Status Insert(const void *key, const RecordID rid, const char *covered);
+	Status Delete(const void *key, const RecordID rid);
+	Status Search(const void *key, RecordID& rid);
+	Status BulkLoad(BTreeLoadSource *source, float fillFactor = 1.0);
+
+	IndexFileScan *OpenScan(const void *lowKey = NULL, const void *highKey = NULL);
+
+	int    GetHeight();
+	int    GetCoverLen();
+
+private:
+
+	struct IntBTreeHeaderPage
+	{
+		PageID root;
+		int    height;     // 1 if the root is a leaf.
+		int    coverLen;
+		unsigned int version;  // of root and height
+	};
+
+	IntBTreeHeaderPage *header;
+	PageID              headerID;
+	char               *dbname;
+
+	Status NewNode(NodeType t, PageID& pid, IntNodePage *&page);
+	Status FindLeaf(int key, PageID& pid);
+	Status _FindLeaf(int key, PageID& pid, IntNodePage *&leaf, unsigned int& version,
+	                 Bool& done);
+	Status _Insert(int key, RecordID rid, const char *covered, Bool& done);
+	Status _Split(PageID pid, IntNodePage *page, IntNodePage *parent, int i);
+	Status _Delete(int key, RecordID rid, Bool& done);
+	Status _Search(int key, RecordID& rid, Bool& done);
+	Status _BulkLoadLeaves(BTreeLoadSource *source, float fillFactor,
+	                       PageID *&pids, int *&seps, int& numOfPages);
+	Status _BulkLoadIndex(float fillFactor, PageID *&pids, int *&seps, int& numOfPages);
+	Status _DestroyFile(PageID pid);
+};
+
+
+class IntBTreeFileScan : public IndexFileScan {
+
+	friend class IntBTreeFile;
+
+public:
+
+	~IntBTreeFileScan();
+
+	Status GetNext(RecordID& rid, void *keyptr);
+	Status GetNext(RecordID& rid, void *keyptr, char *covered);
+	Status DeleteCurrent();
+	int    KeySize() { return sizeof(int); }
+
+private:
+
+	IntBTreeFileScan(IntBTreeFile *file, Status& status,
+	                 const void *lowKey, const void *highKey);
+
+	Status FindParent();
+	Status ReadAhead();
+
+	IntBTreeFile *tree;
+	PageID        currPid;   // leaf being read, pinned, or INVALID_PAGE
+	IntNodePage  *leaf;
+	int           next;      // entry of leaf returned by the next GetNext
+	Bool          dirty;     // whether DeleteCurrent changed leaf
+	Bool          bounded;
+	int           highKey;
+	PageID        parentPid; // index node above the leaves read ahead
+	int           ahead;     // child of parentPid to read ahead next
+	int           unread;    // leaves to go until the next read ahead
+};
+
+#endif
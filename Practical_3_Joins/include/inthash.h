@@ -0,0 +1,159 @@
+/* -*- C++ -*- */
+/*
+ * inthash.h - class IntHashBucket, class IntHashFile, class IntHashFileScan
+ *
+ * An extendible hash index on attrInteger keys.  Unlike StatHashFile,
+ * whose HTAB_SZE buckets are fixed when the index is made, the number
+ * of buckets grows with the index: a full bucket is split in two on
+ * the next bit of the hash of its keys, and the directory, which maps
+ * the last globalDepth bits of a hash to a bucket, doubles whenever a
+ * bucket splits past it.
+ *
+ * The directory lives in pages listed in the header page, so it can
+ * grow to INTHASH_MAX_DIR_PAGES pages.  An open index also keeps a copy
+ * of it in memory, which is read without going to the buffer manager,
+ * so that a lookup pins only its bucket.
+ *
+ * Once the directory has INTHASH_MAX_DIR_PAGES pages it cannot double
+ * any more, and a full bucket that would need it to gets an overflow
+ * page instead of splitting.  So does a full bucket whose keys are all
+ * the key being inserted, since no bit of their hash could split them,
+ * and from then on, a bucket that has overflow pages is never split.
+ * A lookup in such a bucket pins its overflow pages too.  As in
+ * IntBTreeFile, deletion never merges buckets.
+ *
+ * Only equality scans, and scans of the whole index, are supported.
+ */
+
+#ifndef _INTHASH_H
+#define _INTHASH_H
+
+#include "minirel.h"
+#include "page.h"
+#include "index.h"
+
+//
+// CHANGE these constants whenever you update the structure of IntHashBucket.
+//
+const int INTHASH_BUCKET_CAPACITY = (MAX_SPACE - 2*sizeof(short) - 2*sizeof(PageID))
+                                    / (sizeof(int) + sizeof(RecordID));
+
+// Directory entries per directory page, and directory pages per index.
+const int INTHASH_DIR_SIZE = MAX_SPACE / sizeof(PageID);
+const int INTHASH_MAX_DIR_PAGES = (MAX_SPACE - 2*sizeof(int)) / sizeof(PageID);
+
+// The hash of an int key, every bit of which depends on every bit of the
+// key.  Any run of low bits of it can pick a bucket.
+unsigned int HashInt(int key);
+
+
+class IntHashBucket {
+
+private:
+
+	short    localDepth;  // Bits of the hash shared by all its keys.
+	short    numOfEntries;
+	PageID   pid;
+	PageID   nextPage;    // Overflow page, or INVALID_PAGE.
+
+	// Entries are in no particular order.
+	int      keys[INTHASH_BUCKET_CAPACITY];
+	RecordID rids[INTHASH_BUCKET_CAPACITY];
+
+public:
+
+	void     Init(PageID pageNo, int depth);
+
+	int      GetLocalDepth()    { return localDepth; }
+	void     SetLocalDepth(int depth) { localDepth = depth; }
+	int      GetNumOfEntries()  { return numOfEntries; }
+	Bool     IsFull()           { return numOfEntries == INTHASH_BUCKET_CAPACITY; }
+	PageID   PageNo()           { return pid; }
+	PageID   GetNextPage()      { return nextPage; }
+	void     SetNextPage(PageID pageNo) { nextPage = pageNo; }
+
+	int      Key(int i)         { return keys[i]; }
+	RecordID Rid(int i)         { return rids[i]; }
+
+	void     Append(int key, RecordID rid);
+	void     DeleteAt(int i);
+};
+
+
+class IntHashFileScan;
+
+class IntHashFile : public IndexFile {
+
+	friend class IntHashFileScan;
+
+public:
+
+	IntHashFile(Status& status, const char *filename);
+	~IntHashFile();
+
+	Status DestroyFile();
+
+	Status Insert(const void *key, const RecordID rid);
+	Status Delete(const void *key, const RecordID rid);
+
+	// lowKey and highKey must both be NULL, for a scan of the whole
+	// index, or point to the same key.
+	IndexFileScan *OpenScan(const void *lowKey = NULL, const void *highKey = NULL);
+
+	int    GetGlobalDepth();
+
+private:
+
+	struct IntHashHeaderPage
+	{
+		int    globalDepth;
+		int    numOfDirPages;
+		PageID dirPages[INTHASH_MAX_DIR_PAGES];
+	};
+
+	IntHashHeaderPage *header;
+	PageID             headerID;
+	char              *dbname;
+	PageID            *dir;       // copy of the directory pages
+
+	PageID GetBucket(unsigned int hash) { return dir[hash & ((1u << header->globalDepth) - 1)]; }
+
+	Status Create();
+	Status ReadDirectory();
+	Status SetSlot(int slot, PageID pid);
+	Bool   DirectoryIsFull();
+	Status DoubleDirectory();
+	Status Split(PageID pid, IntHashBucket *bucket, unsigned int hash);
+	Status AddToChain(PageID pid, IntHashBucket *bucket, int key, RecordID rid);
+};
+
+
+class IntHashFileScan : public IndexFileScan {
+
+	friend class IntHashFile;
+
+public:
+
+	~IntHashFileScan();
+
+	Status GetNext(RecordID& rid, void *keyptr);
+	Status DeleteCurrent();
+	int    KeySize() { return sizeof(int); }
+
+private:
+
+	IntHashFileScan(IntHashFile *file, Status& status, const int *key);
+
+	Status PinBucket(int from);
+
+	IntHashFile   *index;
+	PageID         currPid;  // page being read, pinned, or INVALID_PAGE
+	IntHashBucket *bucket;
+	int            next;     // entry of bucket looked at by the next GetNext
+	Bool           dirty;    // whether DeleteCurrent changed bucket
+	Bool           all;      // whether every key is returned
+	int            key;
+	int            slot;     // directory entry of the bucket, if all
+};
+
+#endif
@@ -27,11 +27,33 @@ typedef struct JoinSpec {
 // You need to allocate space for newRecord before calling this function.
 void MakeNewRecord(char *newRecord, char *r, char *s, int recLenR, int recLenS);
 
+// Number of records of R whose keys IndexNestedLoopJoin looks up together.
+#define INDEX_JOIN_BATCH 256
+
+// Build a B+-Tree called name on the int attribute at offset of the records of F,
+// by bulk loading.  The caller must DestroyFile() and delete it.
+class BTreeFile;
+BTreeFile *BuildIndex(HeapFile *F, int len, int offset, const char *name);
+
+// Build a Bloom filter on the join attribute of every record of the relation of spec.
+// Given to a join on the inner relation, it lets the join skip the records of the outer
+// relation that cannot match.  The caller must delete it.
+class BloomFilter;
+BloomFilter *BuildBloomFilter(JoinSpec spec);
+
 HeapFile*  TupleNestedLoopJoin(JoinSpec, JoinSpec, long& pinRequests, long& pinMisses, double& duration);
+// Block, index and hash joins skip the records of R that filter, if any, rules out
 // int arg is blocksize
-HeapFile* BlockNestedLoopJoin(JoinSpec, JoinSpec, int B, long& pinRequests, long& pinMisses, double& duration);
-HeapFile* IndexNestedLoopJoin(JoinSpec, JoinSpec, long& pinRequests, long& pinMisses, double& duration);
-void SortMergeJoin(JoinSpec, JoinSpec, long& pinRequests, long& pinMisses, double& duration);
+HeapFile* BlockNestedLoopJoin(JoinSpec, JoinSpec, int B, long& pinRequests, long& pinMisses, double& duration, BloomFilter *filter = NULL);
+HeapFile* IndexNestedLoopJoin(JoinSpec, JoinSpec, long& pinRequests, long& pinMisses, double& duration, BloomFilter *filter = NULL);
+// Sorts both relations with an external sort and merges them
+HeapFile* SortMergeJoin(JoinSpec, JoinSpec, long& pinRequests, long& pinMisses, double& duration);
+// Builds a hash table in memory on the relation with fewer records
+HeapFile* HashJoin(JoinSpec, JoinSpec, long& pinRequests, long& pinMisses, double& duration, BloomFilter *filter = NULL);
+// Partitions both relations to temporary files if the smaller one does not fit in the buffer pool
+HeapFile* HybridHashJoin(JoinSpec, JoinSpec, long& pinRequests, long& pinMisses, double& duration);
+// Radix partitions both relations in memory and joins the partitions with numOfThreads threads
+HeapFile* RadixHashJoin(JoinSpec, JoinSpec, int numOfThreads, long& pinRequests, long& pinMisses, double& duration);
 
 #endif
 
@@ -0,0 +1,53 @@
+/* -*- C++ -*- */
+/*
+ * keymatch.h - class KeyArray, MatchKeys
+ *
+ * The comparison at the heart of a nested loop join: one key of the
+ * inner relation against the keys of a block of the outer one.  The
+ * keys of the block are copied once into a KeyArray, contiguous and
+ * aligned, and MatchKeys then compares a key with KEY_MATCH_WIDTH of
+ * them at a time with AVX2 or SSE2 where the processor has them, and
+ * one at a time where it does not, giving the positions that match.
+ */
+
+#ifndef _KEYMATCH_H
+#define _KEYMATCH_H
+
+#include "minirel.h"
+
+#define KEY_ARRAY_ALIGN 32  // bytes, an AVX2 register
+#define KEY_MATCH_WIDTH 8   // keys an AVX2 register holds
+
+enum KeyMatchKernel { kmScalar, kmSSE2, kmAVX2 };
+
+
+class KeyArray {
+
+public:
+
+	KeyArray(int capacity);
+	~KeyArray();
+
+	int *GetKeys()     { return keys; }
+	int  GetCapacity() { return capacity; }
+
+private:
+
+	char *mem;
+	int  *keys;  // mem, aligned to KEY_ARRAY_ALIGN
+	int   capacity;
+};
+
+
+// The positions, in increasing order, of the keys of keys[0..n-1] that
+// are equal to key, into positions, which has room for n.  Returns how
+// many there are.  keys must be aligned to KEY_ARRAY_ALIGN, as those of
+// a KeyArray are.
+int MatchKeys(const int *keys, int n, int key, int *positions);
+
+// The kernel MatchKeys uses: the fastest the processor has, unless
+// another was set.  Setting one it does not have sets kmScalar.
+KeyMatchKernel GetKeyMatchKernel();
+void SetKeyMatchKernel(KeyMatchKernel kernel);
+
+#endif
@@ -0,0 +1,48 @@
+/* -*- C++ -*- */
+/*
+ * latchbm.h - class LatchedBufMgr
+ *
+ * The buffer manager is for one thread only: a pin looks the page up
+ * in its frame table and may ask the replacer for a victim, and
+ * neither guards its tables against another thread doing the same.
+ * LatchedBufMgr puts one mutex around the calls of MINIBASE_BM that a
+ * structure shared by threads needs, so that they can pin and unpin
+ * its pages from any thread.  A pin still keeps its page in its frame
+ * until the matching unpin; what the threads then do with the page is
+ * up to the structure, as IntBTreeFile does with the versions of its
+ * nodes.
+ *
+ * All the pins of all the threads take the same mutex, so threads that
+ * share a structure this way wait for each other at every page.
+ *
+ * The mutex only orders the calls made through LatchedBufMgr.  A call
+ * made directly on MINIBASE_BM while another thread is in one of them
+ * is as unsafe as before.
+ */
+
+#ifndef _LATCHBM_H
+#define _LATCHBM_H
+
+#include "minirel.h"
+#include "page.h"
+
+class LatchedBufMgr {
+
+public:
+
+	static Status PinPage(PageID pid, Page *&page);
+	static Status UnpinPage(PageID pid, Bool dirty);
+	static Status NewPage(PageID& pid, Page *&page);
+	static Status FreePage(PageID pid);
+};
+
+#define LATCHED_PIN(a, b)   if (LatchedBufMgr::PinPage((a), (Page *&)(b)) != OK) {\
+						cerr << "Unable to pin page " << a << endl; return FAIL;}
+#define LATCHED_UNPIN(a, b) if (LatchedBufMgr::UnpinPage((a), (b)) != OK) {\
+						cerr << "Unable to unpin page " << a << endl; return FAIL;}
+#define LATCHED_FREEPAGE(a) if (LatchedBufMgr::FreePage((a)) != OK) {\
+						cerr << "Unable to free page " << a << endl; return FAIL;}
+#define LATCHED_NEWPAGE(a, b)  if (LatchedBufMgr::NewPage((a), (Page *&)(b)) != OK) {\
+						cerr << "Unable to allocate new page " << a << endl; return FAIL;}
+
+#endif
@@ -0,0 +1,251 @@
+/* -*- C++ -*- */
+/*
+ * operator.h - class RecordBatch, class Operator and its subclasses
+ *
+ * Pipelined execution of a query over HeapFiles.  An operator is
+ * opened, asked for the Next batch of its records until it has none
+ * left, and closed.  It asks the operators below it for their records,
+ * a batch at a time, as it needs them, so that the result of a join
+ * can be filtered, aggregated or joined again without ever being
+ * written to pages.  Materialize writes the records of an operator to
+ * a HeapFile, which is what the joins of join.h do with theirs.
+ *
+ * Records are of fixed length, and the attributes operators look at
+ * are ints.  A join operator gives out a record of its outer input
+ * followed by a record of its inner one, as MakeNewRecord makes them.
+ *
+ * An operator owns the operators it is given, and deletes them.
+ */
+
+#ifndef _OPERATOR_H
+#define _OPERATOR_H
+
+#include "minirel.h"
+#include "heapfile.h"
+#include "scan.h"
+#include "join.h"
+
+#define OP_BATCH_SIZE 64  // records in a batch
+
+class KeyArray;
+
+
+class RecordBatch {
+
+public:
+
+	RecordBatch(int recLen, int capacity = OP_BATCH_SIZE);
+	~RecordBatch();
+
+	int   GetRecLen()       { return recLen; }
+	int   GetNumOfRecords() { return numOfRecs; }
+	Bool  IsFull()          { return numOfRecs == capacity; }
+	char *Record(int i)     { return recs + i*recLen; }
+
+	// Room for one more record at the end, which the caller fills in.
+	char *Append()          { return recs + (numOfRecs++)*recLen; }
+	void  Clear()           { numOfRecs = 0; }
+
+private:
+
+	char *recs;
+	int   recLen;
+	int   numOfRecs;
+	int   capacity;
+};
+
+
+class Operator {
+
+public:
+
+	virtual ~Operator() {}
+
+	virtual Status Open() = 0;
+
+	// Replace the records of batch, of GetRecLen() bytes, with the next
+	// ones.  OK if there is at least one; DONE, with batch empty, once
+	// every record has been given out.
+	virtual Status Next(RecordBatch& batch) = 0;
+
+	virtual Status Close() = 0;
+
+	int GetRecLen() { return recLen; }
+
+protected:
+
+	int recLen;
+};
+
+
+// The records of a HeapFile, in the order of a Scan.
+class ScanOp : public Operator {
+
+public:
+
+	ScanOp(HeapFile *file, int recLen);
+	~ScanOp();
+
+	Status Open();
+	Status Next(RecordBatch& batch);
+	Status Close();
+
+private:
+
+	HeapFile *file;
+	Scan     *scan;  // NULL once every record has been read
+};
+
+
+// The records of child whose int attribute at offset is op value.
+class FilterOp : public Operator {
+
+public:
+
+	FilterOp(Operator *child, int offset, AttrOperator op, int value);
+	~FilterOp();
+
+	Status Open();
+	Status Next(RecordBatch& batch);
+	Status Close();
+
+private:
+
+	Operator     *child;
+	RecordBatch   in;
+	int           inPos;
+	int           offset;
+	AttrOperator  op;
+	int           value;
+};
+
+
+// The int attributes at offsets of the records of child, in that order.
+class ProjectOp : public Operator {
+
+public:
+
+	ProjectOp(Operator *child, int numOfAttrs, const int *offsets);
+	~ProjectOp();
+
+	Status Open();
+	Status Next(RecordBatch& batch);
+	Status Close();
+
+private:
+
+	Operator    *child;
+	RecordBatch  in;
+	int          numOfAttrs;
+	int         *offsets;
+};
+
+
+// BlockNestedLoopJoin: inner is read again, from Open to Close, for
+// every B bytes of records of outer.
+class BlockNestedLoopJoinOp : public Operator {
+
+public:
+
+	BlockNestedLoopJoinOp(Operator *outer, int offsetOuter, Operator *inner, int offsetInner, int B);
+	~BlockNestedLoopJoinOp();
+
+	Status Open();
+	Status Next(RecordBatch& batch);
+	Status Close();
+
+private:
+
+	Status FillBlock();
+
+	Operator    *outer;
+	Operator    *inner;
+	int          offsetOuter;
+	int          offsetInner;
+	RecordBatch  outerBatch;
+	int          outerPos;
+	Bool         outerDone;
+	char        *block;
+	int          blockSize;   // records
+	int          numInBlock;
+	KeyArray    *keys;        // of the block
+	int         *matches;     // in the block, of the record before innerPos
+	int          numOfMatches;
+	int          matchPos;
+	RecordBatch  innerBatch;
+	int          innerPos;
+	Bool         innerOpen;
+};
+
+
+// IndexNestedLoopJoin: the records of the HeapFile of inner are looked
+// up, a batch of keys of outer at a time, in a B+-Tree built on it by
+// Open.
+class IndexNestedLoopJoinOp : public Operator {
+
+public:
+
+	IndexNestedLoopJoinOp(Operator *outer, int offsetOuter, JoinSpec inner);
+	~IndexNestedLoopJoinOp();
+
+	Status Open();
+	Status Next(RecordBatch& batch);
+	Status Close();
+
+private:
+
+	Operator    *outer;
+	int          offsetOuter;
+	JoinSpec     inner;
+	BTreeFile   *btree;
+	RecordBatch  outerBatch;
+	int          outerPos;
+	Bool         outerDone;
+	int         *keys;
+	int         *matchStart;
+	RecordID    *matches;
+	int          matchPos;
+	char        *recInner;
+};
+
+
+// HashJoin: Open reads all of inner into a hash table in memory, which
+// the records of outer are then looked up in.
+struct JoinHashTable;
+
+class HashJoinOp : public Operator {
+
+public:
+
+	HashJoinOp(Operator *outer, int offsetOuter, Operator *inner, int offsetInner);
+	~HashJoinOp();
+
+	Status Open();
+	Status Next(RecordBatch& batch);
+	Status Close();
+
+private:
+
+	Operator      *outer;
+	Operator      *inner;
+	int            offsetOuter;
+	int            offsetInner;
+	JoinHashTable *table;
+	RecordBatch    outerBatch;
+	int            outerPos;
+	Bool           outerDone;
+	int            key;       // of the record at outerPos
+	int            tablePos;  // next record of its bucket
+	int            tableEnd;
+};
+
+
+// Write every record of op to a new temporary HeapFile, opening and
+// closing op.  NULL on error.
+HeapFile *Materialize(Operator *op);
+
+// The number of records of op, and the sum of their int attribute at
+// offset, opening and closing op.
+Status Aggregate(Operator *op, int offset, long& count, long& sum);
+
+#endif
@@ -0,0 +1,70 @@
+/* -*- C++ -*- */
+/*
+ * planner.h - struct RelationStats, struct JoinCost, PlanJoin
+ *
+ * Choosing a join of join.h for two relations from what is known of
+ * them.  GetRelationStats gathers the statistics of a relation: its
+ * pages, counted from the directory pages of its HeapFile, its
+ * records, and an estimate of the distinct values of its join
+ * attribute.  PlanJoin then estimates, for every join, the pages it
+ * will read that miss the buffer pool and the time it will take with
+ * the frames there are, and picks the quickest.
+ *
+ * The costs of PLAN_*_COST are in microseconds, and were measured on
+ * the sweep of main.cpp, with a DB file the operating system keeps in
+ * its cache: a miss costs more than that on a real disk.
+ */
+
+#ifndef _PLANNER_H
+#define _PLANNER_H
+
+#include "minirel.h"
+#include "heapfile.h"
+#include "join.h"
+
+#define PLAN_MISS_COST        0.5     // a page read from the DB file
+#define PLAN_SCAN_COST        0.1     // a record read by a scan
+#define PLAN_WRITE_COST       3.5     // a record of the result inserted into its HeapFile
+#define PLAN_TEMP_WRITE_COST  1.0     // a record written to a run or partition, whose directory is short
+#define PLAN_COMPARE_COST     0.03    // a record of S read and compared, by TupleNestedLoopJoin
+#define PLAN_SIMD_COST        0.001   // a key compared by MatchKeys
+#define PLAN_PROBE_COST       1.5     // a key looked up in a B+-Tree, and its matches fetched
+#define PLAN_HASH_COST        0.05    // a record put into, or looked up in, a hash table
+
+#define PLAN_RESERVED_FRAMES  (3*3)   // frames left to scans and inserts, as main.cpp leaves them
+
+enum JoinMethod { jmTuple, jmBlock, jmIndex, jmSortMerge, jmHash, jmHybrid, jmRadix };
+
+#define NUM_OF_JOIN_METHODS 7
+
+struct RelationStats {
+	int  numOfPages;
+	int  numOfRecords;
+	int  numOfDistinct;  // values of the join attribute, estimated
+	int  recLen;
+	Bool hasIndex;       // whether a B+-Tree on the join attribute is already there
+};
+
+struct JoinCost {
+	long   misses;   // pins that miss the buffer pool, writing the result included
+	double time;     // seconds
+};
+
+// Gather the statistics of the relation of spec, in one scan of it.
+// IndexNestedLoopJoin builds an index of its own every time, so
+// hasIndex is FALSE: a caller that keeps one sets it.
+Status GetRelationStats(JoinSpec spec, RelationStats& stats);
+
+// The cost of each join of R with S, as JoinMethod indexes costs, with
+// numOfFrames frames in the buffer pool and, for RadixHashJoin,
+// numOfThreads threads.  Returns the join of least time.
+JoinMethod PlanJoin(RelationStats& statsOfR, RelationStats& statsOfS, int numOfFrames,
+                    int numOfThreads, JoinCost costs[NUM_OF_JOIN_METHODS]);
+
+const char *GetJoinMethodName(JoinMethod method);
+
+// Plan a join of R with S with the buffer pool there is, and run it.
+HeapFile *PlannedJoin(JoinSpec specOfR, JoinSpec specOfS, int numOfThreads, long& pinRequests,
+                      long& pinMisses, double& duration);
+
+#endif
@@ -0,0 +1,49 @@
+/* -*- C++ -*- */
+/*
+ * radixjoin.h - the in-memory part of RadixHashJoin
+ *
+ * RadixHashJoin (join.h) reads R and S into memory through the buffer
+ * manager, which is for one thread only, and hands the join keys of
+ * their records to RadixJoinTuples.  That splits both on the low bits
+ * of the hash of the key, in one pass or two, into partitions small
+ * enough that the hash table of one fits in cache, and joins the
+ * pairs of partitions, with as many threads as it is given.
+ *
+ * RadixJoinTuples touches neither the buffer manager nor any file, so
+ * it can be run, and timed, on its own.
+ */
+
+#ifndef _RADIXJOIN_H
+#define _RADIXJOIN_H
+
+// The cache that a partition of the build relation, with its hash
+// table, should fit in: the L2 cache of one core.
+#define RADIX_CACHE_SIZE (256*1024)
+
+// Partitions made by one pass at most, as bits of the hash.  Past
+// this, the write-combining buffers of a pass, one cache line per
+// partition, no longer fit in L1 cache, nor their pages in the TLB.
+#define RADIX_MAX_BITS_PER_PASS 7
+
+#define RADIX_CACHE_LINE 64
+
+// The join key of a record, and where the record is.
+struct RadixTuple
+{
+	int key;
+	int index;
+};
+
+// The indexes of a record of R and a record of S that join.
+struct RadixMatch
+{
+	int indexR;
+	int indexS;
+};
+
+// Join r and s on key with numOfThreads threads.  Return the number of
+// matches, which are put in a new array, to be deleted by the caller.
+long RadixJoinTuples(const RadixTuple *r, int numOfR, const RadixTuple *s, int numOfS,
+                     int numOfThreads, RadixMatch *&matches);
+
+#endif
@@ -43,6 +43,8 @@ void CreateSpecForR (JoinSpec &spec);// Create Join Specification for R
 HeapFile *SortFile(HeapFile *S, int len, int offset);
 // Sort a relation stored in HeapFile S, len is the length of record, offset is the offset
 // of sort key attribute from the beginning of record, i.e. recptr+offset point to the sort key
+HeapFile *ExternalSort(HeapFile *S, int len, int offset, int numOfPages);
+// Sort like SortFile, with at most numOfPages pages of memory (0 for half the buffer pool)
 void PrintResult(HeapFile *RS, char *name); // Print the result of Joined relation RS to file whose filename is name
 
 #endif
@@ -0,0 +1,203 @@
+/* -*- C++ -*- */
+/*
+ * vectorop.h - class ColumnBatch, class VecOperator and its subclasses,
+ *              class VecHashAggregate
+ *
+ * Vectorized execution of a query over HeapFiles of int attributes.
+ * Like the operators of operator.h, a VecOperator is opened, asked for
+ * the Next batch of its rows until it has none left, and closed; but
+ * its batches are of VEC_BATCH_SIZE rows, held a column at a time, so
+ * that the work an operator does on a batch is a loop over an int
+ * array the compiler can keep in registers and vectorize, rather than
+ * a call per record.
+ *
+ * The rows of a batch that are still live are listed in its selection
+ * vector: a filter shrinks the selection rather than moving the rows
+ * that pass, and an operator above it only looks at the rows selected.
+ * A batch all of whose rows are live has no selection vector.
+ *
+ * A VecOperator owns the operators it is given, and deletes them.
+ */
+
+#ifndef _VECTOROP_H
+#define _VECTOROP_H
+
+#include "minirel.h"
+#include "heapfile.h"
+#include "scan.h"
+#include "join.h"
+
+#define VEC_BATCH_SIZE 1024  // rows in a batch
+#define VEC_MAX_COLS   (2*MAX_ATTR)
+
+
+class ColumnBatch {
+
+public:
+
+	ColumnBatch(int numOfCols, int capacity = VEC_BATCH_SIZE);
+	~ColumnBatch();
+
+	int   GetNumOfCols()     { return numOfCols; }
+	int   GetCapacity()      { return capacity; }
+	int  *Column(int c)      { return cols[c]; }
+
+	// Rows 0 to GetNumOfRows() - 1 hold values, and every one of them is
+	// selected, until SetSelection is called.
+	int   GetNumOfRows()     { return numOfRows; }
+	void  SetNumOfRows(int n) { numOfRows = n; numOfSelected = n; hasSelection = FALSE; }
+
+	// The rows selected, in increasing order: NULL if they all are.
+	int  *GetSelection()     { return hasSelection ? sel : NULL; }
+	int   GetNumOfSelected() { return numOfSelected; }
+
+	// The selection vector, for the caller to fill in with n rows.
+	int  *SelectionVector()  { return sel; }
+	void  SetSelection(int n) { numOfSelected = n; hasSelection = TRUE; }
+
+private:
+
+	int  *cols[VEC_MAX_COLS];
+	int  *sel;
+	int   numOfCols;
+	int   numOfRows;
+	int   numOfSelected;
+	Bool  hasSelection;
+	int   capacity;
+};
+
+
+class VecOperator {
+
+public:
+
+	virtual ~VecOperator() {}
+
+	virtual Status Open() = 0;
+
+	// Replace the rows of batch, of GetNumOfCols() columns, with the
+	// next ones.  OK if at least one is selected; DONE once every row
+	// has been given out.
+	virtual Status Next(ColumnBatch& batch) = 0;
+
+	virtual Status Close() = 0;
+
+	int GetNumOfCols() { return numOfCols; }
+
+protected:
+
+	int numOfCols;
+};
+
+
+// The records of a HeapFile of recLen / sizeof(int) int attributes,
+// attribute i in column i.
+class VecScanOp : public VecOperator {
+
+public:
+
+	VecScanOp(HeapFile *file, int recLen);
+	~VecScanOp();
+
+	Status Open();
+	Status Next(ColumnBatch& batch);
+	Status Close();
+
+private:
+
+	HeapFile *file;
+	Scan     *scan;  // NULL once every record has been read
+	int       recLen;
+	int      *rec;
+};
+
+
+// The rows of child whose column col is op value.
+class VecFilterOp : public VecOperator {
+
+public:
+
+	VecFilterOp(VecOperator *child, int col, AttrOperator op, int value);
+	~VecFilterOp();
+
+	Status Open();
+	Status Next(ColumnBatch& batch);
+	Status Close();
+
+private:
+
+	VecOperator  *child;
+	int           col;
+	AttrOperator  op;
+	int           value;
+};
+
+
+// HashJoin: Open reads all of build into a hash table, which the rows
+// of probe are then looked up in a batch at a time.  A row of the
+// result has the columns of probe followed by those of build.
+struct VecHashTable;
+
+class VecHashJoinOp : public VecOperator {
+
+public:
+
+	VecHashJoinOp(VecOperator *probe, int probeCol, VecOperator *build, int buildCol);
+	~VecHashJoinOp();
+
+	Status Open();
+	Status Next(ColumnBatch& batch);
+	Status Close();
+
+private:
+
+	VecOperator  *probe;
+	VecOperator  *build;
+	int           probeCol;
+	int           buildCol;
+	VecHashTable *table;
+	ColumnBatch   probeBatch;
+	Bool          probeDone;
+	int           probePos;   // next selected row of probeBatch
+	int          *buckets;    // of the selected rows of probeBatch
+	int           probeRow;   // the row before probePos, and its key
+	int           probeKey;
+	int           tablePos;   // next row of its bucket
+	int           tableEnd;
+	int          *matchProbe; // the pairs of rows of a batch of the result
+	int          *matchBuild;
+};
+
+
+// Group the rows of an operator on one column, and count them and sum
+// another for each group.  Run opens, reads and closes child.
+class VecHashAggregate {
+
+public:
+
+	VecHashAggregate(VecOperator *child, int groupCol, int sumCol);
+	~VecHashAggregate();
+
+	Status Run();
+
+	int  GetNumOfGroups() { return numOfGroups; }
+	int  GetGroup(int i)  { return groups[i]; }
+	long GetCount(int i)  { return counts[i]; }
+	long GetSum(int i)    { return sums[i]; }
+
+private:
+
+	void Grow();
+
+	VecOperator *child;
+	int          groupCol;
+	int          sumCol;
+	int          numOfGroups;
+	int         *groups;     // in the order they were first seen
+	long        *counts;
+	long        *sums;
+	int         *slots;      // open addressing: index into groups, or -1
+	unsigned int mask;       // number of slots - 1
+};
+
+#endif
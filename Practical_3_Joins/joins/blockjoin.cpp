@@ -9,6 +9,9 @@
 #include "../include/join.h"
 #include "../include/relation.h"
 #include "../include/bufmgr.h"
+#include "../include/bloom.h"
+#include "../include/keymatch.h"
+#include "../include/operator.h"
 
 //---------------------------------------------------------------
 // Each join method takes in at least two parameters :
@@ -25,7 +28,7 @@
 // that you "new"ed.  This includes any Scan/BTreeFileScan that 
 // you have opened.
 //---------------------------------------------------------------
-HeapFile* BlockNestedLoopJoin(JoinSpec specOfR, JoinSpec specOfS, int B, long& pinRequests, long& pinMisses, double& duration)
+HeapFile* BlockNestedLoopJoin(JoinSpec specOfR, JoinSpec specOfS, int B, long& pinRequests, long& pinMisses, double& duration, BloomFilter *filter)
 {
 
         clock_t begin = clock();
@@ -54,15 +57,31 @@ HeapFile* BlockNestedLoopJoin(JoinSpec specOfR, JoinSpec specOfS, int B, long& p
         int NumRecord = B / recLenR;//number of records per block
         bool EndofR = false;
 
+	// The join attributes of the block, copied out of its records once,
+	// for MatchKeys to compare each record of S with, and the positions
+	// in the block of the records that match it.
+	KeyArray keysR(NumRecord);
+	int * matches = new int[NumRecord > 0 ? NumRecord : 1];
+
         while(!EndofR){
-	char * recRBlock = new char [B];
-                for (int i = 0; i < NumRecord; i++){
-                        if (OK != scanR->GetNext(ridR, recRBlock + i*recLenR, recLenR)){
+		// Records of R that filter rules out are not kept in the
+		// block, which then holds more of those that can match.
+		int numInBlock = 0;
+                while (numInBlock < NumRecord){
+                        if (OK != scanR->GetNext(ridR, recRBlock + numInBlock*recLenR, recLenR)){
                                 EndofR = true;
 		
                                 break;
                         }
+			if (filter == NULL || filter->MayContain(*(int*)&recRBlock[numInBlock*recLenR+specOfR.offset]))
+				numInBlock++;
 		}
+		if (numInBlock == 0)
+			break;
+
+		int * keys = keysR.GetKeys();
+		for (int i = 0; i < numInBlock; i++)
+			keys[i] = *(int*)&recRBlock[i*recLenR+specOfR.offset];
 
         Scan * scanS = specOfS.file->OpenScan(status);
     	if (status != OK){
@@ -71,22 +90,21 @@ HeapFile* BlockNestedLoopJoin(JoinSpec specOfR, JoinSpec specOfS, int B, long& p
         }
 		while(OK == scanS->GetNext(ridS, recS, recLenS)){
                         int * joinAttrS = (int*)&recS[specOfS.offset]; // relation of employees
-                        for (int j = 0; j < B; j += recLenR){
-
-                                int * joinAttrR = (int*)&recRBlock[j+specOfR.offset];
-                                if (*joinAttrS == *joinAttrR){
-                                	MakeNewRecord(recNew, recRBlock+j, recS, recLenR, recLenS);
-                                        T->InsertRecord(recNew, recLenNew, ridNew);
-                                }
+			int numOfMatches = MatchKeys(keys, numInBlock, *joinAttrS, matches);
+                        for (int m = 0; m < numOfMatches; m++){
+                                MakeNewRecord(recNew, recRBlock+matches[m]*recLenR, recS, recLenR, recLenS);
+                                T->InsertRecord(recNew, recLenNew, ridNew);
                         }
                 }
-
+		delete scanS;
 
         }
-        delete recR;
-        delete recS;
-        delete recNew;
-        delete recRBlock;	
+        delete scanR;
+        delete [] recR;
+        delete [] recS;
+        delete [] recNew;
+        delete [] recRBlock;
+        delete [] matches;
 
 	MINIBASE_BM->GetStat(pinRequests,pinMisses);
 
@@ -95,3 +113,148 @@ HeapFile* BlockNestedLoopJoin(JoinSpec specOfR, JoinSpec specOfS, int B, long& p
 	return T;
 }
 
+
+//--------------------------------------------------------------------
+// BlockNestedLoopJoinOp
+//
+// The join of a block of records of outer with the records of inner
+// is given out a batch at a time: the keys of the block are compared
+// with a record of inner by MatchKeys all at once, and matchPos is the
+// next of the records of the block that matched the record of inner
+// before innerPos.
+//--------------------------------------------------------------------
+
+BlockNestedLoopJoinOp::BlockNestedLoopJoinOp(Operator *outer, int offsetOuter, Operator *inner, int offsetInner, int B)
+	: outerBatch(outer->GetRecLen()), innerBatch(inner->GetRecLen())
+{
+	this->outer = outer;
+	this->inner = inner;
+	this->offsetOuter = offsetOuter;
+	this->offsetInner = offsetInner;
+	recLen = outer->GetRecLen() + inner->GetRecLen();
+
+	blockSize = B / outer->GetRecLen();
+	if (blockSize < 1)
+		blockSize = 1;
+	block = new char[blockSize * outer->GetRecLen()];
+	keys = new KeyArray(blockSize);
+	matches = new int[blockSize];
+	innerOpen = FALSE;
+}
+
+
+BlockNestedLoopJoinOp::~BlockNestedLoopJoinOp()
+{
+	delete [] block;
+	delete keys;
+	delete [] matches;
+	delete outer;
+	delete inner;
+}
+
+
+Status BlockNestedLoopJoinOp::Open()
+{
+	outerBatch.Clear();
+	outerPos = 0;
+	outerDone = FALSE;
+	numInBlock = 0;
+	numOfMatches = matchPos = 0;
+	innerBatch.Clear();
+	innerPos = 0;
+	return outer->Open();
+}
+
+
+//--------------------------------------------------------------------
+// BlockNestedLoopJoinOp::FillBlock
+//
+// Purpose  : read the next block of records of outer, and open inner
+//            to be joined with it.
+// Return   : OK if there is at least one record in the block, DONE if
+//            outer has none left, FAIL on error.
+//--------------------------------------------------------------------
+
+Status BlockNestedLoopJoinOp::FillBlock()
+{
+	int recLenOuter = outer->GetRecLen();
+
+	numInBlock = 0;
+	while (numInBlock < blockSize)
+	{
+		if (outerPos == outerBatch.GetNumOfRecords())
+		{
+			if (outerDone || outer->Next(outerBatch) != OK)
+			{
+				outerBatch.Clear();
+				outerPos = 0;
+				outerDone = TRUE;
+				break;
+			}
+			outerPos = 0;
+		}
+		memcpy(block + numInBlock*recLenOuter, outerBatch.Record(outerPos++), recLenOuter);
+		numInBlock++;
+	}
+	if (numInBlock == 0)
+		return DONE;
+
+	int *keysOuter = keys->GetKeys();
+	for (int i = 0; i < numInBlock; i++)
+		memcpy(&keysOuter[i], block + i*recLenOuter + offsetOuter, sizeof(int));
+
+	innerBatch.Clear();
+	innerPos = 0;
+	numOfMatches = matchPos = 0;
+	if (inner->Open() != OK)
+		return FAIL;
+	innerOpen = TRUE;
+	return OK;
+}
+
+
+Status BlockNestedLoopJoinOp::Next(RecordBatch& batch)
+{
+	int recLenOuter = outer->GetRecLen();
+	int recLenInner = inner->GetRecLen();
+
+	batch.Clear();
+	while (!batch.IsFull())
+	{
+		if (!innerOpen && FillBlock() != OK)
+			break;
+
+		if (matchPos < numOfMatches)
+		{
+			MakeNewRecord(batch.Append(), block + matches[matchPos++]*recLenOuter,
+			              innerBatch.Record(innerPos - 1), recLenOuter, recLenInner);
+			continue;
+		}
+
+		if (innerPos == innerBatch.GetNumOfRecords())
+		{
+			if (inner->Next(innerBatch) != OK)
+			{
+				inner->Close();
+				innerOpen = FALSE;
+				continue;
+			}
+			innerPos = 0;
+		}
+
+		int key;
+		memcpy(&key, innerBatch.Record(innerPos++) + offsetInner, sizeof(int));
+		numOfMatches = MatchKeys(keys->GetKeys(), numInBlock, key, matches);
+		matchPos = 0;
+	}
+	return (batch.GetNumOfRecords() > 0) ? OK : DONE;
+}
+
+
+Status BlockNestedLoopJoinOp::Close()
+{
+	if (innerOpen)
+		inner->Close();
+	innerOpen = FALSE;
+	return outer->Close();
+}
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/minirel.h"
+#include "../include/heapfile.h"
+#include "../include/scan.h"
+#include "../include/join.h"
+#include "../include/inthash.h"
+#include "../include/bloom.h"
+
+#define BLOOM_WORDS_PER_BLOCK (int)(BLOOM_BLOCK_SIZE / sizeof(unsigned int))
+#define BLOOM_BITS_PER_BLOCK  (BLOOM_BLOCK_SIZE * 8)
+
+
+BloomFilter::BloomFilter(int numOfKeys)
+{
+	long bits = (long)(numOfKeys > 0 ? numOfKeys : 1) * BLOOM_BITS_PER_KEY;
+
+	numOfBlocks = (bits + BLOOM_BITS_PER_BLOCK - 1) / BLOOM_BITS_PER_BLOCK;
+	mem = new char[(numOfBlocks + 1) * BLOOM_BLOCK_SIZE];
+	blocks = (unsigned int *)(((size_t)mem + BLOOM_BLOCK_SIZE - 1)
+	                          & ~(size_t)(BLOOM_BLOCK_SIZE - 1));
+	memset(blocks, 0, numOfBlocks * BLOOM_BLOCK_SIZE);
+
+	numOfLookups = 0;
+	numOfPasses = 0;
+}
+
+
+BloomFilter::~BloomFilter()
+{
+	delete [] mem;
+}
+
+
+//--------------------------------------------------------------------
+// The bits of a key are those of a block picked by the hash of the
+// key, and, within it, BLOOM_NUM_OF_HASHES bits a + i*b apart, where a
+// and b come from a second hash: double hashing, which is as good as
+// that many hashes.
+//--------------------------------------------------------------------
+
+void BloomFilter::Add(int key)
+{
+	unsigned int hash = HashInt(key);
+	unsigned int *block = blocks + (hash % numOfBlocks) * BLOOM_WORDS_PER_BLOCK;
+	unsigned int second = HashInt(hash);
+	unsigned int a = second & 0xffff;
+	unsigned int b = (second >> 16) | 1;
+
+	for (int i = 0; i < BLOOM_NUM_OF_HASHES; i++)
+	{
+		unsigned int bit = (a + i*b) % BLOOM_BITS_PER_BLOCK;
+		block[bit / 32] |= 1u << (bit % 32);
+	}
+}
+
+
+Bool BloomFilter::MayContain(int key)
+{
+	unsigned int hash = HashInt(key);
+	unsigned int *block = blocks + (hash % numOfBlocks) * BLOOM_WORDS_PER_BLOCK;
+	unsigned int second = HashInt(hash);
+	unsigned int a = second & 0xffff;
+	unsigned int b = (second >> 16) | 1;
+
+	numOfLookups++;
+	for (int i = 0; i < BLOOM_NUM_OF_HASHES; i++)
+	{
+		unsigned int bit = (a + i*b) % BLOOM_BITS_PER_BLOCK;
+		if ((block[bit / 32] & (1u << (bit % 32))) == 0)
+			return FALSE;
+	}
+	numOfPasses++;
+	return TRUE;
+}
+
+
+//--------------------------------------------------------------------
+// BuildBloomFilter
+//
+// Purpose  : build a BloomFilter on the join attribute of every record
+//            of a relation, in one scan of it.
+// Input    : spec - the relation, usually the inner one of a join.
+// Return   : the new filter, NULL on error.
+//--------------------------------------------------------------------
+
+BloomFilter *BuildBloomFilter(JoinSpec spec)
+{
+	Status s;
+	Scan *scan = spec.file->OpenScan(s);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot open scan on " << spec.relName << ".\n";
+		return NULL;
+	}
+
+	BloomFilter *filter = new BloomFilter(spec.file->GetNumOfRecords());
+	char *rec = new char[spec.recLen];
+	int recLen = spec.recLen;
+	RecordID rid;
+	int key;
+
+	while (scan->GetNext(rid, rec, recLen) == OK)
+	{
+		memcpy(&key, rec + spec.offset, sizeof(int));
+		filter->Add(key);
+	}
+
+	delete scan;
+	delete [] rec;
+	return filter;
+}
@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/minirel.h"
+#include "../include/bufmgr.h"
+#include "../include/btfile.h"
+#include "../include/btfilescan.h"
+
+//
+// Batched lookups.  Rather than descending from the root once per key,
+// SearchBatch sorts the keys and walks the leaves once, left to right,
+// with a single scan, so that neighbouring keys share the descent and
+// the pins of their leaves.  A key far to the right of the scan is
+// reached by a new descent instead of by reading every leaf in between.
+//
+
+// Entries a batched search skips over before it descends again.  About
+// the number of int entries of a leaf.
+#define BTREE_BATCH_SKIP 64
+
+
+// A key of the batch and its position in the caller's array.
+struct BatchKey
+{
+	int key;
+	int pos;
+};
+
+static int CompareBatchKey(const void *a, const void *b)
+{
+	const BatchKey *x = (const BatchKey *)a;
+	const BatchKey *y = (const BatchKey *)b;
+
+	if (x->key != y->key)
+		return (x->key < y->key) ? -1 : 1;
+	return x->pos - y->pos;
+}
+
+
+//------------------------------------------------------------------
+// BTreeFile::SearchBatch
+//
+// Input    : numOfKeys int keys, in any order, maybe repeated
+// Output   : matches - a new[]ed array of the record ids found; those
+//                      of keys[i] are matches[matchStart[i]] up to
+//                      matches[matchStart[i+1] - 1], in index order
+//            matchStart - numOfKeys + 1 offsets into matches,
+//                         allocated by the caller
+// Purpose  : Look up all the keys with one pass over the leaves.
+// Return   : OK if successful, FAIL otherwise.  The tree must have
+//            int keys.
+//------------------------------------------------------------------
+
+Status BTreeFile::SearchBatch(int numOfKeys, const int *keys, int *matchStart,
+			      RecordID *&matches)
+{
+	if (header->keyType != attrInteger)
+	{
+		cerr << "BTreeFile::SearchBatch - The keys are not integers" << endl;
+		return FAIL;
+	}
+
+	matchStart[0] = 0;
+	matches = NULL;
+	if (numOfKeys == 0)
+		return OK;
+
+	BatchKey *sorted = new BatchKey[numOfKeys];
+	for (int i = 0; i < numOfKeys; i++)
+	{
+		sorted[i].key = keys[i];
+		sorted[i].pos = i;
+	}
+	qsort(sorted, numOfKeys, sizeof(BatchKey), CompareBatchKey);
+
+	// The record ids found for the distinct keys, one run after the
+	// other, and the run of each key of the batch.
+
+	int size = numOfKeys;
+	RecordID *found = new RecordID[size];
+	int numOfFound = 0;
+	int *runFirst = new int[numOfKeys];
+	int *runLen = new int[numOfKeys];
+
+	int hi = sorted[numOfKeys - 1].key;
+	BTreeFileScan *scan = (BTreeFileScan *)OpenScan(&sorted[0].key, &hi);
+	RecordID rid;
+	int key;
+	Bool valid = (scan->GetNext(rid, &key) == OK);
+
+	for (int i = 0; i < numOfKeys; )
+	{
+		int k = sorted[i].key;
+		int skipped = 0;
+		int first = numOfFound;
+
+		while (valid && key < k)
+		{
+			if (++skipped == BTREE_BATCH_SKIP)
+			{
+				delete scan;
+				scan = (BTreeFileScan *)OpenScan(&k, &hi);
+			}
+			valid = (scan->GetNext(rid, &key) == OK);
+		}
+
+		while (valid && key == k)
+		{
+			if (numOfFound == size)
+			{
+				RecordID *bigger = new RecordID[2*size];
+				memcpy(bigger, found, size*sizeof(RecordID));
+				delete [] found;
+				found = bigger;
+				size *= 2;
+			}
+			found[numOfFound++] = rid;
+			valid = (scan->GetNext(rid, &key) == OK);
+		}
+
+		for ( ; i < numOfKeys && sorted[i].key == k; i++)
+		{
+			runFirst[sorted[i].pos] = first;
+			runLen[sorted[i].pos] = numOfFound - first;
+		}
+	}
+	delete scan;
+
+	// Lay the runs out in the order of the keys of the caller.
+
+	for (int i = 0; i < numOfKeys; i++)
+		matchStart[i + 1] = matchStart[i] + runLen[i];
+	matches = new RecordID[matchStart[numOfKeys] > 0 ? matchStart[numOfKeys] : 1];
+	for (int i = 0; i < numOfKeys; i++)
+		memcpy(&matches[matchStart[i]], &found[runFirst[i]], runLen[i]*sizeof(RecordID));
+
+	delete [] sorted;
+	delete [] found;
+	delete [] runFirst;
+	delete [] runLen;
+	return OK;
+}
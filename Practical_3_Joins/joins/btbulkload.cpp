@@ -0,0 +1,281 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/minirel.h"
+#include "../include/bufmgr.h"
+#include "../include/heappage.h"
+#include "../include/btfile.h"
+
+//
+// Bottom-up construction of a BTreeFile from sorted <key, rid> pairs.
+// The leaves are filled left to right and chained as they are made,
+// then each level of index pages is built over the level below, until
+// a single page -- the root -- is left.  Nothing is ever searched or
+// split on the way.
+//
+// The separators of string keys are truncated to the shortest prefix
+// that still tells the two leaves apart, so that index pages hold more
+// entries and the tree is flatter.  The leaves keep the keys in full.
+//
+
+// Room an entry takes in a page besides its <key, data> bytes.
+static const int SLOT_SIZE = 2*sizeof(short);
+
+
+//------------------------------------------------------------------
+// PageIsFull
+//
+// Input    : a page being filled, the length of the next entry, the
+//            fraction of the page that may be used
+// Return   : TRUE if the entry should go to a new page.  An empty page
+//            is never full.
+//------------------------------------------------------------------
+
+static Bool PageIsFull (SortedPage *page, int entryLen, float fillFactor)
+{
+	int used = HEAPPAGE_DATA_SIZE - page->AvailableSpace();
+
+	if (page->GetNumOfRecords() == 0)
+		return FALSE;
+
+	return (page->AvailableSpace() < entryLen + SLOT_SIZE
+		|| used + entryLen + SLOT_SIZE > fillFactor * HEAPPAGE_DATA_SIZE);
+}
+
+
+//------------------------------------------------------------------
+// AddPage
+//
+// Input    : the pages of a level made so far, with their separators,
+//            and a new page of that level
+// Purpose  : Append the page to the arrays, growing them as needed.
+//            key may be NULL for a page that has no entry yet.
+//------------------------------------------------------------------
+
+static void AddPage (PageID *&pids, KeyType *&seps, int& numOfPages, int& size,
+		     PageID pid, const void *key, AttrType keyType)
+{
+	if (numOfPages == size)
+	{
+		int newSize = (size == 0) ? 16 : 2*size;
+		PageID *newPids = new PageID[newSize];
+		KeyType *newSeps = new KeyType[newSize];
+
+		memcpy(newPids, pids, numOfPages*sizeof(PageID));
+		memcpy(newSeps, seps, numOfPages*sizeof(KeyType));
+		delete [] pids;
+		delete [] seps;
+		pids = newPids;
+		seps = newSeps;
+		size = newSize;
+	}
+
+	pids[numOfPages] = pid;
+	if (key != NULL)
+		memcpy(&seps[numOfPages], key, GetKeyLength(key, keyType));
+	numOfPages++;
+}
+
+
+//------------------------------------------------------------------
+// Separator
+//
+// Input    : the last key of a leaf and the first key of the next one
+// Output   : the key to separate them with in the index: the shortest
+//            prefix of right greater than left for string keys, right
+//            itself otherwise (and when the two keys are equal)
+//------------------------------------------------------------------
+
+static void Separator (const void *left, const void *right, AttrType keyType,
+		       KeyType *sep)
+{
+	memcpy(sep, right, GetKeyLength(right, keyType));
+	if (keyType != attrString)
+		return;
+
+	const char *l = (const char *)left;
+	char *s = sep->charKey;
+	int i = 0;
+
+	while (l[i] != '\0' && l[i] == s[i])
+		i++;
+	if (s[i] != '\0')
+		s[i + 1] = '\0';
+}
+
+
+//------------------------------------------------------------------
+// BTreeFile::_BulkLoadLeaves
+//
+// Input    : source of the pairs, fill factor
+// Output   : the leaves made, in key order, with their separators
+// Purpose  : Fill and chain the leaves with the pairs of the source.
+//            At least one (maybe empty) leaf is made.  The key of each
+//            leaf but the first is its separator from the leaf before.
+// Return   : OK if successful, FAIL if the pairs are not sorted or on
+//            error
+//------------------------------------------------------------------
+
+Status BTreeFile::_BulkLoadLeaves (BTreeLoadSource *source, float fillFactor,
+				  PageID *&pids, KeyType *&seps, int& numOfPages)
+{
+	AttrType keyType = header->keyType;
+	BTLeafPage *leaf, *next;
+	PageID pid, nextPid;
+	KeyType key, lastKey, sep;
+	RecordID dataRid, rid;
+	int size = 0;
+	int numOfEntries = 0;
+	Status s;
+
+	numOfPages = 0;
+	NEWPAGE(pid, leaf);
+	leaf->Init(pid);
+	leaf->SetType(LEAF_NODE);
+	AddPage(pids, seps, numOfPages, size, pid, NULL, keyType);
+
+	while ((s = source->GetNext(dataRid, &key)) == OK)
+	{
+		int len = GetKeyDataLength(&key, keyType, LEAF_NODE);
+
+		if (numOfEntries > 0 && KeyCmp(&key, &lastKey, keyType) < 0)
+		{
+			cerr << "BTreeFile::BulkLoad - The keys are not sorted" << endl;
+			UNPIN(pid, DIRTY);
+			return FAIL;
+		}
+
+		if (PageIsFull(leaf, len, fillFactor)
+			|| leaf->Insert(&key, keyType, dataRid, rid) != OK)
+		{
+			NEWPAGE(nextPid, next);
+			next->Init(nextPid);
+			next->SetType(LEAF_NODE);
+			next->SetPrevPage(pid);
+			leaf->SetNextPage(nextPid);
+			UNPIN(pid, DIRTY);
+
+			pid = nextPid;
+			leaf = next;
+			Separator(&lastKey, &key, keyType, &sep);
+			AddPage(pids, seps, numOfPages, size, pid, &sep, keyType);
+
+			if (leaf->Insert(&key, keyType, dataRid, rid) != OK)
+			{
+				cerr << "BTreeFile::BulkLoad - Unable to insert into leaf " << pid << endl;
+				UNPIN(pid, DIRTY);
+				return FAIL;
+			}
+		}
+		else if (numOfEntries == 0)
+			memcpy(&seps[0], &key, GetKeyLength(&key, keyType));
+
+		memcpy(&lastKey, &key, GetKeyLength(&key, keyType));
+		numOfEntries++;
+	}
+
+	UNPIN(pid, DIRTY);
+	return (s == DONE) ? OK : FAIL;
+}
+
+
+//------------------------------------------------------------------
+// BTreeFile::_BulkLoadIndex
+//
+// Input    : the pages of a level, in key order, with their separators
+// Output   : the pages of the level above, replacing them
+// Purpose  : Build one level of index pages.  The first child of an
+//            index page is its left link, and the separator of every
+//            other child is its key.  The separator of the first child
+//            goes up to the level above.  The last child is always
+//            put on the page before it if it fits, so that no index
+//            page is left with a left link alone.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status BTreeFile::_BulkLoadIndex (float fillFactor, PageID *&pids, KeyType *&seps,
+				  int& numOfPages)
+{
+	AttrType keyType = header->keyType;
+	BTIndexPage *page = NULL;
+	PageID pid;
+	PageID *parentPids = NULL;
+	KeyType *parentSeps = NULL;
+	int numOfParents = 0;
+	int size = 0;
+	RecordID rid;
+
+	for (int i = 0; i < numOfPages; i++)
+	{
+		int len = GetKeyDataLength(&seps[i], keyType, INDEX_NODE);
+		float fill = (i == numOfPages - 1) ? 1.0 : fillFactor;
+
+		if (page != NULL)
+		{
+			if (!PageIsFull(page, len, fill)
+				&& page->Insert(&seps[i], keyType, pids[i], rid) == OK)
+				continue;
+			UNPIN(pid, DIRTY);
+		}
+
+		NEWPAGE(pid, page);
+		page->Init(pid);
+		page->SetType(INDEX_NODE);
+		page->SetLeftLink(pids[i]);
+		AddPage(parentPids, parentSeps, numOfParents, size, pid, &seps[i], keyType);
+	}
+	UNPIN(pid, DIRTY);
+
+	delete [] pids;
+	delete [] seps;
+	pids = parentPids;
+	seps = parentSeps;
+	numOfPages = numOfParents;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// BTreeFile::BulkLoad
+//
+// Input    : source - <key, rid> pairs in ascending key order
+//            fillFactor - fraction of each page to fill, in (0, 1].
+//                         Leave room in the pages if the tree is to
+//                         be inserted into afterwards.
+// Purpose  : Build the tree bottom-up from the pairs, which is much
+//            cheaper than inserting them one by one: every page is
+//            pinned once while it is filled and never split.
+// Condition: The tree must be empty.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status BTreeFile::BulkLoad (BTreeLoadSource *source, float fillFactor)
+{
+	PageID *pids = NULL;
+	KeyType *seps = NULL;
+	int numOfPages;
+	Status s;
+
+	if (fillFactor <= 0 || fillFactor > 1)
+	{
+		cerr << "BTreeFile::BulkLoad - Invalid fill factor " << fillFactor << endl;
+		return FAIL;
+	}
+	if (header->root != INVALID_PAGE)
+	{
+		cerr << "BTreeFile::BulkLoad - The tree is not empty" << endl;
+		return FAIL;
+	}
+
+	s = _BulkLoadLeaves(source, fillFactor, pids, seps, numOfPages);
+	while (s == OK && numOfPages > 1)
+		s = _BulkLoadIndex(fillFactor, pids, seps, numOfPages);
+
+	if (s == OK)
+		s = UpdateHeader(pids[0]);
+
+	delete [] pids;
+	delete [] seps;
+	return s;
+}
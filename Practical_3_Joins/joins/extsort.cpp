@@ -0,0 +1,526 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/minirel.h"
+#include "../include/heapfile.h"
+#include "../include/scan.h"
+#include "../include/bufmgr.h"
+#include "../include/join.h"
+#include "../include/relation.h"
+#include "../include/extsort.h"
+
+//
+// External merge sort of a HeapFile on an int attribute.
+//
+// Runs are made by replacement selection: a heap of as many records as
+// the memory holds gives out the smallest one that can still extend
+// the current run, and takes in the next record of the input in its
+// place.  On random input the runs are about twice as long as the
+// memory.  Each run is written to a temporary HeapFile, whose scan
+// gives the records back in the order they were inserted.
+//
+// The runs are then merged, as many at a time as there are pages for
+// their scans, with a loser tree: a tree of the losers of the matches
+// between the current records of the runs, so that after a record is
+// given out only the matches on the path from its run to the root are
+// played again.  Runs are merged into longer runs until few enough
+// are left to be merged at once, and that last merge is read by
+// ExternalSortScan::GetNext.
+//
+
+
+//--------------------------------------------------------------------
+// The temporary HeapFiles of the sorted runs, in the order they were
+// made.
+//--------------------------------------------------------------------
+
+struct RunList
+{
+	HeapFile **runs;
+	int        numOfRuns;
+	int        size;
+};
+
+static void AddRun(RunList& list, HeapFile *run)
+{
+	if (list.numOfRuns == list.size)
+	{
+		HeapFile **runs = new HeapFile *[2 * list.size];
+
+		memcpy(runs, list.runs, list.numOfRuns * sizeof(HeapFile *));
+		delete [] list.runs;
+		list.runs = runs;
+		list.size *= 2;
+	}
+	list.runs[list.numOfRuns++] = run;
+}
+
+
+//--------------------------------------------------------------------
+// The memory of replacement selection: the records, and a heap of
+// their slots ordered by run, then key.
+//--------------------------------------------------------------------
+
+struct SelectionHeap
+{
+	char *recs;
+	int  *keys;
+	int  *runOf;
+	int  *heap;
+	int   numOfSlots;
+	int   recLen;
+};
+
+static Bool HeapLess(SelectionHeap& h, int a, int b)
+{
+	if (h.runOf[a] != h.runOf[b])
+		return h.runOf[a] < h.runOf[b];
+	return h.keys[a] < h.keys[b];
+}
+
+static void SiftDown(SelectionHeap& h, int n, int i)
+{
+	int slot = h.heap[i];
+
+	for (;;)
+	{
+		int child = 2*i + 1;
+		if (child >= n)
+			break;
+		if (child + 1 < n && HeapLess(h, h.heap[child + 1], h.heap[child]))
+			child++;
+		if (!HeapLess(h, h.heap[child], slot))
+			break;
+		h.heap[i] = h.heap[child];
+		i = child;
+	}
+	h.heap[i] = slot;
+}
+
+
+//--------------------------------------------------------------------
+// MakeRuns
+//
+// Purpose  : write the records of S to sorted runs by replacement
+//            selection.
+// Input    : S - the file to sort, len - length of its records,
+//            offset - offset of the int attribute to sort on,
+//            numOfRecs - number of records the memory holds.
+// Output   : list - the runs made.
+// Return   : OK if successful, FAIL otherwise.
+//--------------------------------------------------------------------
+
+static Status MakeRuns(HeapFile *S, int len, int offset, int numOfRecs, RunList& list)
+{
+	Status s;
+	Scan *scan = S->OpenScan(s);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot open scan on the heapfile to sort.\n";
+		return FAIL;
+	}
+
+	SelectionHeap h;
+	h.recLen = len;
+	h.numOfSlots = numOfRecs;
+	h.recs = new char[numOfRecs * len];
+	h.keys = new int[numOfRecs];
+	h.runOf = new int[numOfRecs];
+	h.heap = new int[numOfRecs];
+
+	RecordID rid;
+	int recLen = len;
+	int n = 0;
+
+	while (n < numOfRecs && scan->GetNext(rid, h.recs + n*len, recLen) == OK)
+	{
+		memcpy(&h.keys[n], h.recs + n*len + offset, sizeof(int));
+		h.runOf[n] = 0;
+		h.heap[n] = n;
+		n++;
+	}
+	for (int i = n/2 - 1; i >= 0; i--)
+		SiftDown(h, n, i);
+
+	HeapFile *run = NULL;
+	int currRun = -1;
+
+	while (n > 0 && s == OK)
+	{
+		int slot = h.heap[0];
+		char *rec = h.recs + slot*len;
+
+		if (h.runOf[slot] != currRun)
+		{
+			run = new HeapFile(NULL, s);
+			if (s != OK)
+			{
+				cerr << "ERROR : cannot create a file for a sorted run.\n";
+				delete run;
+				break;
+			}
+			AddRun(list, run);
+			currRun = h.runOf[slot];
+		}
+
+		int lastKey = h.keys[slot];
+		run->InsertRecord(rec, len, rid);
+
+		// The next record of the input takes the place of the one
+		// given out, in this run if it does not come before it.
+
+		if (scan->GetNext(rid, rec, recLen) == OK)
+		{
+			memcpy(&h.keys[slot], rec + offset, sizeof(int));
+			h.runOf[slot] = (h.keys[slot] >= lastKey) ? currRun : currRun + 1;
+		}
+		else
+			h.heap[0] = h.heap[--n];
+		SiftDown(h, n, 0);
+	}
+	delete scan;
+
+	delete [] h.recs;
+	delete [] h.keys;
+	delete [] h.runOf;
+	delete [] h.heap;
+	return s;
+}
+
+
+//--------------------------------------------------------------------
+// The runs being merged, with the current record of each, and the
+// loser tree over them.  given is the run whose record was given out
+// last, which is read on from before the next one is, or -1.  tree[0] is the run whose record is the
+// smallest; tree[i], for 0 < i < k, is the run that lost the match at
+// node i, whose children are nodes 2i and 2i + 1 -- or, from k on,
+// the runs themselves: run r is leaf k + r.
+//--------------------------------------------------------------------
+
+struct MergeInput
+{
+	Scan *scan;
+	char *rec;
+	int   key;
+	Bool  done;
+};
+
+struct LoserTree
+{
+	MergeInput *inputs;
+	int        *tree;
+	int         k;
+	int         given;
+	int         len;
+	int         offset;
+};
+
+
+// Whether run a gives out its record before run b.  The run k, which
+// does not exist, beats every run, so that the tree can be filled from
+// its leaves; a run that is done loses to every run still going; and
+// ties go to the earlier run, which keeps the sort stable.
+
+static Bool Beats(LoserTree& lt, int a, int b)
+{
+	if (a == lt.k || b == lt.k)
+		return a == lt.k;
+	if (lt.inputs[a].done || lt.inputs[b].done)
+		return !lt.inputs[a].done && (lt.inputs[b].done || a < b);
+	if (lt.inputs[a].key != lt.inputs[b].key)
+		return lt.inputs[a].key < lt.inputs[b].key;
+	return a < b;
+}
+
+// Replay the matches on the path from run r to the root.
+
+static void Replay(LoserTree& lt, int r)
+{
+	int winner = r;
+
+	for (int node = (r + lt.k) / 2; node > 0; node /= 2)
+	{
+		if (Beats(lt, lt.tree[node], winner))
+		{
+			int loser = winner;
+			winner = lt.tree[node];
+			lt.tree[node] = loser;
+		}
+	}
+	lt.tree[0] = winner;
+}
+
+
+static void NextRecord(MergeInput& in, int len, int offset)
+{
+	RecordID rid;
+	int recLen = len;
+
+	in.done = (in.scan->GetNext(rid, in.rec, recLen) != OK);
+	if (!in.done)
+		memcpy(&in.key, in.rec + offset, sizeof(int));
+}
+
+
+//--------------------------------------------------------------------
+// OpenMerge
+//
+// Purpose  : open the scans of k sorted runs and play the matches
+//            between their first records.
+// Input    : runs - the k runs, len - length of their records,
+//            offset - offset of the int attribute they are sorted on.
+// Output   : lt - the merge.
+// Return   : OK if successful, FAIL otherwise.
+//--------------------------------------------------------------------
+
+static Status OpenMerge(LoserTree& lt, HeapFile **runs, int k, int len, int offset)
+{
+	Status s = OK;
+
+	lt.k = k;
+	lt.given = -1;
+	lt.len = len;
+	lt.offset = offset;
+	lt.inputs = new MergeInput[k];
+	lt.tree = new int[k > 1 ? k : 2];
+
+	for (int r = 0; r < k; r++)
+	{
+		lt.inputs[r].rec = new char[len];
+		lt.inputs[r].scan = runs[r]->OpenScan(s);
+		if (s != OK)
+		{
+			cerr << "ERROR : cannot open scan on a sorted run.\n";
+			lt.inputs[r].scan = NULL;
+			lt.inputs[r].done = TRUE;
+		}
+		else
+			NextRecord(lt.inputs[r], len, offset);
+	}
+
+	// With no runs at all, as for an empty relation, no match is played
+	// and the winner is left at k, the merge done from the start.
+
+	lt.tree[0] = k;
+	for (int node = 0; node < k; node++)
+		lt.tree[node] = k;
+	for (int r = k - 1; r >= 0; r--)
+		Replay(lt, r);
+	return s;
+}
+
+
+//--------------------------------------------------------------------
+// MergeNext
+//
+// Purpose  : give out the smallest record left of a merge.
+// Output   : recPtr - the record, good until the next call; key - its
+//            key.
+// Return   : FALSE if every run is done.
+//--------------------------------------------------------------------
+
+static Bool MergeNext(LoserTree& lt, char *&recPtr, int& key)
+{
+	if (lt.given >= 0)
+	{
+		NextRecord(lt.inputs[lt.given], lt.len, lt.offset);
+		Replay(lt, lt.given);
+	}
+
+	int r = lt.tree[0];
+	if (r == lt.k || lt.inputs[r].done)
+		return FALSE;
+
+	lt.given = r;
+	recPtr = lt.inputs[r].rec;
+	key = lt.inputs[r].key;
+	return TRUE;
+}
+
+
+static void CloseMerge(LoserTree& lt)
+{
+	for (int r = 0; r < lt.k; r++)
+	{
+		delete lt.inputs[r].scan;
+		delete [] lt.inputs[r].rec;
+	}
+	delete [] lt.inputs;
+	delete [] lt.tree;
+}
+
+
+//--------------------------------------------------------------------
+// MergeRuns
+//
+// Purpose  : merge k sorted runs into one.
+// Return   : the new run, NULL on error.
+//--------------------------------------------------------------------
+
+static HeapFile *MergeRuns(HeapFile **runs, int k, int len, int offset)
+{
+	Status s;
+	HeapFile *merged = new HeapFile(NULL, s);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot create a file for a merged run.\n";
+		delete merged;
+		return NULL;
+	}
+
+	LoserTree lt;
+	s = OpenMerge(lt, runs, k, len, offset);
+
+	RecordID rid;
+	char *rec;
+	int key;
+	while (s == OK && MergeNext(lt, rec, key))
+		merged->InsertRecord(rec, len, rid);
+
+	CloseMerge(lt);
+	if (s != OK)
+	{
+		delete merged;
+		return NULL;
+	}
+	return merged;
+}
+
+
+//--------------------------------------------------------------------
+// ExternalSortScan::ExternalSortScan
+//
+// Purpose  : make the sorted runs of S and merge them until the rest
+//            can be merged at once, then start that merge.
+// Input    : S - the relation/HeapFile to be sorted.
+//            len - length of the records of S (fixed size).
+//            offset - offset of the attribute from the beginning of
+//                     the record.
+//            numOfPages - memory of the sort, in pages.  Runs are made
+//                         in all of it but the pages of the scan of S
+//                         and of the output, and merged as many at a
+//                         time as there is room for the scans of, but
+//                         for the pages of the output, twice over:
+//                         inserting into a HeapFile looks through its
+//                         directory pages.
+// Output   : status - OK if successful, FAIL otherwise.
+//--------------------------------------------------------------------
+
+ExternalSortScan::ExternalSortScan(HeapFile *S, int len, int offset, int numOfPages, Status& status)
+{
+	if (numOfPages <= 0)
+		numOfPages = MINIBASE_BM->GetNumOfBuffers() / 2;
+	if (numOfPages < 4*SORT_SCAN_PAGES)
+		numOfPages = 4*SORT_SCAN_PAGES;
+
+	int numOfRecs = (numOfPages - 2*SORT_SCAN_PAGES) * (MINIBASE_PAGESIZE / len);
+	if (numOfRecs < 1)
+		numOfRecs = 1;
+	int fanIn = (numOfPages - 2*SORT_SCAN_PAGES) / SORT_SCAN_PAGES;
+
+	runs = new RunList;
+	runs->size = 16;
+	runs->numOfRuns = 0;
+	runs->runs = new HeapFile *[runs->size];
+	merge = NULL;
+
+	status = MakeRuns(S, len, offset, numOfRecs, *runs);
+
+	// Merge the oldest runs first, so that every record is merged
+	// about as many times as every other one.
+
+	int first = 0;
+	while (status == OK && runs->numOfRuns - first > fanIn)
+	{
+		HeapFile *merged = MergeRuns(runs->runs + first, fanIn, len, offset);
+		for (int r = first; r < first + fanIn; r++)
+			delete runs->runs[r];
+		first += fanIn;
+
+		if (merged == NULL)
+			status = FAIL;
+		else
+			AddRun(*runs, merged);
+	}
+
+	// Keep only the runs of the last merge.
+
+	for (int r = 0; r < runs->numOfRuns - first; r++)
+		runs->runs[r] = runs->runs[first + r];
+	runs->numOfRuns -= first;
+
+	if (status == OK)
+	{
+		merge = new LoserTree;
+		status = OpenMerge(*merge, runs->runs, runs->numOfRuns, len, offset);
+	}
+}
+
+
+ExternalSortScan::~ExternalSortScan()
+{
+	if (merge != NULL)
+	{
+		CloseMerge(*merge);
+		delete merge;
+	}
+	for (int r = 0; r < runs->numOfRuns; r++)
+		delete runs->runs[r];
+	delete [] runs->runs;
+	delete runs;
+}
+
+
+Status ExternalSortScan::GetNext(char *&recPtr, int& key)
+{
+	if (merge == NULL || !MergeNext(*merge, recPtr, key))
+		return DONE;
+	return OK;
+}
+
+
+//--------------------------------------------------------------------
+// ExternalSort
+//
+// Purpose  : sort a relation on an integer attribute, with a bounded
+//            amount of memory.
+// Input    : S - pointer to the relation/HeapFile to be sorted.
+//            len - length of the records of S (fixed size).
+//            offset - offset of the attribute from the beginning of
+//                     the record.
+//            numOfPages - memory of the sort, in pages, at least
+//                         4*SORT_SCAN_PAGES; 0 for half the buffer
+//                         pool.  See ExternalSortScan.
+// Return   : the new sorted relation/HeapFile, a temporary file; NULL
+//            on error.
+//--------------------------------------------------------------------
+
+HeapFile *ExternalSort(HeapFile *S, int len, int offset, int numOfPages)
+{
+	Status s;
+	ExternalSortScan *scan = new ExternalSortScan(S, len, offset, numOfPages, s);
+	if (s != OK)
+	{
+		delete scan;
+		return NULL;
+	}
+
+	HeapFile *sorted = new HeapFile(NULL, s);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot create a file for the sorted relation.\n";
+		delete sorted;
+		delete scan;
+		return NULL;
+	}
+
+	RecordID rid;
+	char *rec;
+	int key;
+	while (scan->GetNext(rec, key) == OK)
+		sorted->InsertRecord(rec, len, rid);
+
+	delete scan;
+	return sorted;
+}
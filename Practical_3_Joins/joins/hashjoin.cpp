@@ -0,0 +1,658 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../include/minirel.h"
+#include "../include/heapfile.h"
+#include "../include/scan.h"
+#include "../include/join.h"
+#include "../include/inthash.h"
+#include "../include/relation.h"
+#include "../include/bufmgr.h"
+#include "../include/bloom.h"
+#include "../include/operator.h"
+
+//---------------------------------------------------------------
+// Each join method takes in at least two parameters :
+// - specOfS
+// - specOfR
+//
+// They specify which relations we are going to join, which
+// attributes we are going to join on, the offsets of the
+// attributes etc.  specOfS specifies the inner relation while
+// specOfR specifies the outer one.
+//
+//You can use MakeNewRecord() to create the new result record.
+//
+// Remember to clean up before exiting by "delete"ing any pointers
+// that you "new"ed.  This includes any Scan/BTreeFileScan that
+// you have opened.
+//---------------------------------------------------------------
+
+
+// Frames the scans and inserts of a join keep pinned for themselves.
+#define HASH_JOIN_RESERVED_FRAMES 4
+
+// Times a partition is partitioned again before it is joined in memory
+// whatever its size: past that, its keys are too few to be split.
+#define HASH_JOIN_MAX_DEPTH 4
+
+
+//--------------------------------------------------------------------
+// Records held in memory with their join attribute, in the order they
+// were added.
+//--------------------------------------------------------------------
+
+struct RecordBuffer
+{
+	char *recs;
+	int  *keys;
+	int   numOfRecs;
+	int   size;
+	int   recLen;
+};
+
+static void InitBuffer(RecordBuffer& buf, int recLen, int size)
+{
+	buf.size = (size > 0) ? size : 1;
+	buf.recLen = recLen;
+	buf.numOfRecs = 0;
+	buf.recs = new char[buf.size * recLen];
+	buf.keys = new int[buf.size];
+}
+
+static void AddToBuffer(RecordBuffer& buf, const char *rec, int key)
+{
+	if (buf.numOfRecs == buf.size)
+	{
+		char *recs = new char[2 * buf.size * buf.recLen];
+		int *keys = new int[2 * buf.size];
+
+		memcpy(recs, buf.recs, buf.numOfRecs * buf.recLen);
+		memcpy(keys, buf.keys, buf.numOfRecs * sizeof(int));
+		delete [] buf.recs;
+		delete [] buf.keys;
+		buf.recs = recs;
+		buf.keys = keys;
+		buf.size *= 2;
+	}
+	memcpy(buf.recs + buf.numOfRecs * buf.recLen, rec, buf.recLen);
+	buf.keys[buf.numOfRecs++] = key;
+}
+
+static void FreeBuffer(RecordBuffer& buf)
+{
+	delete [] buf.recs;
+	delete [] buf.keys;
+}
+
+
+//--------------------------------------------------------------------
+// The records of the build relation in memory, grouped by bucket: the
+// records of bucket b are recs[start[b]] up to recs[start[b+1] - 1],
+// and keys[i] is the join attribute of recs[i].  A probe reads the keys
+// of its bucket one after the other, from one array, and only touches
+// the records that match.
+//--------------------------------------------------------------------
+
+struct JoinHashTable
+{
+	unsigned int mask;  // number of buckets - 1
+	int         *start;
+	int         *keys;
+	char        *recs;
+	int          recLen;
+};
+
+
+//--------------------------------------------------------------------
+// BuildTable
+//
+// Purpose  : place the records of a buffer into a JoinHashTable, with
+//            about one bucket per record.
+// Input    : buf - the records to build on.
+// Output   : table - the new table; FreeTable() frees it.
+//--------------------------------------------------------------------
+
+static void BuildTable(RecordBuffer& buf, JoinHashTable& table)
+{
+	int numOfRecs = buf.numOfRecs;
+	int recLen = buf.recLen;
+	int numOfBuckets = 1;
+	while (numOfBuckets < numOfRecs)
+		numOfBuckets *= 2;
+
+	table.mask = numOfBuckets - 1;
+	table.recLen = recLen;
+	table.start = new int[numOfBuckets + 1];
+	table.keys = new int[numOfRecs > 0 ? numOfRecs : 1];
+	table.recs = new char[(numOfRecs > 0 ? numOfRecs : 1) * recLen];
+
+	memset(table.start, 0, (numOfBuckets + 1)*sizeof(int));
+	for (int i = 0; i < numOfRecs; i++)
+		table.start[(HashInt(buf.keys[i]) & table.mask) + 1]++;
+	for (int b = 0; b < numOfBuckets; b++)
+		table.start[b + 1] += table.start[b];
+
+	// start[b] is the next free place of bucket b while the records
+	// are placed, and ends up where bucket b + 1 begins.
+
+	for (int i = 0; i < numOfRecs; i++)
+	{
+		int pos = table.start[HashInt(buf.keys[i]) & table.mask]++;
+		table.keys[pos] = buf.keys[i];
+		memcpy(table.recs + pos*recLen, buf.recs + i*recLen, recLen);
+	}
+	for (int b = numOfBuckets; b > 0; b--)
+		table.start[b] = table.start[b - 1];
+	table.start[0] = 0;
+}
+
+
+static void FreeTable(JoinHashTable& table)
+{
+	delete [] table.start;
+	delete [] table.keys;
+	delete [] table.recs;
+}
+
+
+//--------------------------------------------------------------------
+// Where the result records of a hash join go, which relation the
+// records of its table come from, and the filter, if any, that the
+// records of R must pass.
+//--------------------------------------------------------------------
+
+struct JoinOutput
+{
+	HeapFile    *T;
+	Bool         buildOnR;
+	BloomFilter *filter;
+	int       recLenR;
+	int       recLenS;
+	char     *recNew;
+};
+
+
+//--------------------------------------------------------------------
+// ProbeTable
+//
+// Purpose  : join a record with the records of the table that have
+//            the same key, and insert the results into out.T.
+// Input    : table - the table of the build relation.
+//            recProbe - a record of the other relation, and key its
+//                       join attribute.
+//--------------------------------------------------------------------
+
+static void ProbeTable(JoinHashTable& table, char *recProbe, int key, JoinOutput& out)
+{
+	RecordID ridNew;
+	unsigned int b = HashInt(key) & table.mask;
+
+	for (int i = table.start[b]; i < table.start[b+1]; i++)
+	{
+		if (table.keys[i] != key)
+			continue;
+
+		char *recBuild = table.recs + i*table.recLen;
+		if (out.buildOnR)
+			MakeNewRecord(out.recNew, recBuild, recProbe, out.recLenR, out.recLenS);
+		else
+			MakeNewRecord(out.recNew, recProbe, recBuild, out.recLenR, out.recLenS);
+		out.T->InsertRecord(out.recNew, out.recLenR + out.recLenS, ridNew);
+	}
+}
+
+
+//--------------------------------------------------------------------
+// JoinInMemory
+//
+// Purpose  : read the build relation into a JoinHashTable, then scan
+//            the probe relation once and probe the table with each of
+//            its records.
+// Input    : specOfBuild, specOfProbe - the two relations.
+//            out - where the results go.
+// Return   : OK if successful, FAIL otherwise.
+//--------------------------------------------------------------------
+
+static Status JoinInMemory(JoinSpec specOfBuild, JoinSpec specOfProbe, JoinOutput& out)
+{
+	Status s;
+	RecordBuffer buf;
+	JoinHashTable table;
+	RecordID rid;
+	int key;
+
+	Scan *scan = specOfBuild.file->OpenScan(s);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot open scan on " << specOfBuild.relName << ".\n";
+		return FAIL;
+	}
+
+	int recLen = specOfBuild.recLen;
+	char *rec = new char[recLen];
+
+	InitBuffer(buf, recLen, specOfBuild.file->GetNumOfRecords());
+	while (scan->GetNext(rid, rec, recLen) == OK)
+	{
+		memcpy(&key, rec + specOfBuild.offset, sizeof(int));
+		if (out.buildOnR && out.filter != NULL && !out.filter->MayContain(key))
+			continue;
+		AddToBuffer(buf, rec, key);
+	}
+	delete scan;
+	delete [] rec;
+
+	BuildTable(buf, table);
+	FreeBuffer(buf);
+
+	scan = specOfProbe.file->OpenScan(s);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot open scan on " << specOfProbe.relName << ".\n";
+		FreeTable(table);
+		return FAIL;
+	}
+
+	recLen = specOfProbe.recLen;
+	rec = new char[recLen];
+	while (scan->GetNext(rid, rec, recLen) == OK)
+	{
+		memcpy(&key, rec + specOfProbe.offset, sizeof(int));
+		if (!out.buildOnR && out.filter != NULL && !out.filter->MayContain(key))
+			continue;
+		ProbeTable(table, rec, key, out);
+	}
+	delete scan;
+	delete [] rec;
+
+	FreeTable(table);
+	return OK;
+}
+
+
+//--------------------------------------------------------------------
+// HashJoin
+//
+// Purpose  : join R and S by building a hash table in memory on the
+//            relation with fewer records, then scanning the other one
+//            once and looking up each of its records in the table.
+//            The result records are R then S, whichever is built on.
+//            Records of R that filter rules out are neither put in the
+//            table nor looked up in it.
+//--------------------------------------------------------------------
+
+HeapFile* HashJoin(JoinSpec specOfR, JoinSpec specOfS, long& pinRequests, long& pinMisses, double& duration, BloomFilter *filter)
+{
+	clock_t begin = clock();
+	Status status = OK;
+	HeapFile* T = new HeapFile(NULL,status);
+	if (status != OK){
+		cerr << "ERROR: cannot create a file for the joined relations.\n";
+		return NULL;
+	}
+
+	JoinOutput out;
+	out.T = T;
+	out.buildOnR = specOfR.file->GetNumOfRecords() < specOfS.file->GetNumOfRecords();
+	out.filter = filter;
+	out.recLenR = specOfR.recLen;
+	out.recLenS = specOfS.recLen;
+	out.recNew = new char[specOfR.recLen + specOfS.recLen];
+
+	if (out.buildOnR)
+		status = JoinInMemory(specOfR, specOfS, out);
+	else
+		status = JoinInMemory(specOfS, specOfR, out);
+	delete [] out.recNew;
+	if (status != OK){
+		cerr << "ERROR: cannot join " << specOfR.relName << " and " << specOfS.relName << ".\n";
+		delete T;
+		return NULL;
+	}
+
+	MINIBASE_BM->GetStat(pinRequests,pinMisses);
+
+	clock_t end = clock();
+	duration = float(end - begin)/CLOCKS_PER_SEC;
+	return T;
+}
+
+
+//--------------------------------------------------------------------
+// FreeFrames
+//
+// Return   : the number of frames a hybrid hash join may fill with
+//            its hash table.  GetNumOfUnpinnedFrames() of the buffer
+//            manager in lib/ always answers 0, so when it does, every
+//            frame is counted but those the join pins itself.
+//--------------------------------------------------------------------
+
+static int FreeFrames()
+{
+	int frames = MINIBASE_BM->GetNumOfUnpinnedFrames();
+
+	if (frames == 0)
+		frames = MINIBASE_BM->GetNumOfBuffers() - HASH_JOIN_RESERVED_FRAMES;
+	return (frames > 4) ? frames : 4;
+}
+
+
+//--------------------------------------------------------------------
+// PartitionOf
+//
+// Return   : the partition of a key, among numOfParts, at a depth of
+//            partitioning.  Each depth hashes the hash of the key again
+//            with a different salt, so that a partition that is too
+//            big is split on bits that did not decide it, and that
+//            none of them is the bucket of the key in a JoinHashTable.
+//--------------------------------------------------------------------
+
+static int PartitionOf(int key, int depth, int numOfParts)
+{
+	return HashInt(HashInt(key) + depth + 1) % numOfParts;
+}
+
+
+//--------------------------------------------------------------------
+// HybridJoin
+//
+// Purpose  : join two relations, or two partitions of them, within
+//            the free frames of the buffer pool.  If the build side
+//            fits, it is joined in memory.  Else both sides are split
+//            into partitions by the hash of the join attribute: the
+//            first partitions of the build side stay in memory, as
+//            many as fit beside a frame or two for each other one, and
+//            are joined while the probe side is partitioned; the other
+//            partitions are written to temporary HeapFiles and joined
+//            pair by pair afterwards, partitioned again if they are
+//            still too big (as under skew).
+// Input    : specOfBuild, specOfProbe - the two relations.
+//            depth - how many times they have been partitioned.
+//            out - where the results go.
+// Return   : OK if successful, FAIL otherwise.
+//--------------------------------------------------------------------
+
+static Status HybridJoin(JoinSpec specOfBuild, JoinSpec specOfProbe, int depth, JoinOutput& out)
+{
+	int frames = FreeFrames();
+	int numOfRecs = specOfBuild.file->GetNumOfRecords();
+	int buildPages = (numOfRecs * specOfBuild.recLen + MINIBASE_PAGESIZE - 1) / MINIBASE_PAGESIZE;
+
+	if (buildPages <= frames || depth == HASH_JOIN_MAX_DEPTH)
+		return JoinInMemory(specOfBuild, specOfProbe, out);
+
+	// Partitions of about half the frames leave room for skew.  Each
+	// one written out keeps its directory and last page in the pool.
+
+	int partPages = frames / 2;
+	int numOfParts = (buildPages + partPages - 1) / partPages;
+	if (numOfParts < 2)
+		numOfParts = 2;
+	partPages = (buildPages + numOfParts - 1) / numOfParts;
+
+	int numOfResident = 0;
+	if (partPages > 2)
+		numOfResident = (frames - 2*numOfParts) / (partPages - 2);
+	if (numOfResident < 0)
+		numOfResident = 0;
+	if (numOfResident > numOfParts - 1)
+		numOfResident = numOfParts - 1;
+
+	Status s = OK;
+	HeapFile **buildParts = new HeapFile *[numOfParts];
+	HeapFile **probeParts = new HeapFile *[numOfParts];
+	for (int p = 0; p < numOfParts; p++)
+	{
+		buildParts[p] = probeParts[p] = NULL;
+		if (p >= numOfResident && s == OK)
+			buildParts[p] = new HeapFile(NULL, s);
+		if (p >= numOfResident && s == OK)
+			probeParts[p] = new HeapFile(NULL, s);
+	}
+
+	RecordBuffer resident;
+	JoinHashTable table;
+	Scan *scan;
+	RecordID rid, ridPart;
+	int key;
+	int recLen;
+	char *rec;
+
+	// Partition the build side, keeping the resident partitions.
+
+	if (s == OK)
+		scan = specOfBuild.file->OpenScan(s);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot partition " << specOfBuild.relName << ".\n";
+		for (int p = 0; p < numOfParts; p++)
+		{
+			delete buildParts[p];
+			delete probeParts[p];
+		}
+		delete [] buildParts;
+		delete [] probeParts;
+		return FAIL;
+	}
+
+	recLen = specOfBuild.recLen;
+	rec = new char[recLen];
+	InitBuffer(resident, recLen, numOfResident * partPages * (MINIBASE_PAGESIZE / recLen));
+	while (scan->GetNext(rid, rec, recLen) == OK)
+	{
+		memcpy(&key, rec + specOfBuild.offset, sizeof(int));
+		int p = PartitionOf(key, depth, numOfParts);
+		if (p < numOfResident)
+			AddToBuffer(resident, rec, key);
+		else
+			buildParts[p]->InsertRecord(rec, recLen, ridPart);
+	}
+	delete scan;
+	delete [] rec;
+
+	BuildTable(resident, table);
+	FreeBuffer(resident);
+
+	// Partition the probe side, joining the resident partitions.
+
+	scan = specOfProbe.file->OpenScan(s);
+	if (s == OK)
+	{
+		recLen = specOfProbe.recLen;
+		rec = new char[recLen];
+		while (scan->GetNext(rid, rec, recLen) == OK)
+		{
+			memcpy(&key, rec + specOfProbe.offset, sizeof(int));
+			int p = PartitionOf(key, depth, numOfParts);
+			if (p < numOfResident)
+				ProbeTable(table, rec, key, out);
+			else
+				probeParts[p]->InsertRecord(rec, recLen, ridPart);
+		}
+		delete scan;
+		delete [] rec;
+	}
+	else
+		cerr << "ERROR : cannot partition " << specOfProbe.relName << ".\n";
+	FreeTable(table);
+
+	// Join the partitions written out, pair by pair.
+
+	for (int p = numOfResident; p < numOfParts; p++)
+	{
+		if (s == OK && buildParts[p]->GetNumOfRecords() > 0
+			&& probeParts[p]->GetNumOfRecords() > 0)
+		{
+			JoinSpec buildPart = specOfBuild;
+			JoinSpec probePart = specOfProbe;
+			buildPart.file = buildParts[p];
+			probePart.file = probeParts[p];
+			s = HybridJoin(buildPart, probePart, depth + 1, out);
+		}
+		delete buildParts[p];
+		delete probeParts[p];
+	}
+	delete [] buildParts;
+	delete [] probeParts;
+	return s;
+}
+
+
+//--------------------------------------------------------------------
+// HybridHashJoin
+//
+// Purpose  : join R and S like HashJoin, but within the buffer pool:
+//            the relation with fewer records is built on, and both are
+//            partitioned to temporary HeapFiles when it does not fit
+//            in the free frames.
+//--------------------------------------------------------------------
+
+HeapFile* HybridHashJoin(JoinSpec specOfR, JoinSpec specOfS, long& pinRequests, long& pinMisses, double& duration)
+{
+	clock_t begin = clock();
+	Status status = OK;
+	HeapFile* T = new HeapFile(NULL,status);
+	if (status != OK){
+		cerr << "ERROR: cannot create a file for the joined relations.\n";
+		return NULL;
+	}
+
+	JoinOutput out;
+	out.T = T;
+	out.buildOnR = specOfR.file->GetNumOfRecords() < specOfS.file->GetNumOfRecords();
+	out.filter = NULL;
+	out.recLenR = specOfR.recLen;
+	out.recLenS = specOfS.recLen;
+	out.recNew = new char[specOfR.recLen + specOfS.recLen];
+
+	if (out.buildOnR)
+		status = HybridJoin(specOfR, specOfS, 0, out);
+	else
+		status = HybridJoin(specOfS, specOfR, 0, out);
+	delete [] out.recNew;
+	if (status != OK){
+		cerr << "ERROR: cannot join " << specOfR.relName << " and " << specOfS.relName << ".\n";
+		delete T;
+		return NULL;
+	}
+
+	MINIBASE_BM->GetStat(pinRequests,pinMisses);
+
+	clock_t end = clock();
+	duration = float(end - begin)/CLOCKS_PER_SEC;
+	return T;
+}
+
+
+//--------------------------------------------------------------------
+// HashJoinOp
+//
+// tablePos is the next record of the bucket of the record of outer at
+// outerPos that is still to be compared with it, and tableEnd the end
+// of that bucket, so that a bucket can be carried over from one batch
+// to the next.
+//--------------------------------------------------------------------
+
+HashJoinOp::HashJoinOp(Operator *outer, int offsetOuter, Operator *inner, int offsetInner)
+	: outerBatch(outer->GetRecLen())
+{
+	this->outer = outer;
+	this->inner = inner;
+	this->offsetOuter = offsetOuter;
+	this->offsetInner = offsetInner;
+	recLen = outer->GetRecLen() + inner->GetRecLen();
+	table = NULL;
+}
+
+
+HashJoinOp::~HashJoinOp()
+{
+	Close();
+	delete outer;
+	delete inner;
+}
+
+
+Status HashJoinOp::Open()
+{
+	if (inner->Open() != OK)
+		return FAIL;
+
+	int recLenInner = inner->GetRecLen();
+	RecordBatch in(recLenInner);
+	RecordBuffer buf;
+	int key;
+
+	InitBuffer(buf, recLenInner, OP_BATCH_SIZE);
+	while (inner->Next(in) == OK)
+	{
+		for (int i = 0; i < in.GetNumOfRecords(); i++)
+		{
+			memcpy(&key, in.Record(i) + offsetInner, sizeof(int));
+			AddToBuffer(buf, in.Record(i), key);
+		}
+	}
+	inner->Close();
+
+	table = new JoinHashTable;
+	BuildTable(buf, *table);
+	FreeBuffer(buf);
+
+	outerBatch.Clear();
+	outerPos = 0;
+	outerDone = FALSE;
+	tablePos = tableEnd = 0;
+	return outer->Open();
+}
+
+
+Status HashJoinOp::Next(RecordBatch& batch)
+{
+	int recLenOuter = outer->GetRecLen();
+
+	batch.Clear();
+	while (!batch.IsFull())
+	{
+		if (tablePos < tableEnd)
+		{
+			int i = tablePos++;
+			if (table->keys[i] == key)
+				MakeNewRecord(batch.Append(), outerBatch.Record(outerPos - 1),
+				              table->recs + i*table->recLen, recLenOuter, table->recLen);
+			continue;
+		}
+
+		if (outerPos == outerBatch.GetNumOfRecords())
+		{
+			if (outerDone || table == NULL || outer->Next(outerBatch) != OK)
+			{
+				outerBatch.Clear();
+				outerPos = 0;
+				outerDone = TRUE;
+				break;
+			}
+			outerPos = 0;
+		}
+
+		memcpy(&key, outerBatch.Record(outerPos++) + offsetOuter, sizeof(int));
+		unsigned int b = HashInt(key) & table->mask;
+		tablePos = table->start[b];
+		tableEnd = table->start[b+1];
+	}
+	return (batch.GetNumOfRecords() > 0) ? OK : DONE;
+}
+
+
+Status HashJoinOp::Close()
+{
+	if (table == NULL)
+		return OK;
+
+	FreeTable(*table);
+	delete table;
+	table = NULL;
+	return outer->Close();
+}
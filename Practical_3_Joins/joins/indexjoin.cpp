@@ -11,7 +11,8 @@
 #include "../include/btfilescan.h"
 #include "../include/relation.h"
 #include "../include/bufmgr.h"
-
+#include "../include/bloom.h"
+#include "../include/operator.h"
 
 
 //---------------------------------------------------------------
@@ -32,7 +33,7 @@
 //---------------------------------------------------------------
 
 
-HeapFile* IndexNestedLoopJoin(JoinSpec specOfR, JoinSpec specOfS, long& pinRequests, long& pinMisses, double& duration)
+HeapFile* IndexNestedLoopJoin(JoinSpec specOfR, JoinSpec specOfS, long& pinRequests, long& pinMisses, double& duration, BloomFilter *filter)
 {
 
         clock_t begin = clock();
@@ -53,47 +54,60 @@ HeapFile* IndexNestedLoopJoin(JoinSpec specOfR, JoinSpec specOfS, long& pinReque
         int recLenS = specOfS.recLen;
         int recLenNew = specOfR.recLen + specOfS.recLen;
 
-        RecordID ridR,ridS,ridNew;
+        RecordID ridR,ridNew;
 
-        char * recR = new char[recLenR];
         char * recS = new char[recLenS];
         char * recNew = new char[recLenNew];
        
 
 
-        Scan * scanS = specOfS.file->OpenScan(status);
-    	if (status != OK){
-                cerr << "ERROR: cannot create a file for S relation.\n";
-                return NULL;
-        }
-
-	
 	BTreeFile *btree;
-	btree = new BTreeFile (status, "BTree", ATTR_INT, sizeof(int));
-	while(OK == scanS->GetNext(ridS, recS, recLenS)){
-		btree->Insert(recS + specOfS.offset, ridS);            
+	btree = BuildIndex(specOfS.file, recLenS, specOfS.offset, "BTree");
+	if (btree == NULL){
+                cerr << "ERROR: cannot build an index on S relation.\n";
+                return NULL;
         }
-	delete scanS;
 
 
 
-	while(OK == scanR->GetNext(ridR, recR, recLenR)){
-		int * joinAttrR = (int*)&recR[specOfR.offset]; 
-		BTreeFileScan  *btreeScan;
-		btreeScan = (BTreeFileScan *)btree->OpenScan(joinAttrR, joinAttrR);
-
-
-		int key;
-
-		while (btreeScan->GetNext(ridS, &key) == OK)
-		{
-	    		specOfS.file->GetRecord (ridS, recS, recLenS);
-			MakeNewRecord(recNew, recR, recS, recLenR, recLenS);
-	   		T->InsertRecord (recNew, recLenNew, ridNew);
-	}
-delete btreeScan;
-
-}
+	//
+	// Probe the index with a batch of records of R at a time, so that
+	// their keys are looked up together in one pass over the leaves.
+	// Records that filter rules out are not looked up at all.
+	//
+
+	char * batchR = new char[INDEX_JOIN_BATCH * recLenR];
+	int * keysR = new int[INDEX_JOIN_BATCH];
+	int * matchStart = new int[INDEX_JOIN_BATCH + 1];
+	RecordID * matches;
+	int numOfR;
+
+	do {
+		for (numOfR = 0; numOfR < INDEX_JOIN_BATCH 
+			&& OK == scanR->GetNext(ridR, batchR + numOfR*recLenR, recLenR); ){
+			memcpy(&keysR[numOfR], batchR + numOfR*recLenR + specOfR.offset, sizeof(int));
+			if (filter == NULL || filter->MayContain(keysR[numOfR]))
+				numOfR++;
+		}
+
+		if (btree->SearchBatch(numOfR, keysR, matchStart, matches) != OK){
+			cerr << "ERROR: cannot probe the index on S relation.\n";
+			break;
+		}
+
+		for (int i = 0; i < numOfR; i++){
+			for (int m = matchStart[i]; m < matchStart[i+1]; m++){
+	    			specOfS.file->GetRecord (matches[m], recS, recLenS);
+				MakeNewRecord(recNew, batchR + i*recLenR, recS, recLenR, recLenS);
+	   			T->InsertRecord (recNew, recLenNew, ridNew);
+			}
+		}
+		delete [] matches;
+	} while (numOfR == INDEX_JOIN_BATCH);
+
+	delete [] batchR;
+	delete [] keysR;
+	delete [] matchStart;
 
 	
 	btree->DestroyFile();
@@ -103,9 +117,8 @@ delete btreeScan;
 	delete scanR;
 
         
-        delete recR;
-        delete recS;
-        delete recNew;
+        delete [] recS;
+        delete [] recNew;
 
 	MINIBASE_BM->GetStat(pinRequests,pinMisses);
 
@@ -114,3 +127,125 @@ delete btreeScan;
 	return T;
 
 }
+
+
+//--------------------------------------------------------------------
+// IndexNestedLoopJoinOp
+//
+// The keys of a batch of records of outer are looked up together by
+// SearchBatch, and their matches given out a batch at a time:
+// matchPos is the next match of the record at outerPos.
+//--------------------------------------------------------------------
+
+IndexNestedLoopJoinOp::IndexNestedLoopJoinOp(Operator *outer, int offsetOuter, JoinSpec inner)
+	: outerBatch(outer->GetRecLen())
+{
+	this->outer = outer;
+	this->offsetOuter = offsetOuter;
+	this->inner = inner;
+	recLen = outer->GetRecLen() + inner.recLen;
+
+	btree = NULL;
+	keys = new int[OP_BATCH_SIZE];
+	matchStart = new int[OP_BATCH_SIZE + 1];
+	matches = NULL;
+	recInner = new char[inner.recLen];
+}
+
+
+IndexNestedLoopJoinOp::~IndexNestedLoopJoinOp()
+{
+	Close();
+	delete [] keys;
+	delete [] matchStart;
+	delete [] recInner;
+	delete outer;
+}
+
+
+Status IndexNestedLoopJoinOp::Open()
+{
+	// Every operator has an index of its own, in case two of them are
+	// open at once.
+	static int numOfIndexes = 0;
+	char name[32];
+	sprintf(name, "IndexJoinOp%d", numOfIndexes++);
+
+	btree = BuildIndex(inner.file, inner.recLen, inner.offset, name);
+	if (btree == NULL)
+	{
+		cerr << "ERROR: cannot build an index on " << inner.relName << ".\n";
+		return FAIL;
+	}
+
+	outerBatch.Clear();
+	outerPos = 0;
+	outerDone = FALSE;
+	matchStart[0] = matchStart[1] = 0;
+	matchPos = 0;
+	return outer->Open();
+}
+
+
+Status IndexNestedLoopJoinOp::Next(RecordBatch& batch)
+{
+	int recLenOuter = outer->GetRecLen();
+	int len = inner.recLen;
+
+	batch.Clear();
+	while (!batch.IsFull())
+	{
+		if (outerPos == outerBatch.GetNumOfRecords())
+		{
+			delete [] matches;
+			matches = NULL;
+			if (outerDone || btree == NULL || outer->Next(outerBatch) != OK)
+			{
+				outerBatch.Clear();
+				outerPos = 0;
+				outerDone = TRUE;
+				break;
+			}
+
+			int n = outerBatch.GetNumOfRecords();
+			for (int i = 0; i < n; i++)
+				memcpy(&keys[i], outerBatch.Record(i) + offsetOuter, sizeof(int));
+			if (btree->SearchBatch(n, keys, matchStart, matches) != OK)
+			{
+				cerr << "ERROR: cannot probe the index on " << inner.relName << ".\n";
+				matches = NULL;
+				outerBatch.Clear();
+				outerPos = 0;
+				outerDone = TRUE;
+				break;
+			}
+			outerPos = 0;
+			matchPos = matchStart[0];
+			continue;
+		}
+
+		if (matchPos == matchStart[outerPos + 1])
+		{
+			outerPos++;
+			continue;
+		}
+
+		inner.file->GetRecord(matches[matchPos++], recInner, len);
+		MakeNewRecord(batch.Append(), outerBatch.Record(outerPos), recInner, recLenOuter, inner.recLen);
+	}
+	return (batch.GetNumOfRecords() > 0) ? OK : DONE;
+}
+
+
+Status IndexNestedLoopJoinOp::Close()
+{
+	delete [] matches;
+	matches = NULL;
+	if (btree == NULL)
+		return OK;
+
+	btree->DestroyFile();
+	delete btree;
+	btree = NULL;
+	return outer->Close();
+}
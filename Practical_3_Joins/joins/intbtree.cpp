@@ -0,0 +1,1296 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+
+#include "../include/minirel.h"
+#include "../include/bufmgr.h"
+#include "../include/db.h"
+#include "../include/heappage.h"
+#include "../include/intbtree.h"
+
+//------------------------------------------------------------------
+// IntNodePage::Init
+//
+// Input    : page id of the page, type of the node, covered bytes of
+//            each entry of a leaf
+// Purpose  : Make an empty node.
+//------------------------------------------------------------------
+
+void IntNodePage::Init(PageID pageNo, NodeType t, int cover)
+{
+	type = t;
+	numOfKeys = 0;
+	coverLen = (t == LEAF_NODE) ? cover : 0;
+	unused = 0;
+	version = 0;
+	pid = pageNo;
+	nextPage = INVALID_PAGE;
+	prevPage = INVALID_PAGE;
+}
+
+
+//------------------------------------------------------------------
+// IntNodePage::LowerBound, IntNodePage::UpperBound
+//
+// Input    : a key
+// Return   : the number of keys of the node less than the key (for
+//            LowerBound) or not greater than it (for UpperBound).
+// Purpose  : Binary search without branches on the comparisons: the
+//            search range is halved every step whatever the outcome,
+//            which only decides (by a conditional move) which half is
+//            kept.  There is nothing for the branch predictor to get
+//            wrong, and the number of steps is the same for every key.
+//------------------------------------------------------------------
+
+int IntNodePage::LowerBound(int key)
+{
+	const int *keys = Keys();
+	const int *base = keys;
+	int n = numOfKeys;
+
+	if (n == 0)
+		return 0;
+
+	while (n > 1)
+	{
+		int half = n / 2;
+		base = (base[half] < key) ? base + half : base;
+		n -= half;
+	}
+	return (base - keys) + (*base < key);
+}
+
+int IntNodePage::UpperBound(int key)
+{
+	const int *keys = Keys();
+	const int *base = keys;
+	int n = numOfKeys;
+
+	if (n == 0)
+		return 0;
+
+	while (n > 1)
+	{
+		int half = n / 2;
+		base = (base[half] <= key) ? base + half : base;
+		n -= half;
+	}
+	return (base - keys) + (*base <= key);
+}
+
+
+//------------------------------------------------------------------
+// IntNodePage::InsertAt
+//
+// Input    : position i, a key and its record id and covered bytes
+//            (leaves; NULL covered bytes are zero) or the child that
+//            follows it (index nodes)
+// Purpose  : Insert the entry at position i, shifting the entries after
+//            it.  The node must not be full.
+//------------------------------------------------------------------
+
+void IntNodePage::InsertAt(int i, int key, RecordID rid, const char *covered)
+{
+	int *keys = Keys();
+	RecordID *rids = Rids();
+
+	memmove(keys + i + 1, keys + i, (numOfKeys - i)*sizeof(int));
+	memmove(rids + i + 1, rids + i, (numOfKeys - i)*sizeof(RecordID));
+	memmove(Covered(i + 1), Covered(i), (numOfKeys - i)*coverLen);
+	keys[i] = key;
+	rids[i] = rid;
+	if (covered != NULL)
+		memcpy(Covered(i), covered, coverLen);
+	else
+		memset(Covered(i), 0, coverLen);
+	numOfKeys++;
+}
+
+void IntNodePage::InsertAt(int i, int key, PageID child)
+{
+	int *keys = Keys();
+	PageID *children = Children();
+
+	memmove(keys + i + 1, keys + i, (numOfKeys - i)*sizeof(int));
+	memmove(children + i + 2, children + i + 1, (numOfKeys - i)*sizeof(PageID));
+	keys[i] = key;
+	children[i + 1] = child;
+	numOfKeys++;
+}
+
+
+//------------------------------------------------------------------
+// IntNodePage::DeleteAt
+//
+// Input    : position of an entry of a leaf
+// Purpose  : Remove the entry, shifting the entries after it.
+//------------------------------------------------------------------
+
+void IntNodePage::DeleteAt(int i)
+{
+	int *keys = Keys();
+	RecordID *rids = Rids();
+
+	memmove(keys + i, keys + i + 1, (numOfKeys - i - 1)*sizeof(int));
+	memmove(rids + i, rids + i + 1, (numOfKeys - i - 1)*sizeof(RecordID));
+	memmove(Covered(i), Covered(i + 1), (numOfKeys - i - 1)*coverLen);
+	numOfKeys--;
+}
+
+
+//------------------------------------------------------------------
+// IntNodePage::MoveHalf
+//
+// Input    : an empty node of the same type
+// Purpose  : Split a full node: move the upper half of its entries to
+//            right.  The middle key of an index node moves up to the
+//            parent, so right gets the keys after it.
+// Return   : the key separating the two nodes in their parent
+//------------------------------------------------------------------
+
+int IntNodePage::MoveHalf(IntNodePage *right)
+{
+	int m = numOfKeys / 2;
+
+	if (type == LEAF_NODE)
+	{
+		right->numOfKeys = numOfKeys - m;
+		memcpy(right->Keys(), Keys() + m, right->numOfKeys*sizeof(int));
+		memcpy(right->Rids(), Rids() + m, right->numOfKeys*sizeof(RecordID));
+		memcpy(right->Covered(0), Covered(m), right->numOfKeys*coverLen);
+		numOfKeys = m;
+		return right->Keys()[0];
+	}
+
+	right->numOfKeys = numOfKeys - m - 1;
+	memcpy(right->Keys(), Keys() + m + 1, right->numOfKeys*sizeof(int));
+	memcpy(right->Children(), Children() + m + 1, (right->numOfKeys + 1)*sizeof(PageID));
+	numOfKeys = m;
+	return Keys()[m];
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::IntBTreeFile
+//
+// Input    : filename - name of the index
+//            coverLen - bytes of each record to keep in the leaves, if
+//                       the index has to be created
+// Output   : status of initialization
+// Purpose  : Open the index if it exists, else create it with an
+//            empty leaf as its root.
+//------------------------------------------------------------------
+
+IntBTreeFile::IntBTreeFile(Status& status, const char *filename, int coverLen)
+{
+	header = NULL;
+	dbname = strcpy(new char[strlen(filename) + 1], filename);
+
+	if (MINIBASE_DB->GetFileEntry(filename, headerID) == OK)
+	{
+		status = LatchedBufMgr::PinPage(headerID, (Page *&)header);
+		if (status != OK)
+		{
+			cerr << "IntBTreeFile::IntBTreeFile - Unable to pin the header\n";
+			header = NULL;
+		}
+		return;
+	}
+
+	IntNodePage *root;
+	PageID rootPid;
+
+	if (coverLen < 0 || coverLen > INTLEAF_MAX_COVER)
+	{
+		cerr << "IntBTreeFile::IntBTreeFile - Cannot cover " << coverLen << " bytes\n";
+		status = FAIL;
+		return;
+	}
+	if (LatchedBufMgr::NewPage(headerID, (Page *&)header) != OK)
+	{
+		cerr << "IntBTreeFile::IntBTreeFile - Unable to allocate the header\n";
+		header = NULL;
+		status = FAIL;
+		return;
+	}
+	header->coverLen = coverLen;
+	header->version = 0;
+	if (NewNode(LEAF_NODE, rootPid, root) != OK
+		|| LatchedBufMgr::UnpinPage(rootPid, DIRTY) != OK)
+	{
+		status = FAIL;
+		return;
+	}
+	header->root = rootPid;
+	header->height = 1;
+
+	status = MINIBASE_DB->AddFileEntry(filename, headerID);
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::~IntBTreeFile
+//
+// Purpose  : Close the index.  The pages stay in the database.
+//------------------------------------------------------------------
+
+IntBTreeFile::~IntBTreeFile()
+{
+	if (header != NULL)
+		LatchedBufMgr::UnpinPage(headerID, DIRTY);
+	delete [] dbname;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::NewNode
+//
+// Input    : type of the node
+// Output   : the new node, pinned, and its page id
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntBTreeFile::NewNode(NodeType t, PageID& pid, IntNodePage *&page)
+{
+	LATCHED_NEWPAGE(pid, page);
+	page->Init(pid, t, header->coverLen);
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// Versions of the nodes, and of the header
+//
+// A version is even while nobody changes what it guards, and odd
+// while the thread that locked it does.  Readers never lock: they read
+// the version, then the node, and check that the version has not moved
+// before they trust what they read, or follow a page id they read to
+// another node; if it has, they start over.  A writer locks a version
+// it has read, so that it only ever locks a node it has seen, as it
+// saw it, and unlocking moves the version to the next even value,
+// which every reader of the old one notices.  No node is freed while
+// the tree is shared, so a page id read from a node of the tree stays
+// a node of the tree.
+//------------------------------------------------------------------
+
+static unsigned int ReadVersion(unsigned int *version)
+{
+	unsigned int v;
+
+	while ((v = __atomic_load_n(version, __ATOMIC_ACQUIRE)) & 1)
+		sched_yield();
+	return v;
+}
+
+static Bool IsVersion(unsigned int *version, unsigned int v)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(version, __ATOMIC_RELAXED) == v;
+}
+
+static Bool LockVersion(unsigned int *version, unsigned int v)
+{
+	return __atomic_compare_exchange_n(version, &v, v + 1, 0,
+	                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static void UnlockVersion(unsigned int *version)
+{
+	__atomic_fetch_add(version, 1, __ATOMIC_RELEASE);
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::FindLeaf
+//
+// Input    : a key
+// Output   : the leftmost leaf that may hold the key
+// Purpose  : The descent of a scan, which has the tree to itself.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntBTreeFile::FindLeaf(int key, PageID& pid)
+{
+	IntNodePage *page;
+	PageID child;
+
+	pid = header->root;
+	for (int level = header->height; level > 1; level--)
+	{
+		LATCHED_PIN(pid, page);
+		child = page->GetChild(key);
+		LATCHED_UNPIN(pid, CLEAN);
+		pid = child;
+	}
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::_FindLeaf
+//
+// Input    : a key
+// Output   : the leftmost leaf that may hold the key, pinned, with the
+//            version it had when its parent still led to it; done is
+//            FALSE, and nothing is pinned, if a node changed on the way
+// Purpose  : Go down the tree as FindLeaf does, among other threads.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntBTreeFile::_FindLeaf(int key, PageID& pid, IntNodePage *&page,
+                               unsigned int& version, Bool& done)
+{
+	IntNodePage *child;
+	PageID childPid;
+	unsigned int headerVersion, childVersion;
+	Bool valid;
+
+	done = FALSE;
+	headerVersion = ReadVersion(&header->version);
+	pid = header->root;
+	if (!IsVersion(&header->version, headerVersion))
+		return OK;
+	LATCHED_PIN(pid, page);
+	version = ReadVersion(page->Version());
+	if (!IsVersion(&header->version, headerVersion))
+	{
+		LATCHED_UNPIN(pid, CLEAN);
+		return OK;
+	}
+
+	while (page->GetType() == INDEX_NODE)
+	{
+		childPid = page->GetChild(key);
+		if (!IsVersion(page->Version(), version))
+		{
+			LATCHED_UNPIN(pid, CLEAN);
+			return OK;
+		}
+		if (LatchedBufMgr::PinPage(childPid, (Page *&)child) != OK)
+		{
+			LatchedBufMgr::UnpinPage(pid, CLEAN);
+			return FAIL;
+		}
+		childVersion = ReadVersion(child->Version());
+		valid = IsVersion(page->Version(), version);
+		LATCHED_UNPIN(pid, CLEAN);
+
+		pid = childPid;
+		page = child;
+		version = childVersion;
+		if (!valid)
+		{
+			LATCHED_UNPIN(pid, CLEAN);
+			return OK;
+		}
+	}
+
+	done = TRUE;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::_Split
+//
+// Input    : a full node and its parent, both locked, and its position
+//            among the children of the parent; a NULL parent for the
+//            root, whose header is locked instead
+// Purpose  : Move the upper half of the node to a new node on its
+//            right, and add that to the parent, or to a new root.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntBTreeFile::_Split(PageID pid, IntNodePage *page, IntNodePage *parent, int i)
+{
+	IntNodePage *right, *next, *root;
+	PageID rightPid, rootPid;
+	int upKey;
+
+	if (NewNode((NodeType)page->GetType(), rightPid, right) != OK)
+		return FAIL;
+	upKey = page->MoveHalf(right);
+
+	// Only splits of its left neighbour, locked here, write the
+	// prevPage of a leaf, and nothing that runs beside them reads it.
+	if (page->GetType() == LEAF_NODE)
+	{
+		right->SetNextPage(page->GetNextPage());
+		right->SetPrevPage(pid);
+		if (page->GetNextPage() != INVALID_PAGE)
+		{
+			LATCHED_PIN(page->GetNextPage(), next);
+			next->SetPrevPage(rightPid);
+			LATCHED_UNPIN(page->GetNextPage(), DIRTY);
+		}
+		page->SetNextPage(rightPid);
+	}
+	LATCHED_UNPIN(rightPid, DIRTY);
+
+	if (parent != NULL)
+	{
+		parent->InsertAt(i, upKey, rightPid);
+		return OK;
+	}
+
+	if (NewNode(INDEX_NODE, rootPid, root) != OK)
+		return FAIL;
+	root->Children()[0] = pid;
+	root->InsertAt(0, upKey, rightPid);
+	LATCHED_UNPIN(rootPid, DIRTY);
+
+	header->root = rootPid;
+	header->height++;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::_Insert
+//
+// Input    : the key, record id and covered bytes to insert
+// Output   : done - FALSE if a node changed on the way, and the insert
+//            has to start over
+// Purpose  : Go down to the leaf of the key without locking anything,
+//            and insert after any equal keys with only the leaf locked.
+//            A full node met on the way is split first, with its parent
+//            locked too, and the insert starts over: since the parent
+//            was not full when it was passed, no split goes further up.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntBTreeFile::_Insert(int key, RecordID rid, const char *covered, Bool& done)
+{
+	IntNodePage *page, *parent = NULL, *child;
+	PageID pid, parentPid = INVALID_PAGE, childPid;
+	unsigned int version, parentVersion, childVersion;
+	unsigned int *parentLock;
+	Bool dirty = CLEAN, parentDirty = CLEAN;
+	int i = 0;
+	Status s = OK;
+
+	done = FALSE;
+	parentVersion = ReadVersion(&header->version);
+	pid = header->root;
+	if (!IsVersion(&header->version, parentVersion))
+		return OK;
+	LATCHED_PIN(pid, page);
+	version = ReadVersion(page->Version());
+	if (!IsVersion(&header->version, parentVersion))
+	{
+		LATCHED_UNPIN(pid, CLEAN);
+		return OK;
+	}
+
+	for (;;)
+	{
+		if (page->IsFull())
+		{
+			parentLock = (parent != NULL) ? parent->Version() : &header->version;
+			if (LockVersion(parentLock, parentVersion))
+			{
+				if (LockVersion(page->Version(), version))
+				{
+					s = _Split(pid, page, parent, i);
+					dirty = parentDirty = DIRTY;
+					UnlockVersion(page->Version());
+				}
+				UnlockVersion(parentLock);
+			}
+			break;
+		}
+
+		if (page->GetType() == LEAF_NODE)
+		{
+			if (LockVersion(page->Version(), version))
+			{
+				page->InsertAt(page->UpperBound(key), key, rid, covered);
+				dirty = DIRTY;
+				UnlockVersion(page->Version());
+				done = TRUE;
+			}
+			break;
+		}
+
+		i = page->UpperBound(key);
+		childPid = page->Children()[i];
+		if (!IsVersion(page->Version(), version))
+			break;
+		if (LatchedBufMgr::PinPage(childPid, (Page *&)child) != OK)
+		{
+			s = FAIL;
+			break;
+		}
+		childVersion = ReadVersion(child->Version());
+		if (!IsVersion(page->Version(), version))
+		{
+			LatchedBufMgr::UnpinPage(childPid, CLEAN);
+			break;
+		}
+
+		if (parent != NULL && LatchedBufMgr::UnpinPage(parentPid, CLEAN) != OK)
+		{
+			parent = NULL;
+			s = FAIL;
+			break;
+		}
+		parent = page;
+		parentPid = pid;
+		parentVersion = version;
+		page = child;
+		pid = childPid;
+		version = childVersion;
+	}
+
+	if (parent != NULL && LatchedBufMgr::UnpinPage(parentPid, parentDirty) != OK)
+		s = FAIL;
+	if (LatchedBufMgr::UnpinPage(pid, dirty) != OK)
+		s = FAIL;
+	return s;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::Insert
+//
+// Input    : pointer to an int key, record id, and the bytes of the
+//            record the tree covers (zero if not given)
+// Purpose  : Insert the entry, over again until no other thread gets
+//            in the way.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntBTreeFile::Insert(const void *key, const RecordID rid)
+{
+	return Insert(key, rid, NULL);
+}
+
+Status IntBTreeFile::Insert(const void *key, const RecordID rid, const char *covered)
+{
+	Bool done = FALSE;
+	Status s = OK;
+	int k;
+
+	memcpy(&k, key, sizeof(int));
+	while (!done && s == OK)
+		s = _Insert(k, rid, covered, done);
+	return s;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::_Delete, IntBTreeFile::Delete
+//
+// Input    : pointer to an int key, record id
+// Output   : done - FALSE if a node changed on the way, and the delete
+//            has to start over
+// Purpose  : Remove the entry from its leaf.  The entries of a key may
+//            go on over several leaves: each is locked before the one
+//            before it is let go, so that no split can put a leaf
+//            between them unseen.  Leaves are not merged, and may
+//            become empty.
+// Return   : OK if successful, DONE if there is no such entry, FAIL
+//            otherwise
+//------------------------------------------------------------------
+
+Status IntBTreeFile::_Delete(int key, RecordID rid, Bool& done)
+{
+	IntNodePage *leaf, *next;
+	PageID pid, nextPid;
+	unsigned int version, nextVersion;
+	Bool dirty = CLEAN;
+	Status s = DONE;
+
+	if (_FindLeaf(key, pid, leaf, version, done) != OK)
+		return FAIL;
+	if (!done)
+		return OK;
+	done = FALSE;
+	if (!LockVersion(leaf->Version(), version))
+	{
+		LATCHED_UNPIN(pid, CLEAN);
+		return OK;
+	}
+
+	while (!done)
+	{
+		for (int i = leaf->LowerBound(key); !done && i < leaf->GetNumOfKeys(); i++)
+		{
+			if (leaf->Keys()[i] != key)
+				done = TRUE;
+			else if (leaf->Rids()[i] == rid)
+			{
+				leaf->DeleteAt(i);
+				dirty = DIRTY;
+				s = OK;
+				done = TRUE;
+			}
+		}
+
+		nextPid = leaf->GetNextPage();
+		if (done || nextPid == INVALID_PAGE)
+		{
+			done = TRUE;
+			break;
+		}
+
+		if (LatchedBufMgr::PinPage(nextPid, (Page *&)next) != OK)
+		{
+			s = FAIL;
+			break;
+		}
+		nextVersion = ReadVersion(next->Version());
+		if (!LockVersion(next->Version(), nextVersion))
+		{
+			LatchedBufMgr::UnpinPage(nextPid, CLEAN);
+			break;
+		}
+		UnlockVersion(leaf->Version());
+		if (LatchedBufMgr::UnpinPage(pid, CLEAN) != OK)
+			s = FAIL;
+		pid = nextPid;
+		leaf = next;
+	}
+
+	UnlockVersion(leaf->Version());
+	if (LatchedBufMgr::UnpinPage(pid, dirty) != OK)
+		s = FAIL;
+	return s;
+}
+
+Status IntBTreeFile::Delete(const void *key, const RecordID rid)
+{
+	Bool done = FALSE;
+	Status s = OK;
+	int k;
+
+	memcpy(&k, key, sizeof(int));
+	while (!done && s != FAIL)
+		s = _Delete(k, rid, done);
+	return s;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::_Search, IntBTreeFile::Search
+//
+// Input    : pointer to an int key
+// Output   : rid - the record id of the first entry of the key
+//            done - FALSE if a node changed on the way, and the search
+//            has to start over
+// Purpose  : Look the key up without locking or writing to any node.
+//            Its first entry may be on a leaf after the one the index
+//            nodes lead to, past leaves of smaller keys only.
+// Return   : OK if successful, DONE if there is no such entry, FAIL
+//            otherwise
+//------------------------------------------------------------------
+
+Status IntBTreeFile::_Search(int key, RecordID& rid, Bool& done)
+{
+	IntNodePage *leaf, *next;
+	PageID pid, nextPid;
+	unsigned int version, nextVersion;
+	Status s = DONE;
+	Bool valid;
+	int i;
+
+	if (_FindLeaf(key, pid, leaf, version, done) != OK)
+		return FAIL;
+	if (!done)
+		return OK;
+	done = FALSE;
+
+	for (;;)
+	{
+		i = leaf->LowerBound(key);
+		if (i < leaf->GetNumOfKeys())
+		{
+			s = (leaf->Keys()[i] == key) ? OK : DONE;
+			rid = leaf->Rids()[i];
+			done = IsVersion(leaf->Version(), version);
+			break;
+		}
+
+		nextPid = leaf->GetNextPage();
+		if (!IsVersion(leaf->Version(), version))
+			break;
+		if (nextPid == INVALID_PAGE)
+		{
+			done = TRUE;
+			break;
+		}
+		if (LatchedBufMgr::PinPage(nextPid, (Page *&)next) != OK)
+		{
+			s = FAIL;
+			break;
+		}
+		nextVersion = ReadVersion(next->Version());
+		valid = IsVersion(leaf->Version(), version);
+		if (LatchedBufMgr::UnpinPage(pid, CLEAN) != OK)
+			s = FAIL;
+		pid = nextPid;
+		leaf = next;
+		version = nextVersion;
+		if (!valid || s == FAIL)
+			break;
+	}
+
+	if (LatchedBufMgr::UnpinPage(pid, CLEAN) != OK)
+		s = FAIL;
+	return s;
+}
+
+Status IntBTreeFile::Search(const void *key, RecordID& rid)
+{
+	Bool done = FALSE;
+	Status s = OK;
+	int k;
+
+	memcpy(&k, key, sizeof(int));
+	while (!done && s != FAIL)
+		s = _Search(k, rid, done);
+	return s;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::_BulkLoadLeaves
+//
+// Input    : source of the pairs, fill factor
+// Output   : the leaves made, in key order, with their first keys
+// Purpose  : Fill and chain the leaves with the pairs of the source.
+//            At least one (maybe empty) leaf is made.
+// Return   : OK if successful, FAIL if the keys are not sorted or on
+//            error
+//------------------------------------------------------------------
+
+Status IntBTreeFile::_BulkLoadLeaves(BTreeLoadSource *source, float fillFactor,
+                                     PageID *&pids, int *&seps, int& numOfPages)
+{
+	IntNodePage *leaf, *next;
+	PageID pid, nextPid;
+	RecordID rid;
+	int limit = (int)(fillFactor * IntNodePage::LeafCapacity(header->coverLen));
+	int size = 16;
+	char *covered = new char[header->coverLen + 1];
+	int key, lastKey = 0;
+	int numOfEntries = 0;
+	Status s;
+
+	if (limit < 1)
+		limit = 1;
+
+	pids = new PageID[size];
+	seps = new int[size];
+	numOfPages = 1;
+	if (NewNode(LEAF_NODE, pid, leaf) != OK)
+		return FAIL;
+	pids[0] = pid;
+	seps[0] = 0;
+
+	while ((s = source->GetNext(rid, &key, covered, header->coverLen)) == OK)
+	{
+		if (numOfEntries > 0 && key < lastKey)
+		{
+			cerr << "IntBTreeFile::BulkLoad - The keys are not sorted" << endl;
+			delete [] covered;
+			LATCHED_UNPIN(pid, DIRTY);
+			return FAIL;
+		}
+
+		if (leaf->GetNumOfKeys() == limit)
+		{
+			if (NewNode(LEAF_NODE, nextPid, next) != OK)
+			{
+				delete [] covered;
+				return FAIL;
+			}
+			next->SetPrevPage(pid);
+			leaf->SetNextPage(nextPid);
+			LATCHED_UNPIN(pid, DIRTY);
+			pid = nextPid;
+			leaf = next;
+
+			if (numOfPages == size)
+			{
+				PageID *newPids = new PageID[2*size];
+				int *newSeps = new int[2*size];
+
+				memcpy(newPids, pids, size*sizeof(PageID));
+				memcpy(newSeps, seps, size*sizeof(int));
+				delete [] pids;
+				delete [] seps;
+				pids = newPids;
+				seps = newSeps;
+				size *= 2;
+			}
+			pids[numOfPages] = pid;
+			seps[numOfPages] = key;
+			numOfPages++;
+		}
+
+		leaf->InsertAt(leaf->GetNumOfKeys(), key, rid, covered);
+		lastKey = key;
+		numOfEntries++;
+	}
+
+	delete [] covered;
+	LATCHED_UNPIN(pid, DIRTY);
+	return (s == DONE) ? OK : FAIL;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::_BulkLoadIndex
+//
+// Input    : the nodes of a level, in key order, with their separators
+// Output   : the nodes of the level above, replacing them
+// Purpose  : Build one level of index nodes.  The last child is put on
+//            the node before it even beyond the fill factor if there is
+//            room, so that no node is left without a key.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntBTreeFile::_BulkLoadIndex(float fillFactor, PageID *&pids, int *&seps,
+                                    int& numOfPages)
+{
+	IntNodePage *page = NULL;
+	PageID pid;
+	PageID *parentPids = new PageID[numOfPages];
+	int *parentSeps = new int[numOfPages];
+	int numOfParents = 0;
+	int limit = (int)(fillFactor * INTINDEX_CAPACITY);
+
+	if (limit < 1)
+		limit = 1;
+
+	for (int i = 0; i < numOfPages; i++)
+	{
+		if (page != NULL)
+		{
+			if (page->GetNumOfKeys() < limit
+				|| (i == numOfPages - 1 && !page->IsFull()))
+			{
+				page->InsertAt(page->GetNumOfKeys(), seps[i], pids[i]);
+				continue;
+			}
+			LATCHED_UNPIN(pid, DIRTY);
+		}
+
+		if (NewNode(INDEX_NODE, pid, page) != OK)
+			return FAIL;
+		page->Children()[0] = pids[i];
+		parentPids[numOfParents] = pid;
+		parentSeps[numOfParents] = seps[i];
+		numOfParents++;
+	}
+	LATCHED_UNPIN(pid, DIRTY);
+
+	delete [] pids;
+	delete [] seps;
+	pids = parentPids;
+	seps = parentSeps;
+	numOfPages = numOfParents;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::BulkLoad
+//
+// Input    : source - <key, rid> pairs in ascending key order
+//            fillFactor - fraction of each node to fill, in (0, 1]
+// Purpose  : Build the tree bottom-up from the pairs, as
+//            BTreeFile::BulkLoad does.
+// Condition: The tree must be empty.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntBTreeFile::BulkLoad(BTreeLoadSource *source, float fillFactor)
+{
+	IntNodePage *root;
+	PageID *pids = NULL;
+	int *seps = NULL;
+	int numOfPages;
+	int height = 1;
+	Status s;
+
+	if (fillFactor <= 0 || fillFactor > 1)
+	{
+		cerr << "IntBTreeFile::BulkLoad - Invalid fill factor " << fillFactor << endl;
+		return FAIL;
+	}
+
+	LATCHED_PIN(header->root, root);
+	if (header->height != 1 || root->GetNumOfKeys() != 0)
+	{
+		LATCHED_UNPIN(header->root, CLEAN);
+		cerr << "IntBTreeFile::BulkLoad - The tree is not empty" << endl;
+		return FAIL;
+	}
+	LATCHED_UNPIN(header->root, CLEAN);
+	LATCHED_FREEPAGE(header->root);
+
+	s = _BulkLoadLeaves(source, fillFactor, pids, seps, numOfPages);
+	while (s == OK && numOfPages > 1)
+	{
+		s = _BulkLoadIndex(fillFactor, pids, seps, numOfPages);
+		height++;
+	}
+
+	if (s == OK)
+	{
+		header->root = pids[0];
+		header->height = height;
+	}
+
+	delete [] pids;
+	delete [] seps;
+	return s;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::GetHeight
+//
+// Return   : the number of levels of the tree, 1 if the root is a leaf
+//------------------------------------------------------------------
+
+int IntBTreeFile::GetHeight()
+{
+	return header->height;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::GetCoverLen
+//
+// Return   : the number of bytes of the records kept in the leaves
+//------------------------------------------------------------------
+
+int IntBTreeFile::GetCoverLen()
+{
+	return header->coverLen;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::OpenScan
+//
+// Input    : lowKey, highKey - bounds of the keys to return, both
+//            included; NULL for no bound
+// Return   : a new scan, NULL on error.  The caller deletes it.
+//------------------------------------------------------------------
+
+IndexFileScan *IntBTreeFile::OpenScan(const void *lowKey, const void *highKey)
+{
+	Status s;
+	IntBTreeFileScan *scan = new IntBTreeFileScan(this, s, lowKey, highKey);
+
+	if (s != OK)
+	{
+		delete scan;
+		return NULL;
+	}
+	return scan;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFile::_DestroyFile, IntBTreeFile::DestroyFile
+//
+// Purpose  : Free every node of the tree, then the header and the file
+//            entry.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntBTreeFile::_DestroyFile(PageID pid)
+{
+	IntNodePage *page;
+
+	LATCHED_PIN(pid, page);
+	if (page->GetType() == INDEX_NODE)
+	{
+		for (int i = 0; i <= page->GetNumOfKeys(); i++)
+		{
+			if (_DestroyFile(page->Children()[i]) != OK)
+			{
+				LATCHED_UNPIN(pid, CLEAN);
+				return FAIL;
+			}
+		}
+	}
+	LATCHED_UNPIN(pid, CLEAN);
+	LATCHED_FREEPAGE(pid);
+	return OK;
+}
+
+Status IntBTreeFile::DestroyFile()
+{
+	if (_DestroyFile(header->root) != OK)
+		return FAIL;
+
+	LATCHED_UNPIN(headerID, CLEAN);
+	header = NULL;
+	LATCHED_FREEPAGE(headerID);
+	return MINIBASE_DB->DeleteFileEntry(dbname);
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFileScan::IntBTreeFileScan
+//
+// Input    : the tree, bounds of the keys to return (NULL for none)
+// Output   : status
+// Purpose  : Pin the leaf of the first key to return.
+//------------------------------------------------------------------
+
+IntBTreeFileScan::IntBTreeFileScan(IntBTreeFile *file, Status& status,
+                                   const void *lowKey, const void *highKey)
+{
+	int low = 0;
+
+	tree = file;
+	leaf = NULL;
+	next = 0;
+	dirty = FALSE;
+	bounded = (highKey != NULL);
+	if (bounded)
+		memcpy(&this->highKey, highKey, sizeof(int));
+
+	// Read ahead only once the scan leaves its first leaf, so that
+	// lookups never pay for it.
+	parentPid = INVALID_PAGE;
+	ahead = 0;
+	unread = 1;
+
+	if (lowKey == NULL)
+	{
+		// Find the leftmost leaf.
+
+		IntNodePage *page;
+		PageID child;
+
+		currPid = tree->header->root;
+		for (int level = tree->header->height; level > 1; level--)
+		{
+			status = LatchedBufMgr::PinPage(currPid, (Page *&)page);
+			if (status != OK)
+				return;
+			child = page->Children()[0];
+			LatchedBufMgr::UnpinPage(currPid, CLEAN);
+			currPid = child;
+		}
+	}
+	else
+	{
+		memcpy(&low, lowKey, sizeof(int));
+		status = tree->FindLeaf(low, currPid);
+		if (status != OK)
+			return;
+	}
+
+	status = LatchedBufMgr::PinPage(currPid, (Page *&)leaf);
+	if (status != OK)
+	{
+		leaf = NULL;
+		currPid = INVALID_PAGE;
+		return;
+	}
+	if (lowKey != NULL)
+		next = leaf->LowerBound(low);
+}
+
+
+IntBTreeFileScan::~IntBTreeFileScan()
+{
+	if (leaf != NULL)
+		LatchedBufMgr::UnpinPage(currPid, dirty);
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFileScan::GetNext
+//
+// Output   : the record id and key of the next entry, and the bytes of
+//            its record the tree covers
+// Purpose  : The second form answers index-only queries: it never
+//            reads the record itself.
+// Return   : OK if successful, DONE if no more entries, FAIL on error
+//------------------------------------------------------------------
+
+Status IntBTreeFileScan::GetNext(RecordID& rid, void *keyptr)
+{
+	return GetNext(rid, keyptr, NULL);
+}
+
+Status IntBTreeFileScan::GetNext(RecordID& rid, void *keyptr, char *covered)
+{
+	PageID nextPid;
+	int key;
+
+	if (leaf == NULL)
+		return DONE;
+
+	while (next == leaf->GetNumOfKeys())
+	{
+		nextPid = leaf->GetNextPage();
+		LATCHED_UNPIN(currPid, dirty);
+		leaf = NULL;
+		dirty = FALSE;
+		currPid = nextPid;
+		if (currPid == INVALID_PAGE)
+			return DONE;
+		LATCHED_PIN(currPid, leaf);
+		next = 0;
+		if (--unread == 0 && ReadAhead() != OK)
+			return FAIL;
+	}
+
+	key = leaf->Keys()[next];
+	if (bounded && key > highKey)
+	{
+		LATCHED_UNPIN(currPid, dirty);
+		leaf = NULL;
+		currPid = INVALID_PAGE;
+		return DONE;
+	}
+
+	rid = leaf->Rids()[next];
+	memcpy(keyptr, &key, sizeof(int));
+	if (covered != NULL)
+		memcpy(covered, leaf->Covered(next), tree->header->coverLen);
+	next++;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFileScan::FindParent
+//
+// Purpose  : Find the index node above the current leaf, and the child
+//            after the leaf in it.  parentPid is left INVALID_PAGE if
+//            the tree has no index node, or if the leaf cannot be
+//            found from its first key: it is empty, or one of several
+//            leaves full of that key.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntBTreeFileScan::FindParent()
+{
+	IntNodePage *page;
+	PageID pid, child;
+	int key;
+
+	parentPid = INVALID_PAGE;
+	if (tree->header->height == 1 || leaf->GetNumOfKeys() == 0)
+		return OK;
+
+	// The leaf starts right of any separator equal to its first key, so
+	// the upper levels are searched to the right of them.
+	key = leaf->Keys()[0];
+	pid = tree->header->root;
+	for (int level = tree->header->height; level > 2; level--)
+	{
+		LATCHED_PIN(pid, page);
+		child = page->Children()[page->UpperBound(key)];
+		LATCHED_UNPIN(pid, CLEAN);
+		pid = child;
+	}
+
+	LATCHED_PIN(pid, page);
+	for (int i = page->LowerBound(key); i <= page->GetNumOfKeys(); i++)
+	{
+		if (page->Children()[i] == currPid)
+		{
+			parentPid = pid;
+			ahead = i + 1;
+			break;
+		}
+	}
+	LATCHED_UNPIN(pid, CLEAN);
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFileScan::ReadAhead
+//
+// Purpose  : Bring the next INTSCAN_READAHEAD leaves after the current
+//            one into the buffer pool, lowest page id first, leaving
+//            out those past highKey.  Called on the last of the leaves
+//            read ahead last time, so that the next ones are in the
+//            pool before the scan gets to them.  Once the parent has no
+//            leaves left, the next call starts from the parent of the
+//            leaf it is made on.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntBTreeFileScan::ReadAhead()
+{
+	IntNodePage *parent;
+	Page *page;
+	PageID pids[INTSCAN_READAHEAD];
+	Bool last;
+	int n = 0;
+
+	if (parentPid == INVALID_PAGE && FindParent() != OK)
+		return FAIL;
+	if (parentPid == INVALID_PAGE)
+	{
+		unread = INTSCAN_READAHEAD;
+		return OK;
+	}
+
+	LATCHED_PIN(parentPid, parent);
+	for ( ; n < INTSCAN_READAHEAD && ahead <= parent->GetNumOfKeys(); ahead++)
+	{
+		if (bounded && parent->Keys()[ahead - 1] > highKey)
+			break;
+		pids[n++] = parent->Children()[ahead];
+	}
+	last = (n < INTSCAN_READAHEAD || ahead > parent->GetNumOfKeys());
+	LATCHED_UNPIN(parentPid, CLEAN);
+	if (last)
+		parentPid = INVALID_PAGE;
+
+	// With no leaf read ahead, the parent was used up on this leaf:
+	// start again from the next one.
+	unread = (n > 0) ? n : 1;
+
+	for (int i = 1; i < n; i++)
+	{
+		PageID pid = pids[i];
+		int j;
+
+		for (j = i; j > 0 && pids[j - 1] > pid; j--)
+			pids[j] = pids[j - 1];
+		pids[j] = pid;
+	}
+	for (int i = 0; i < n; i++)
+	{
+		LATCHED_PIN(pids[i], page);
+		LATCHED_UNPIN(pids[i], CLEAN);
+	}
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// IntBTreeFileScan::DeleteCurrent
+//
+// Purpose  : Remove the entry last returned by GetNext from the tree.
+// Return   : OK if successful, FAIL if there is no such entry
+//------------------------------------------------------------------
+
+Status IntBTreeFileScan::DeleteCurrent()
+{
+	if (leaf == NULL || next == 0)
+		return FAIL;
+
+	next--;
+	leaf->DeleteAt(next);
+	dirty = TRUE;
+	return OK;
+}
@@ -0,0 +1,692 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/minirel.h"
+#include "../include/bufmgr.h"
+#include "../include/db.h"
+#include "../include/heappage.h"
+#include "../include/inthash.h"
+
+//------------------------------------------------------------------
+// HashInt
+//
+// Input    : a key
+// Return   : its hash.  The bits of the key are mixed into every bit
+//            of the hash, so that the low bits used by the directory
+//            tell apart keys that differ only in their high bits, and
+//            runs of keys such as 0, 2, 4, ... spread evenly.
+//------------------------------------------------------------------
+
+unsigned int HashInt(int key)
+{
+	unsigned int h = (unsigned int)key;
+
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+
+//------------------------------------------------------------------
+// IntHashBucket::Init
+//
+// Input    : page id of the page, local depth of the bucket
+// Purpose  : Make an empty bucket.
+//------------------------------------------------------------------
+
+void IntHashBucket::Init(PageID pageNo, int depth)
+{
+	localDepth = depth;
+	numOfEntries = 0;
+	pid = pageNo;
+	nextPage = INVALID_PAGE;
+}
+
+
+//------------------------------------------------------------------
+// IntHashBucket::Append, IntHashBucket::DeleteAt
+//
+// Purpose  : Add an entry to a bucket that is not full, or remove
+//            entry i by moving the last entry in its place.
+//------------------------------------------------------------------
+
+void IntHashBucket::Append(int key, RecordID rid)
+{
+	keys[numOfEntries] = key;
+	rids[numOfEntries] = rid;
+	numOfEntries++;
+}
+
+void IntHashBucket::DeleteAt(int i)
+{
+	numOfEntries--;
+	keys[i] = keys[numOfEntries];
+	rids[i] = rids[numOfEntries];
+}
+
+
+//------------------------------------------------------------------
+// IntHashFile::IntHashFile
+//
+// Input    : filename - name of the index
+// Output   : status of initialization
+// Purpose  : Open the index if it exists, else create it with one
+//            empty bucket.
+//------------------------------------------------------------------
+
+IntHashFile::IntHashFile(Status& status, const char *filename)
+{
+	header = NULL;
+	dir = NULL;
+	dbname = strcpy(new char[strlen(filename) + 1], filename);
+
+	if (MINIBASE_DB->GetFileEntry(filename, headerID) == OK)
+	{
+		status = MINIBASE_BM->PinPage(headerID, (Page *&)header);
+		if (status != OK)
+		{
+			cerr << "IntHashFile::IntHashFile - Unable to pin the header\n";
+			header = NULL;
+			return;
+		}
+		status = ReadDirectory();
+		return;
+	}
+
+	if (MINIBASE_BM->NewPage(headerID, (Page *&)header) != OK)
+	{
+		cerr << "IntHashFile::IntHashFile - Unable to allocate the header\n";
+		header = NULL;
+		status = FAIL;
+		return;
+	}
+	if (Create() != OK)
+	{
+		status = FAIL;
+		return;
+	}
+
+	status = MINIBASE_DB->AddFileEntry(filename, headerID);
+}
+
+
+//------------------------------------------------------------------
+// IntHashFile::Create
+//
+// Purpose  : Fill in the new header: a directory of one entry, for an
+//            empty bucket of depth 0.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntHashFile::Create()
+{
+	PageID *page;
+	IntHashBucket *bucket;
+	PageID dirPid, pid;
+
+	NEWPAGE(pid, bucket);
+	bucket->Init(pid, 0);
+	UNPIN(pid, DIRTY);
+
+	NEWPAGE(dirPid, page);
+	page[0] = pid;
+	UNPIN(dirPid, DIRTY);
+
+	header->globalDepth = 0;
+	header->numOfDirPages = 1;
+	header->dirPages[0] = dirPid;
+	dir = new PageID[1];
+	dir[0] = pid;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// IntHashFile::ReadDirectory
+//
+// Purpose  : Copy the directory pages of an index being opened into
+//            memory.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntHashFile::ReadDirectory()
+{
+	int size = 1 << header->globalDepth;
+	PageID *page;
+
+	dir = new PageID[size];
+	for (int i = 0; i < header->numOfDirPages; i++)
+	{
+		int n = (size < INTHASH_DIR_SIZE) ? size : INTHASH_DIR_SIZE;
+
+		PIN(header->dirPages[i], page);
+		memcpy(dir + i*INTHASH_DIR_SIZE, page, n*sizeof(PageID));
+		UNPIN(header->dirPages[i], CLEAN);
+	}
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// IntHashFile::~IntHashFile
+//
+// Purpose  : Close the index.  The pages stay in the database.
+//------------------------------------------------------------------
+
+IntHashFile::~IntHashFile()
+{
+	if (header != NULL)
+		MINIBASE_BM->UnpinPage(headerID, DIRTY);
+	delete [] dir;
+	delete [] dbname;
+}
+
+
+//------------------------------------------------------------------
+// IntHashFile::SetSlot
+//
+// Input    : an entry of the directory, a bucket
+// Purpose  : Point the entry to the bucket, in memory and in its page.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntHashFile::SetSlot(int slot, PageID pid)
+{
+	PageID *page;
+	PageID dirPid = header->dirPages[slot / INTHASH_DIR_SIZE];
+
+	PIN(dirPid, page);
+	page[slot % INTHASH_DIR_SIZE] = pid;
+	UNPIN(dirPid, DIRTY);
+	dir[slot] = pid;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// IntHashFile::DirectoryIsFull
+//
+// Return   : TRUE if the directory has no room to double
+//------------------------------------------------------------------
+
+Bool IntHashFile::DirectoryIsFull()
+{
+	return (2 << header->globalDepth) > INTHASH_DIR_SIZE
+		&& 2*header->numOfDirPages > INTHASH_MAX_DIR_PAGES;
+}
+
+
+//------------------------------------------------------------------
+// IntHashFile::DoubleDirectory
+//
+// Purpose  : Add one bit to the global depth.  The new half of the
+//            directory is a copy of the old one: every bucket is now
+//            pointed to from twice as many entries.
+// Return   : OK if successful, FAIL if the directory cannot grow or on
+//            error
+//------------------------------------------------------------------
+
+Status IntHashFile::DoubleDirectory()
+{
+	int size = 1 << header->globalDepth;
+	int n = header->numOfDirPages;
+	PageID *page, *copy, *bigger;
+	PageID pid;
+
+	if (DirectoryIsFull())
+		return FAIL;
+
+	if (2*size <= INTHASH_DIR_SIZE)
+	{
+		PIN(header->dirPages[0], page);
+		memcpy(page + size, page, size*sizeof(PageID));
+		UNPIN(header->dirPages[0], DIRTY);
+	}
+	else
+	{
+		for (int i = 0; i < n; i++)
+		{
+			PIN(header->dirPages[i], page);
+			NEWPAGE(pid, copy);
+			memcpy(copy, page, INTHASH_DIR_SIZE*sizeof(PageID));
+			UNPIN(pid, DIRTY);
+			UNPIN(header->dirPages[i], CLEAN);
+			header->dirPages[n + i] = pid;
+		}
+		header->numOfDirPages = 2*n;
+	}
+
+	bigger = new PageID[2*size];
+	memcpy(bigger, dir, size*sizeof(PageID));
+	memcpy(bigger + size, dir, size*sizeof(PageID));
+	delete [] dir;
+	dir = bigger;
+
+	header->globalDepth++;
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// IntHashFile::Split
+//
+// Input    : a full bucket, pinned, and the hash of a key that leads
+//            to it
+// Purpose  : Move the entries of the bucket whose hash has a 1 at the
+//            bit after its local depth to a new bucket, and point the
+//            half of its directory entries with that bit to the new
+//            bucket.  The directory doubles first if the bucket is as
+//            deep as it.  The bucket is unpinned.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntHashFile::Split(PageID pid, IntHashBucket *bucket, unsigned int hash)
+{
+	IntHashBucket *right;
+	PageID rightPid;
+	int d = bucket->GetLocalDepth();
+	int first;
+
+	if (d == header->globalDepth && DoubleDirectory() != OK)
+	{
+		UNPIN(pid, CLEAN);
+		return FAIL;
+	}
+
+	NEWPAGE(rightPid, right);
+	right->Init(rightPid, d + 1);
+	bucket->SetLocalDepth(d + 1);
+	for (int i = 0; i < bucket->GetNumOfEntries(); )
+	{
+		if ((HashInt(bucket->Key(i)) >> d) & 1)
+		{
+			right->Append(bucket->Key(i), bucket->Rid(i));
+			bucket->DeleteAt(i);
+		}
+		else
+			i++;
+	}
+	UNPIN(rightPid, DIRTY);
+	UNPIN(pid, DIRTY);
+
+	// The entries of the bucket are those with its d low bits of the
+	// hash; the ones that also have bit d set now lead to right.
+
+	first = (hash & ((1u << d) - 1)) | (1 << d);
+	for (int slot = first; slot < (1 << header->globalDepth); slot += 2 << d)
+	{
+		if (SetSlot(slot, rightPid) != OK)
+			return FAIL;
+	}
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// IntHashFile::AddToChain
+//
+// Input    : a full bucket, pinned, that cannot be split, and an entry
+// Purpose  : Put the entry in the first overflow page of the bucket
+//            with room for it, adding a page at the end of the chain
+//            if there is none.  The bucket is unpinned.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntHashFile::AddToChain(PageID pid, IntHashBucket *bucket, int key, RecordID rid)
+{
+	IntHashBucket *next;
+	PageID nextPid;
+
+	while (bucket->IsFull())
+	{
+		nextPid = bucket->GetNextPage();
+		if (nextPid == INVALID_PAGE)
+		{
+			NEWPAGE(nextPid, next);
+			next->Init(nextPid, bucket->GetLocalDepth());
+			bucket->SetNextPage(nextPid);
+			UNPIN(pid, DIRTY);
+		}
+		else
+		{
+			UNPIN(pid, CLEAN);
+			PIN(nextPid, next);
+		}
+		pid = nextPid;
+		bucket = next;
+	}
+
+	bucket->Append(key, rid);
+	UNPIN(pid, DIRTY);
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// IntHashFile::Insert
+//
+// Input    : pointer to an int key, record id
+// Purpose  : Insert the entry in its bucket, splitting the bucket
+//            while it is full.  A bucket is not split if it already
+//            has overflow pages, if the directory cannot grow, or if
+//            all its keys are the key inserted, as no split could
+//            tell them apart; the entry goes to an overflow page.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntHashFile::Insert(const void *key, const RecordID rid)
+{
+	IntHashBucket *bucket;
+	PageID pid;
+	unsigned int h;
+	int k;
+
+	memcpy(&k, key, sizeof(int));
+	h = HashInt(k);
+
+	for (;;)
+	{
+		pid = GetBucket(h);
+		PIN(pid, bucket);
+
+		if (!bucket->IsFull())
+		{
+			bucket->Append(k, rid);
+			UNPIN(pid, DIRTY);
+			return OK;
+		}
+
+		Bool splittable = (bucket->GetNextPage() == INVALID_PAGE);
+		if (bucket->GetLocalDepth() == header->globalDepth && DirectoryIsFull())
+			splittable = FALSE;
+		if (splittable)
+		{
+			splittable = FALSE;
+			for (int i = 0; i < bucket->GetNumOfEntries() && !splittable; i++)
+				splittable = (bucket->Key(i) != k);
+		}
+
+		if (!splittable)
+			return AddToChain(pid, bucket, k, rid);
+		if (Split(pid, bucket, h) != OK)
+			return FAIL;
+	}
+}
+
+
+//------------------------------------------------------------------
+// IntHashFile::Delete
+//
+// Input    : pointer to an int key, record id
+// Purpose  : Remove the entry from its bucket.  Buckets are not merged,
+//            and may become empty.
+// Return   : OK if successful, DONE if there is no such entry, FAIL
+//            otherwise
+//------------------------------------------------------------------
+
+Status IntHashFile::Delete(const void *key, const RecordID rid)
+{
+	IntHashBucket *bucket;
+	PageID pid, nextPid;
+	int k;
+
+	memcpy(&k, key, sizeof(int));
+	pid = GetBucket(HashInt(k));
+
+	while (pid != INVALID_PAGE)
+	{
+		PIN(pid, bucket);
+		for (int i = 0; i < bucket->GetNumOfEntries(); i++)
+		{
+			if (bucket->Key(i) == k && bucket->Rid(i) == rid)
+			{
+				bucket->DeleteAt(i);
+				UNPIN(pid, DIRTY);
+				return OK;
+			}
+		}
+		nextPid = bucket->GetNextPage();
+		UNPIN(pid, CLEAN);
+		pid = nextPid;
+	}
+	return DONE;
+}
+
+
+//------------------------------------------------------------------
+// IntHashFile::GetGlobalDepth
+//
+// Return   : the number of bits of the hash the directory uses
+//------------------------------------------------------------------
+
+int IntHashFile::GetGlobalDepth()
+{
+	return header->globalDepth;
+}
+
+
+//------------------------------------------------------------------
+// IntHashFile::OpenScan
+//
+// Input    : lowKey, highKey - both NULL to scan the whole index, or
+//            both pointing to the one key to look up
+// Return   : a new scan, NULL on error or for a range of keys.  The
+//            caller deletes it.
+//------------------------------------------------------------------
+
+IndexFileScan *IntHashFile::OpenScan(const void *lowKey, const void *highKey)
+{
+	Status s;
+	IntHashFileScan *scan;
+	int low, high;
+
+	if ((lowKey == NULL) != (highKey == NULL))
+	{
+		cerr << "IntHashFile::OpenScan - Cannot scan a range of keys" << endl;
+		return NULL;
+	}
+	if (lowKey != NULL)
+	{
+		memcpy(&low, lowKey, sizeof(int));
+		memcpy(&high, highKey, sizeof(int));
+		if (low != high)
+		{
+			cerr << "IntHashFile::OpenScan - Cannot scan a range of keys" << endl;
+			return NULL;
+		}
+	}
+
+	scan = new IntHashFileScan(this, s, (lowKey == NULL) ? NULL : &low);
+	if (s != OK)
+	{
+		delete scan;
+		return NULL;
+	}
+	return scan;
+}
+
+
+//------------------------------------------------------------------
+// IntHashFile::DestroyFile
+//
+// Purpose  : Free every bucket, with its overflow pages, then the
+//            directory, the header and the file entry.  A bucket is
+//            freed from the first directory entry that points to it:
+//            the one whose number is below 2 to its local depth.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntHashFile::DestroyFile()
+{
+	IntHashBucket *bucket;
+	PageID pid, nextPid;
+
+	for (int slot = 0; slot < (1 << header->globalDepth); slot++)
+	{
+		pid = dir[slot];
+		PIN(pid, bucket);
+		if (slot >= (1 << bucket->GetLocalDepth()))
+		{
+			UNPIN(pid, CLEAN);
+			continue;
+		}
+		while (pid != INVALID_PAGE)
+		{
+			nextPid = bucket->GetNextPage();
+			UNPIN(pid, CLEAN);
+			FREEPAGE(pid);
+			pid = nextPid;
+			if (pid != INVALID_PAGE)
+			{
+				PIN(pid, bucket);
+			}
+		}
+	}
+
+	for (int i = 0; i < header->numOfDirPages; i++)
+		FREEPAGE(header->dirPages[i]);
+
+	UNPIN(headerID, CLEAN);
+	header = NULL;
+	FREEPAGE(headerID);
+	return MINIBASE_DB->DeleteFileEntry(dbname);
+}
+
+
+//------------------------------------------------------------------
+// IntHashFileScan::IntHashFileScan
+//
+// Input    : the index, the key to look up (NULL for all the keys)
+// Output   : status
+// Purpose  : Pin the first bucket to read.
+//------------------------------------------------------------------
+
+IntHashFileScan::IntHashFileScan(IntHashFile *file, Status& status, const int *key)
+{
+	index = file;
+	currPid = INVALID_PAGE;
+	bucket = NULL;
+	next = 0;
+	dirty = FALSE;
+	all = (key == NULL);
+	this->key = all ? 0 : *key;
+	slot = 0;
+
+	if (all)
+	{
+		status = PinBucket(0);
+		return;
+	}
+
+	currPid = index->GetBucket(HashInt(*key));
+	status = MINIBASE_BM->PinPage(currPid, (Page *&)bucket);
+	if (status != OK)
+	{
+		bucket = NULL;
+		currPid = INVALID_PAGE;
+	}
+}
+
+
+IntHashFileScan::~IntHashFileScan()
+{
+	if (bucket != NULL)
+		MINIBASE_BM->UnpinPage(currPid, dirty);
+}
+
+
+//------------------------------------------------------------------
+// IntHashFileScan::PinBucket
+//
+// Input    : a directory entry
+// Purpose  : Pin the first bucket whose first directory entry is at
+//            or after it, if any, for a scan of the whole index.
+// Return   : OK if successful, FAIL otherwise
+//------------------------------------------------------------------
+
+Status IntHashFileScan::PinBucket(int from)
+{
+	IntHashBucket *page;
+	PageID pid;
+
+	for (slot = from; slot < (1 << index->header->globalDepth); slot++)
+	{
+		pid = index->dir[slot];
+		PIN(pid, page);
+		if (slot < (1 << page->GetLocalDepth()))
+		{
+			currPid = pid;
+			bucket = page;
+			return OK;
+		}
+		UNPIN(pid, CLEAN);
+	}
+	return OK;
+}
+
+
+//------------------------------------------------------------------
+// IntHashFileScan::GetNext
+//
+// Output   : the record id and key of the next entry
+// Return   : OK if successful, DONE if no more entries, FAIL on error
+//------------------------------------------------------------------
+
+Status IntHashFileScan::GetNext(RecordID& rid, void *keyptr)
+{
+	PageID nextPid;
+
+	while (bucket != NULL)
+	{
+		while (next < bucket->GetNumOfEntries())
+		{
+			int k = bucket->Key(next++);
+
+			if (all || k == key)
+			{
+				rid = bucket->Rid(next - 1);
+				memcpy(keyptr, &k, sizeof(int));
+				return OK;
+			}
+		}
+
+		nextPid = bucket->GetNextPage();
+		UNPIN(currPid, dirty);
+		bucket = NULL;
+		dirty = FALSE;
+		next = 0;
+		currPid = nextPid;
+		if (currPid != INVALID_PAGE)
+		{
+			PIN(currPid, bucket);
+		}
+		else if (all && PinBucket(slot + 1) != OK)
+			return FAIL;
+	}
+	return DONE;
+}
+
+
+//------------------------------------------------------------------
+// IntHashFileScan::DeleteCurrent
+//
+// Purpose  : Remove the entry last returned by GetNext from the index.
+//            The last entry of the bucket takes its place, and is the
+//            next one looked at.
+// Return   : OK if successful, FAIL if there is no such entry
+//------------------------------------------------------------------
+
+Status IntHashFileScan::DeleteCurrent()
+{
+	if (bucket == NULL || next == 0)
+		return FAIL;
+
+	next--;
+	bucket->DeleteAt(next);
+	dirty = TRUE;
+	return OK;
+}
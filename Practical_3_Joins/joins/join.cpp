@@ -8,6 +8,7 @@
 #include "../include/btfile.h"
 #include "../include/btfilescan.h"
 #include "../include/join.h"
+#include "../include/relation.h"
 
 //-----------------------------------------------------------------
 // MakeNewRecord
@@ -30,77 +31,168 @@ void MakeNewRecord (char *newRecord, char *r, char *s, int recLenR, int recLenS)
 
 
 //--------------------------------------------------------------------
-// This is a USEFUL function to sort a file.    It is also very useful
-// to understand how to use HeapFile, Scan, BTreeFile, BTreeFileScan.
+// The int key of a record, with the RecordID of the record.
 //--------------------------------------------------------------------
-// SortFile
-// 
-// Purpose  : sort a relation ordered by an integer attribute
-// Input    : S - pointer to the relation/HeapFile to be sorted.
-//            len - length of the record in the file S. (assume fixed
-//				    size.
-//            offset - offset of the attribute from the beginning of the record.
-// Cheat    : We create a B+-Tree using that attribute as the key. Then
-//            we scan the B+-Tree and insert the records into a new
-//            HeapFile.   The HeapFile guarantees that the order of 
-//            insertion will be the same as the order of scan later.
-// Return   : The new sorted relation/HeapFile.
-//-------------------------------------------------------------------- 
 
-HeapFile *SortFile(HeapFile *S, int len, int offset)
+struct KeyRid
 {
-	Status s;
+	int      key;
+	RecordID rid;
+};
+
+static int CompareKeyRid(const void *a, const void *b)
+{
+	const KeyRid *x = (const KeyRid *)a;
+	const KeyRid *y = (const KeyRid *)b;
+
+	if (x->key != y->key)
+		return (x->key < y->key) ? -1 : 1;
+	if (x->rid.pageNo != y->rid.pageNo)
+		return (x->rid.pageNo < y->rid.pageNo) ? -1 : 1;
+	return x->rid.slotNo - y->rid.slotNo;
+}
+
 
+//--------------------------------------------------------------------
+// SortKeys
+//
+// Purpose  : read the integer attribute at offset of every record of
+//            F, and sort these keys with their RecordIDs.
+// Input    : F - the relation/HeapFile.
+//            len - length of the records of F.
+//            offset - offset of the attribute in the records.
+// Output   : numOfKeys - the number of records of F.
+// Return   : the new[]ed array of keys, NULL on error.
+//--------------------------------------------------------------------
+
+static KeyRid *SortKeys(HeapFile *F, int len, int offset, int& numOfKeys)
+{
+	Status s;
 	Scan *scan;
-	scan = S->OpenScan(s);
+	scan = F->OpenScan(s);
 	if (s != OK)
 	{
 		cerr << "ERROR : cannot open scan on the heapfile to sort.\n";
+		return NULL;
 	}
 
-	//
-	// Scan the HeapFile S, new a B+Tree and insert the records into B+Tree.
-	// 
-
-	BTreeFile *btree;
-	btree = new BTreeFile (s, "BTree", ATTR_INT, sizeof(int));
-
+	int size = F->GetNumOfRecords();
+	KeyRid *keys = new KeyRid[size > 0 ? size : 1];
 	char *recPtr = new char[len];
 	int recLen = len;
 	RecordID rid;
-	while (scan->GetNext(rid, recPtr, recLen) == OK)
+
+	numOfKeys = 0;
+	while (numOfKeys < size && scan->GetNext(rid, recPtr, recLen) == OK)
 	{
-		btree->Insert(recPtr + offset, rid);
+		memcpy(&keys[numOfKeys].key, recPtr + offset, sizeof(int));
+		keys[numOfKeys].rid = rid;
+		numOfKeys++;
 	}
 	delete scan;
+	delete [] recPtr;
 
-	HeapFile *sorted;
-	sorted = new HeapFile(NULL, s); // create a temp HeapFile
-	if (s != OK)
+	qsort(keys, numOfKeys, sizeof(KeyRid), CompareKeyRid);
+	return keys;
+}
+
+
+//--------------------------------------------------------------------
+// KeyRidSource
+//
+// Feeds an array of KeyRid, sorted by key, to BTreeFile::BulkLoad.
+//--------------------------------------------------------------------
+
+class KeyRidSource : public BTreeLoadSource
+{
+public:
+
+	KeyRidSource(KeyRid *keys, int numOfKeys) 
+		: keys(keys), numOfKeys(numOfKeys), next(0) {}
+
+	Status GetNext(RecordID& rid, void *keyptr)
 	{
-	    	cerr << "Cannot create new file for sortedS\n";
+		if (next == numOfKeys)
+			return DONE;
+		rid = keys[next].rid;
+		memcpy(keyptr, &keys[next].key, sizeof(int));
+		next++;
+		return OK;
 	}
 
-	//
-	// Now scan the B+-Tree and insert the records into a 
-	// new (sorted) HeapFile.
-	//
+private:
 
-	BTreeFileScan  *btreeScan;
-	btreeScan = (BTreeFileScan *)btree->OpenScan(NULL, NULL);
+	KeyRid *keys;
+	int     numOfKeys;
+	int     next;
+};
+
+
+//--------------------------------------------------------------------
+// BuildIndex
+//
+// Purpose  : build a B+-Tree on an integer attribute of a relation, by
+//            sorting the keys and bulk loading the tree bottom-up
+//            rather than inserting the records one at a time.  The
+//            leaves are packed full, as the tree is only read.
+// Input    : F - the relation/HeapFile to index.
+//            len - length of the records of F.
+//            offset - offset of the attribute in the records.
+//            name - name of the BTreeFile.
+// Return   : the new BTreeFile, NULL on error.  The caller must
+//            DestroyFile() and delete it.
+//--------------------------------------------------------------------
 
-	int key;
+BTreeFile *BuildIndex(HeapFile *F, int len, int offset, const char *name)
+{
+	Status s;
+	int numOfKeys;
+	KeyRid *keys = SortKeys(F, len, offset, numOfKeys);
+	if (keys == NULL)
+		return NULL;
 
-	while (btreeScan->GetNext(rid, &key) == OK)
+	BTreeFile *btree;
+	btree = new BTreeFile (s, name, ATTR_INT, sizeof(int));
+	if (s == OK)
 	{
-	    S->GetRecord (rid, recPtr, recLen);
-	    sorted->InsertRecord (recPtr, recLen, rid);
+		KeyRidSource source(keys, numOfKeys);
+		s = btree->BulkLoad(&source);
 	}
-	btree->DestroyFile();
+	delete [] keys;
 
-	delete btree;
-	delete btreeScan;
-	delete [] recPtr;
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot build the B+-Tree " << name << ".\n";
+		btree->DestroyFile();
+		delete btree;
+		return NULL;
+	}
+	return btree;
+}
 
-	return sorted;
+
+//--------------------------------------------------------------------
+// This is a USEFUL function to sort a file.    It is also very useful
+// to understand how to use HeapFile and Scan.
+//--------------------------------------------------------------------
+// SortFile
+// 
+// Purpose  : sort a relation ordered by an integer attribute
+// Input    : S - pointer to the relation/HeapFile to be sorted.
+//            len - length of the record in the file S. (assume fixed
+//				    size.
+//            offset - offset of the attribute from the beginning of the record.
+// Cheat    : None any more.  The file is sorted by ExternalSort, in
+//            half as many pages of memory as the buffer pool has
+//            frames, rather than by fetching the records one by one in the
+//            order of a sorted list of their RecordIDs, which costs a
+//            random read per record once S outgrows the buffer pool.
+//            The HeapFile guarantees that the order of insertion will
+//            be the same as the order of scan later.
+// Return   : The new sorted relation/HeapFile.
+//-------------------------------------------------------------------- 
+
+HeapFile *SortFile(HeapFile *S, int len, int offset)
+{
+	return ExternalSort(S, len, offset, 0);
 }
@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/minirel.h"
+#include "../include/keymatch.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KEY_MATCH_X86
+#include <immintrin.h>
+#endif
+
+
+KeyArray::KeyArray(int capacity)
+{
+	this->capacity = (capacity > 0) ? capacity : 1;
+	mem = new char[this->capacity * sizeof(int) + KEY_ARRAY_ALIGN];
+	keys = (int *)(((size_t)mem + KEY_ARRAY_ALIGN - 1)
+	               & ~(size_t)(KEY_ARRAY_ALIGN - 1));
+}
+
+
+KeyArray::~KeyArray()
+{
+	delete [] mem;
+}
+
+
+//--------------------------------------------------------------------
+// The kernels.  Each writes every position to positions, and only
+// moves the end of positions past it if the key there matches, so that
+// whether a key matches is never branched on; the vector ones only
+// look at the positions of a register whose mask is not all zero,
+// which, for a join key, is rare.
+//--------------------------------------------------------------------
+
+static int MatchKeysScalar(const int *keys, int from, int n, int key, int *positions, int k)
+{
+	for (int i = from; i < n; i++)
+	{
+		positions[k] = i;
+		k += (keys[i] == key);
+	}
+	return k;
+}
+
+
+#ifdef KEY_MATCH_X86
+
+#ifdef __SSE2__
+static int MatchKeysSSE2(const int *keys, int n, int key, int *positions)
+{
+	__m128i k4 = _mm_set1_epi32(key);
+	int k = 0;
+	int i = 0;
+
+	for (; i + 4 <= n; i += 4)
+	{
+		__m128i eq = _mm_cmpeq_epi32(_mm_load_si128((const __m128i *)(keys + i)), k4);
+		unsigned int mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+
+		while (mask != 0)
+		{
+			positions[k++] = i + __builtin_ctz(mask);
+			mask &= mask - 1;
+		}
+	}
+	return MatchKeysScalar(keys, i, n, key, positions, k);
+}
+#endif
+
+
+__attribute__((target("avx2")))
+static int MatchKeysAVX2(const int *keys, int n, int key, int *positions)
+{
+	__m256i k8 = _mm256_set1_epi32(key);
+	int k = 0;
+	int i = 0;
+
+	for (; i + KEY_MATCH_WIDTH <= n; i += KEY_MATCH_WIDTH)
+	{
+		__m256i eq = _mm256_cmpeq_epi32(_mm256_load_si256((const __m256i *)(keys + i)), k8);
+		unsigned int mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+
+		while (mask != 0)
+		{
+			positions[k++] = i + __builtin_ctz(mask);
+			mask &= mask - 1;
+		}
+	}
+	return MatchKeysScalar(keys, i, n, key, positions, k);
+}
+
+#endif
+
+
+static Bool HasKernel(KeyMatchKernel kernel)
+{
+	switch (kernel)
+	{
+#ifdef KEY_MATCH_X86
+#ifdef __SSE2__
+	case kmSSE2: return TRUE;
+#endif
+	case kmAVX2: return __builtin_cpu_supports("avx2") ? TRUE : FALSE;
+#endif
+	case kmScalar: return TRUE;
+	default:       return FALSE;
+	}
+}
+
+
+static KeyMatchKernel BestKernel()
+{
+	// Run from the initializer of currentKernel, which may come before
+	// that of the data __builtin_cpu_supports reads.
+#ifdef KEY_MATCH_X86
+	__builtin_cpu_init();
+#endif
+	if (HasKernel(kmAVX2))
+		return kmAVX2;
+	if (HasKernel(kmSSE2))
+		return kmSSE2;
+	return kmScalar;
+}
+
+
+static KeyMatchKernel currentKernel = BestKernel();
+
+
+KeyMatchKernel GetKeyMatchKernel()
+{
+	return currentKernel;
+}
+
+
+void SetKeyMatchKernel(KeyMatchKernel kernel)
+{
+	currentKernel = HasKernel(kernel) ? kernel : kmScalar;
+}
+
+
+int MatchKeys(const int *keys, int n, int key, int *positions)
+{
+	switch (currentKernel)
+	{
+#ifdef KEY_MATCH_X86
+#ifdef __SSE2__
+	case kmSSE2: return MatchKeysSSE2(keys, n, key, positions);
+#endif
+	case kmAVX2: return MatchKeysAVX2(keys, n, key, positions);
+#endif
+	default:     return MatchKeysScalar(keys, 0, n, key, positions, 0);
+	}
+}
@@ -0,0 +1,48 @@
+#include <pthread.h>
+
+#include "../include/minirel.h"
+#include "../include/bufmgr.h"
+#include "../include/latchbm.h"
+
+static pthread_mutex_t latch = PTHREAD_MUTEX_INITIALIZER;
+
+
+//------------------------------------------------------------------
+// LatchedBufMgr::PinPage, UnpinPage, NewPage, FreePage
+//
+// Purpose  : The calls of MINIBASE_BM of the same names, one thread at
+//            a time.
+// Return   : what MINIBASE_BM returns
+//------------------------------------------------------------------
+
+Status LatchedBufMgr::PinPage(PageID pid, Page *&page)
+{
+	pthread_mutex_lock(&latch);
+	Status s = MINIBASE_BM->PinPage(pid, page);
+	pthread_mutex_unlock(&latch);
+	return s;
+}
+
+Status LatchedBufMgr::UnpinPage(PageID pid, Bool dirty)
+{
+	pthread_mutex_lock(&latch);
+	Status s = MINIBASE_BM->UnpinPage(pid, dirty);
+	pthread_mutex_unlock(&latch);
+	return s;
+}
+
+Status LatchedBufMgr::NewPage(PageID& pid, Page *&page)
+{
+	pthread_mutex_lock(&latch);
+	Status s = MINIBASE_BM->NewPage(pid, page);
+	pthread_mutex_unlock(&latch);
+	return s;
+}
+
+Status LatchedBufMgr::FreePage(PageID pid)
+{
+	pthread_mutex_lock(&latch);
+	Status s = MINIBASE_BM->FreePage(pid);
+	pthread_mutex_unlock(&latch);
+	return s;
+}
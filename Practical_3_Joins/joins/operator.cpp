@@ -0,0 +1,273 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/minirel.h"
+#include "../include/heapfile.h"
+#include "../include/scan.h"
+#include "../include/join.h"
+#include "../include/operator.h"
+
+
+RecordBatch::RecordBatch(int recLen, int capacity)
+{
+	this->recLen = recLen;
+	this->capacity = capacity;
+	numOfRecs = 0;
+	recs = new char[capacity * recLen];
+}
+
+
+RecordBatch::~RecordBatch()
+{
+	delete [] recs;
+}
+
+
+//--------------------------------------------------------------------
+// ScanOp
+//--------------------------------------------------------------------
+
+ScanOp::ScanOp(HeapFile *file, int recLen)
+{
+	this->file = file;
+	this->recLen = recLen;
+	scan = NULL;
+}
+
+
+ScanOp::~ScanOp()
+{
+	delete scan;
+}
+
+
+Status ScanOp::Open()
+{
+	Status s;
+
+	delete scan;
+	scan = file->OpenScan(s);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot open scan on a heapfile.\n";
+		scan = NULL;
+		return FAIL;
+	}
+	return OK;
+}
+
+
+Status ScanOp::Next(RecordBatch& batch)
+{
+	RecordID rid;
+	int len = recLen;
+
+	batch.Clear();
+	while (scan != NULL && !batch.IsFull())
+	{
+		if (scan->GetNext(rid, batch.Record(batch.GetNumOfRecords()), len) != OK)
+		{
+			delete scan;
+			scan = NULL;
+			break;
+		}
+		batch.Append();
+	}
+	return (batch.GetNumOfRecords() > 0) ? OK : DONE;
+}
+
+
+Status ScanOp::Close()
+{
+	delete scan;
+	scan = NULL;
+	return OK;
+}
+
+
+//--------------------------------------------------------------------
+// FilterOp
+//--------------------------------------------------------------------
+
+FilterOp::FilterOp(Operator *child, int offset, AttrOperator op, int value)
+	: in(child->GetRecLen())
+{
+	this->child = child;
+	this->offset = offset;
+	this->op = op;
+	this->value = value;
+	recLen = child->GetRecLen();
+	inPos = 0;
+}
+
+
+FilterOp::~FilterOp()
+{
+	delete child;
+}
+
+
+Status FilterOp::Open()
+{
+	in.Clear();
+	inPos = 0;
+	return child->Open();
+}
+
+
+static Bool Satisfies(int attr, AttrOperator op, int value)
+{
+	switch (op)
+	{
+	case aopEQ: return attr == value;
+	case aopLT: return attr < value;
+	case aopGT: return attr > value;
+	case aopNE: return attr != value;
+	case aopLE: return attr <= value;
+	case aopGE: return attr >= value;
+	default:    return TRUE;
+	}
+}
+
+
+Status FilterOp::Next(RecordBatch& batch)
+{
+	batch.Clear();
+	while (!batch.IsFull())
+	{
+		if (inPos == in.GetNumOfRecords())
+		{
+			inPos = 0;
+			if (child->Next(in) != OK)
+				break;
+		}
+
+		char *rec = in.Record(inPos++);
+		int attr;
+
+		memcpy(&attr, rec + offset, sizeof(int));
+		if (Satisfies(attr, op, value))
+			memcpy(batch.Append(), rec, recLen);
+	}
+	return (batch.GetNumOfRecords() > 0) ? OK : DONE;
+}
+
+
+Status FilterOp::Close()
+{
+	return child->Close();
+}
+
+
+//--------------------------------------------------------------------
+// ProjectOp
+//--------------------------------------------------------------------
+
+ProjectOp::ProjectOp(Operator *child, int numOfAttrs, const int *offsets)
+	: in(child->GetRecLen())
+{
+	this->child = child;
+	this->numOfAttrs = numOfAttrs;
+	this->offsets = new int[numOfAttrs];
+	memcpy(this->offsets, offsets, numOfAttrs * sizeof(int));
+	recLen = numOfAttrs * sizeof(int);
+}
+
+
+ProjectOp::~ProjectOp()
+{
+	delete [] offsets;
+	delete child;
+}
+
+
+Status ProjectOp::Open()
+{
+	return child->Open();
+}
+
+
+Status ProjectOp::Next(RecordBatch& batch)
+{
+	batch.Clear();
+	if (child->Next(in) != OK)
+		return DONE;
+
+	for (int i = 0; i < in.GetNumOfRecords(); i++)
+	{
+		char *rec = in.Record(i);
+		char *out = batch.Append();
+
+		for (int a = 0; a < numOfAttrs; a++)
+			memcpy(out + a*sizeof(int), rec + offsets[a], sizeof(int));
+	}
+	return OK;
+}
+
+
+Status ProjectOp::Close()
+{
+	return child->Close();
+}
+
+
+//--------------------------------------------------------------------
+// Materialize
+//--------------------------------------------------------------------
+
+HeapFile *Materialize(Operator *op)
+{
+	Status s;
+	HeapFile *T = new HeapFile(NULL, s);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot create a file for the records.\n";
+		delete T;
+		return NULL;
+	}
+
+	if (op->Open() != OK)
+	{
+		delete T;
+		return NULL;
+	}
+
+	RecordBatch batch(op->GetRecLen());
+	RecordID rid;
+
+	while (op->Next(batch) == OK)
+	{
+		for (int i = 0; i < batch.GetNumOfRecords(); i++)
+			T->InsertRecord(batch.Record(i), op->GetRecLen(), rid);
+	}
+	op->Close();
+	return T;
+}
+
+
+//--------------------------------------------------------------------
+// Aggregate
+//--------------------------------------------------------------------
+
+Status Aggregate(Operator *op, int offset, long& count, long& sum)
+{
+	count = 0;
+	sum = 0;
+	if (op->Open() != OK)
+		return FAIL;
+
+	RecordBatch batch(op->GetRecLen());
+	int attr;
+
+	while (op->Next(batch) == OK)
+	{
+		for (int i = 0; i < batch.GetNumOfRecords(); i++)
+		{
+			memcpy(&attr, batch.Record(i) + offset, sizeof(int));
+			sum += attr;
+		}
+		count += batch.GetNumOfRecords();
+	}
+	return op->Close();
+}
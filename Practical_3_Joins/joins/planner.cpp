@@ -0,0 +1,308 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../include/minirel.h"
+#include "../include/bufmgr.h"
+#include "../include/db.h"
+#include "../include/heapfile.h"
+#include "../include/heappage.h"
+#include "../include/dirpage.h"
+#include "../include/scan.h"
+#include "../include/join.h"
+#include "../include/inthash.h"
+#include "../include/extsort.h"
+#include "../include/planner.h"
+
+// Frames HybridHashJoin leaves to its scans and inserts, as
+// HASH_JOIN_RESERVED_FRAMES does in hashjoin.cpp.
+#define PLAN_HASH_RESERVED_FRAMES 4
+
+// Passes RadixHashJoin makes over its records: partitioning, then the
+// join of the partitions.
+#define PLAN_RADIX_PASSES 2
+
+static const char *joinMethodNames[NUM_OF_JOIN_METHODS] =
+	{ "Tuple", "Block", "Index", "SortMerge", "Hash", "Hybrid", "Radix" };
+
+
+const char *GetJoinMethodName(JoinMethod method)
+{
+	return joinMethodNames[method];
+}
+
+
+static int RecordsPerPage(int recLen)
+{
+	int n = HEAPPAGE_DATA_SIZE / (recLen + 2*sizeof(short));
+	return (n > 0) ? n : 1;
+}
+
+
+static long DivideUp(double a, double b)
+{
+	return (long)ceil(a / b);
+}
+
+
+//--------------------------------------------------------------------
+// CountPages
+//
+// Purpose  : count the data pages of a HeapFile, from the entries of
+//            its directory pages.
+// Input    : name - the name the file was created with.
+// Return   : the number of pages, -1 if there is no such file, as for
+//            a temporary one.
+//--------------------------------------------------------------------
+
+static int CountPages(const char *name)
+{
+	PageID pid;
+
+	if (MINIBASE_DB->GetFileEntry(name, pid) != OK)
+		return -1;
+
+	int numOfPages = 0;
+	while (pid != INVALID_PAGE)
+	{
+		Page *page;
+		if (MINIBASE_BM->PinPage(pid, page) != OK)
+			return -1;
+
+		DirPage *dir = (DirPage *)page;
+		PageInfoIterator entries(dir);
+		while (entries() != NULL)
+			numOfPages++;
+
+		PageID next = dir->GetNextPage();
+		MINIBASE_BM->UnpinPage(pid);
+		pid = next;
+	}
+	return numOfPages;
+}
+
+
+//--------------------------------------------------------------------
+// GetRelationStats
+//
+// The distinct values of the join attribute are estimated by linear
+// counting: each value sets the bit of its hash in a bitmap of eight
+// bits per record, and from the fraction of bits left unset follows
+// how many values set the others.
+//--------------------------------------------------------------------
+
+Status GetRelationStats(JoinSpec spec, RelationStats& stats)
+{
+	stats.recLen = spec.recLen;
+	stats.numOfRecords = spec.file->GetNumOfRecords();
+	stats.hasIndex = FALSE;
+
+	stats.numOfPages = CountPages(spec.relName);
+	if (stats.numOfPages < 0)
+		stats.numOfPages = DivideUp(stats.numOfRecords, RecordsPerPage(spec.recLen));
+
+	Status s;
+	Scan *scan = spec.file->OpenScan(s);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot open scan on " << spec.relName << ".\n";
+		return FAIL;
+	}
+
+	unsigned int numOfBits = 64;
+	while (numOfBits < 8 * (unsigned int)stats.numOfRecords)
+		numOfBits *= 2;
+
+	unsigned int *bits = new unsigned int[numOfBits / 32];
+	char *rec = new char[spec.recLen];
+	int recLen = spec.recLen;
+	RecordID rid;
+	int key;
+
+	memset(bits, 0, numOfBits / 8);
+	while (scan->GetNext(rid, rec, recLen) == OK)
+	{
+		memcpy(&key, rec + spec.offset, sizeof(int));
+		unsigned int bit = HashInt(key) & (numOfBits - 1);
+		bits[bit / 32] |= 1u << (bit % 32);
+	}
+	delete scan;
+	delete [] rec;
+
+	long numOfUnset = 0;
+	for (unsigned int w = 0; w < numOfBits / 32; w++)
+		numOfUnset += 32 - __builtin_popcount(bits[w]);
+	delete [] bits;
+
+	if (numOfUnset == 0)
+		stats.numOfDistinct = stats.numOfRecords;
+	else
+		stats.numOfDistinct = (int)(-(double)numOfBits * log((double)numOfUnset / numOfBits) + 0.5);
+	if (stats.numOfDistinct > stats.numOfRecords)
+		stats.numOfDistinct = stats.numOfRecords;
+	if (stats.numOfDistinct < 1)
+		stats.numOfDistinct = 1;
+	return OK;
+}
+
+
+//--------------------------------------------------------------------
+// SortCost
+//
+// Purpose  : the cost of ExternalSortScan on numOfPages pages of
+//            memory.  Its runs, of twice as many records as fit in
+//            memory on average, are all written, and merged fan-in at
+//            a time until one merge is left.
+// Output   : misses - the pages read, those of the runs included.
+//            numOfWrites - the records written to runs.
+//--------------------------------------------------------------------
+
+static void SortCost(RelationStats& stats, int numOfPages, long& misses, double& numOfWrites)
+{
+	if (numOfPages < 4*SORT_SCAN_PAGES)
+		numOfPages = 4*SORT_SCAN_PAGES;
+
+	long runLen = 2L * (numOfPages - 2*SORT_SCAN_PAGES) * MINIBASE_PAGESIZE / stats.recLen;
+	long numOfRuns = DivideUp(stats.numOfRecords, runLen > 0 ? runLen : 1);
+	int fanIn = (numOfPages - 2*SORT_SCAN_PAGES) / SORT_SCAN_PAGES;
+	int numOfPasses = 1;
+
+	while (numOfRuns > fanIn)
+	{
+		numOfRuns = DivideUp(numOfRuns, fanIn);
+		numOfPasses++;
+	}
+	misses += stats.numOfPages * (1 + numOfPasses);
+	numOfWrites += (double)stats.numOfRecords * numOfPasses;
+}
+
+
+//--------------------------------------------------------------------
+// PlanJoin
+//
+// Every join reads R and S and writes the same result; what tells them
+// apart is how often they read S again once the buffer pool cannot
+// hold it, how much they write to temporary files, and how much work
+// they do on each pair of records.
+//--------------------------------------------------------------------
+
+JoinMethod PlanJoin(RelationStats& statsOfR, RelationStats& statsOfS, int numOfFrames,
+                    int numOfThreads, JoinCost costs[NUM_OF_JOIN_METHODS])
+{
+	double nR = statsOfR.numOfRecords;
+	double nS = statsOfS.numOfRecords;
+	long M = statsOfR.numOfPages;
+	long N = statsOfS.numOfPages;
+	int distinct = (statsOfR.numOfDistinct > statsOfS.numOfDistinct)
+	               ? statsOfR.numOfDistinct : statsOfS.numOfDistinct;
+
+	double numOfResults = nR * nS / distinct;
+	long O = DivideUp(numOfResults, RecordsPerPage(statsOfR.recLen + statsOfS.recLen));
+	int avail = (numOfFrames > PLAN_RESERVED_FRAMES + 1) ? numOfFrames - PLAN_RESERVED_FRAMES : 1;
+	double common = numOfResults * PLAN_WRITE_COST + nR * PLAN_SCAN_COST;
+	double cpu[NUM_OF_JOIN_METHODS];
+
+	if (numOfThreads < 1)
+		numOfThreads = 1;
+
+	// TupleNestedLoopJoin scans S once for each record of R.
+	costs[jmTuple].misses = M + O + ((N <= avail) ? N : (long)(nR * N));
+	cpu[jmTuple] = nR * nS * PLAN_COMPARE_COST;
+
+	// BlockNestedLoopJoin, with blocks of what main.cpp gives it, scans
+	// S once for each block.
+	long blockLen = (long)avail * MINIBASE_PAGESIZE / statsOfR.recLen;
+	long numOfBlocks = DivideUp(nR, blockLen > 0 ? blockLen : 1);
+	costs[jmBlock].misses = M + O + ((N <= avail) ? N : numOfBlocks * N);
+	cpu[jmBlock] = numOfBlocks * nS * PLAN_SCAN_COST + nR * nS * PLAN_SIMD_COST;
+
+	// IndexNestedLoopJoin reads S to build its index, unless there is
+	// one, and fetches the matches of each record of R from a page of S
+	// and a leaf, which miss as often as the buffer pool is short of
+	// holding S and the index.
+	long I = DivideUp(nS, MINIBASE_PAGESIZE / (sizeof(int) + sizeof(RecordID))) + 1;
+	long touched = N + I;
+	costs[jmIndex].misses = M + O + (statsOfS.hasIndex ? 0 : N);
+	if (touched <= avail)
+		costs[jmIndex].misses += touched;
+	else
+	{
+		double miss = 1.0 - (double)avail / touched;
+		costs[jmIndex].misses += (long)((nR + DivideUp(nR, INDEX_JOIN_BATCH) * I) * miss);
+	}
+	cpu[jmIndex] = nR * PLAN_PROBE_COST + (statsOfS.hasIndex ? 0 : nS * PLAN_SCAN_COST);
+
+	// SortMergeJoin sorts each side on a quarter of the buffer pool.
+	double numOfWrites = 0;
+	costs[jmSortMerge].misses = O;
+	SortCost(statsOfR, numOfFrames / 4, costs[jmSortMerge].misses, numOfWrites);
+	SortCost(statsOfS, numOfFrames / 4, costs[jmSortMerge].misses, numOfWrites);
+	cpu[jmSortMerge] = nS * PLAN_SCAN_COST + numOfWrites * PLAN_TEMP_WRITE_COST;
+
+	// HashJoin holds the smaller relation in memory, whatever its size.
+	costs[jmHash].misses = M + N + O;
+	cpu[jmHash] = nS * PLAN_SCAN_COST + (nR + nS) * PLAN_HASH_COST;
+
+	// HybridHashJoin keeps as much of the smaller relation as the
+	// buffer pool holds, and writes the rest of both out and reads it
+	// back.
+	long smaller = (M < N) ? M : N;
+	int availHash = numOfFrames - PLAN_HASH_RESERVED_FRAMES;
+	double spilled = (smaller <= availHash) ? 0 : 1.0 - (double)availHash / smaller;
+	costs[jmHybrid].misses = M + N + O + (long)(spilled * (M + N));
+	cpu[jmHybrid] = cpu[jmHash] + spilled * (nR + nS) * PLAN_TEMP_WRITE_COST;
+
+	// RadixHashJoin partitions both in memory, and joins the partitions,
+	// on every thread.
+	costs[jmRadix].misses = M + N + O;
+	cpu[jmRadix] = nS * PLAN_SCAN_COST + (nR + nS) * PLAN_HASH_COST * PLAN_RADIX_PASSES / numOfThreads;
+
+	int best = 0;
+	for (int m = 0; m < NUM_OF_JOIN_METHODS; m++)
+	{
+		costs[m].time = (costs[m].misses * PLAN_MISS_COST + common + cpu[m]) / 1e6;
+		if (costs[m].time < costs[best].time)
+			best = m;
+	}
+	return (JoinMethod)best;
+}
+
+
+//--------------------------------------------------------------------
+// PlannedJoin
+//
+// Purpose  : gather the statistics of R and S, plan their join, and
+//            run it.  The pins of the statistics are counted in those
+//            of the join.
+//--------------------------------------------------------------------
+
+HeapFile *PlannedJoin(JoinSpec specOfR, JoinSpec specOfS, int numOfThreads, long& pinRequests,
+                      long& pinMisses, double& duration)
+{
+	RelationStats statsOfR, statsOfS;
+	JoinCost costs[NUM_OF_JOIN_METHODS];
+
+	if (GetRelationStats(specOfR, statsOfR) != OK || GetRelationStats(specOfS, statsOfS) != OK)
+		return NULL;
+
+	int numOfFrames = MINIBASE_BM->GetNumOfBuffers();
+	switch (PlanJoin(statsOfR, statsOfS, numOfFrames, numOfThreads, costs))
+	{
+	case jmTuple:
+		return TupleNestedLoopJoin(specOfR, specOfS, pinRequests, pinMisses, duration);
+	case jmBlock:
+		return BlockNestedLoopJoin(specOfR, specOfS, (numOfFrames - PLAN_RESERVED_FRAMES)*MINIBASE_PAGESIZE,
+		                           pinRequests, pinMisses, duration);
+	case jmIndex:
+		return IndexNestedLoopJoin(specOfR, specOfS, pinRequests, pinMisses, duration);
+	case jmSortMerge:
+		return SortMergeJoin(specOfR, specOfS, pinRequests, pinMisses, duration);
+	case jmHybrid:
+		return HybridHashJoin(specOfR, specOfS, pinRequests, pinMisses, duration);
+	case jmRadix:
+		return RadixHashJoin(specOfR, specOfS, numOfThreads, pinRequests, pinMisses, duration);
+	default:
+		return HashJoin(specOfR, specOfS, pinRequests, pinMisses, duration);
+	}
+}
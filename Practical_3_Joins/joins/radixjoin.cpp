@@ -0,0 +1,677 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include <pthread.h>
+
+#include "../include/minirel.h"
+#include "../include/heapfile.h"
+#include "../include/scan.h"
+#include "../include/join.h"
+#include "../include/inthash.h"
+#include "../include/relation.h"
+#include "../include/bufmgr.h"
+#include "../include/radixjoin.h"
+
+//---------------------------------------------------------------
+// Each join method takes in at least two parameters :
+// - specOfS
+// - specOfR
+//
+// They specify which relations we are going to join, which
+// attributes we are going to join on, the offsets of the
+// attributes etc.  specOfS specifies the inner relation while
+// specOfR specifies the outer one.
+//
+//You can use MakeNewRecord() to create the new result record.
+//
+// Remember to clean up before exiting by "delete"ing any pointers
+// that you "new"ed.  This includes any Scan/BTreeFileScan that
+// you have opened.
+//---------------------------------------------------------------
+
+
+#define RADIX_TUPLES_PER_LINE (int)(RADIX_CACHE_LINE / sizeof(RadixTuple))
+
+
+//--------------------------------------------------------------------
+// Tasks run by a pool of threads, each of which takes the next task
+// not taken yet until none is left.  A task is numbered, and the
+// thread that runs it too, from 0 to the number of threads - 1.
+//--------------------------------------------------------------------
+
+typedef void (*RadixWork)(void *ctx, int thread, int task);
+
+struct TaskQueue
+{
+	RadixWork       work;
+	void           *ctx;
+	int             numOfTasks;
+	int             next;
+	pthread_mutex_t lock;
+};
+
+struct Worker
+{
+	TaskQueue *queue;
+	int        thread;
+};
+
+static void *RunWorker(void *arg)
+{
+	Worker *w = (Worker *)arg;
+	TaskQueue *q = w->queue;
+
+	for (;;)
+	{
+		pthread_mutex_lock(&q->lock);
+		int task = q->next++;
+		pthread_mutex_unlock(&q->lock);
+
+		if (task >= q->numOfTasks)
+			break;
+		q->work(q->ctx, w->thread, task);
+	}
+	return NULL;
+}
+
+
+//--------------------------------------------------------------------
+// RunTasks
+//
+// Purpose  : run numOfTasks tasks with numOfThreads threads, the
+//            calling one among them, and wait for all of them.
+//            Threads that cannot be started leave their share to the
+//            others.
+//--------------------------------------------------------------------
+
+static void RunTasks(int numOfThreads, int numOfTasks, RadixWork work, void *ctx)
+{
+	TaskQueue q;
+	q.work = work;
+	q.ctx = ctx;
+	q.numOfTasks = numOfTasks;
+	q.next = 0;
+	pthread_mutex_init(&q.lock, NULL);
+
+	if (numOfThreads > numOfTasks)
+		numOfThreads = numOfTasks;
+	if (numOfThreads < 1)
+		numOfThreads = 1;
+
+	pthread_t *threads = new pthread_t[numOfThreads];
+	Worker *workers = new Worker[numOfThreads];
+	Bool *started = new Bool[numOfThreads];
+
+	for (int t = 0; t < numOfThreads; t++)
+	{
+		workers[t].queue = &q;
+		workers[t].thread = t;
+		started[t] = (t > 0 && pthread_create(&threads[t], NULL, RunWorker, &workers[t]) == 0);
+	}
+	RunWorker(&workers[0]);
+
+	for (int t = 1; t < numOfThreads; t++)
+	{
+		if (started[t])
+			pthread_join(threads[t], NULL);
+	}
+
+	pthread_mutex_destroy(&q.lock);
+	delete [] threads;
+	delete [] workers;
+	delete [] started;
+}
+
+
+//--------------------------------------------------------------------
+// RadixOf
+//
+// Return   : the bits of the hash of key from shift on, under mask.
+//            Partitioning passes and the hash tables of partitions
+//            each use their own bits.
+//--------------------------------------------------------------------
+
+static inline int RadixOf(int key, int shift, int mask)
+{
+	return (HashInt(key) >> shift) & mask;
+}
+
+
+static void Histogram(const RadixTuple *in, int n, int shift, int mask, int *hist)
+{
+	for (int p = 0; p <= mask; p++)
+		hist[p] = 0;
+	for (int i = 0; i < n; i++)
+		hist[RadixOf(in[i].key, shift, mask)]++;
+}
+
+
+//--------------------------------------------------------------------
+// Scatter
+//
+// Purpose  : copy n tuples to the partitions of out they belong to.
+//            Tuples are first gathered in a buffer of one cache line
+//            per partition, which is copied to out when full: the
+//            writes to out are then a cache line at a time, and the
+//            buffers, unlike out, stay in cache however many
+//            partitions there are.
+// Input    : offsets - where the next tuple of each partition goes.
+// Output   : offsets - moved past the tuples written.
+//--------------------------------------------------------------------
+
+static void Scatter(const RadixTuple *in, int n, int shift, int mask, RadixTuple *out, int *offsets)
+{
+	int fanOut = mask + 1;
+	char *mem = new char[(fanOut + 1) * RADIX_CACHE_LINE];
+	RadixTuple *lines = (RadixTuple *)(((size_t)mem + RADIX_CACHE_LINE - 1)
+	                                   & ~(size_t)(RADIX_CACHE_LINE - 1));
+	int *fill = new int[fanOut];
+
+	for (int p = 0; p < fanOut; p++)
+		fill[p] = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		int p = RadixOf(in[i].key, shift, mask);
+		RadixTuple *line = lines + p*RADIX_TUPLES_PER_LINE;
+
+		line[fill[p]++] = in[i];
+		if (fill[p] == RADIX_TUPLES_PER_LINE)
+		{
+			memcpy(out + offsets[p], line, RADIX_CACHE_LINE);
+			offsets[p] += RADIX_TUPLES_PER_LINE;
+			fill[p] = 0;
+		}
+	}
+
+	for (int p = 0; p < fanOut; p++)
+	{
+		memcpy(out + offsets[p], lines + p*RADIX_TUPLES_PER_LINE, fill[p] * sizeof(RadixTuple));
+		offsets[p] += fill[p];
+	}
+
+	delete [] fill;
+	delete [] mem;
+}
+
+
+//--------------------------------------------------------------------
+// A pass that partitions all of in, each thread taking a chunk of it.
+// hist holds, for each chunk, the number of its tuples in each
+// partition, then where the first of them goes in out.
+//--------------------------------------------------------------------
+
+struct PartitionPass
+{
+	const RadixTuple *in;
+	RadixTuple       *out;
+	int               n;
+	int               shift;
+	int               mask;
+	int               numOfChunks;
+	int              *hist;
+};
+
+static int ChunkStart(PartitionPass *pass, int chunk)
+{
+	return (int)((long)pass->n * chunk / pass->numOfChunks);
+}
+
+static void CountChunk(void *ctx, int, int chunk)
+{
+	PartitionPass *pass = (PartitionPass *)ctx;
+	int from = ChunkStart(pass, chunk);
+
+	Histogram(pass->in + from, ChunkStart(pass, chunk + 1) - from,
+	          pass->shift, pass->mask, pass->hist + chunk*(pass->mask + 1));
+}
+
+static void ScatterChunk(void *ctx, int, int chunk)
+{
+	PartitionPass *pass = (PartitionPass *)ctx;
+	int from = ChunkStart(pass, chunk);
+
+	Scatter(pass->in + from, ChunkStart(pass, chunk + 1) - from,
+	        pass->shift, pass->mask, pass->out, pass->hist + chunk*(pass->mask + 1));
+}
+
+
+//--------------------------------------------------------------------
+// PartitionAll
+//
+// Purpose  : partition in on bits bits of the hash from shift on, with
+//            numOfThreads threads.
+// Output   : out - the tuples of partition p are from start[p] up to
+//            start[p + 1].
+//--------------------------------------------------------------------
+
+static void PartitionAll(const RadixTuple *in, RadixTuple *out, int n, int shift, int bits,
+                         int numOfThreads, int *start)
+{
+	int fanOut = 1 << bits;
+	PartitionPass pass;
+
+	pass.in = in;
+	pass.out = out;
+	pass.n = n;
+	pass.shift = shift;
+	pass.mask = fanOut - 1;
+	pass.numOfChunks = numOfThreads;
+	pass.hist = new int[numOfThreads * fanOut];
+
+	RunTasks(numOfThreads, numOfThreads, CountChunk, &pass);
+
+	// Partition by partition, the tuples of each chunk in turn.
+
+	int offset = 0;
+	for (int p = 0; p < fanOut; p++)
+	{
+		start[p] = offset;
+		for (int c = 0; c < numOfThreads; c++)
+		{
+			int count = pass.hist[c*fanOut + p];
+			pass.hist[c*fanOut + p] = offset;
+			offset += count;
+		}
+	}
+	start[fanOut] = n;
+
+	RunTasks(numOfThreads, numOfThreads, ScatterChunk, &pass);
+	delete [] pass.hist;
+}
+
+
+//--------------------------------------------------------------------
+// The second pass of a partitioning, which partitions each partition
+// of the first one again, a task per partition.
+//--------------------------------------------------------------------
+
+struct SubPartitionPass
+{
+	const RadixTuple *in;
+	RadixTuple       *out;
+	const int        *startIn;
+	int              *start;
+	int               shift;
+	int               mask;
+};
+
+static void SubPartition(void *ctx, int, int task)
+{
+	SubPartitionPass *pass = (SubPartitionPass *)ctx;
+	int fanOut = pass->mask + 1;
+	int from = pass->startIn[task];
+	int n = pass->startIn[task + 1] - from;
+	int *offsets = new int[fanOut];
+
+	Histogram(pass->in + from, n, pass->shift, pass->mask, offsets);
+
+	int offset = from;
+	for (int p = 0; p < fanOut; p++)
+	{
+		int count = offsets[p];
+		offsets[p] = offset;
+		pass->start[task*fanOut + p] = offset;
+		offset += count;
+	}
+
+	Scatter(pass->in + from, n, pass->shift, pass->mask, pass->out, offsets);
+	delete [] offsets;
+}
+
+
+//--------------------------------------------------------------------
+// Partition
+//
+// Purpose  : partition in on the first bits1 + bits2 bits of the hash
+//            of the keys, in one pass on bits1 bits if bits2 is 0, and
+//            in two otherwise.
+// Output   : start - the tuples of partition p are from start[p] up to
+//            start[p + 1] of the array returned.
+// Return   : a new array with the tuples of in, by partition.
+//--------------------------------------------------------------------
+
+static RadixTuple *Partition(const RadixTuple *in, int n, int bits1, int bits2,
+                             int numOfThreads, int *start)
+{
+	RadixTuple *out = new RadixTuple[n > 0 ? n : 1];
+
+	if (bits2 == 0)
+	{
+		PartitionAll(in, out, n, 0, bits1, numOfThreads, start);
+		return out;
+	}
+
+	RadixTuple *firstPass = new RadixTuple[n > 0 ? n : 1];
+	int *startFirst = new int[(1 << bits1) + 1];
+	PartitionAll(in, firstPass, n, 0, bits1, numOfThreads, startFirst);
+
+	SubPartitionPass pass;
+	pass.in = firstPass;
+	pass.out = out;
+	pass.startIn = startFirst;
+	pass.start = start;
+	pass.shift = bits1;
+	pass.mask = (1 << bits2) - 1;
+	RunTasks(numOfThreads, 1 << bits1, SubPartition, &pass);
+	start[1 << (bits1 + bits2)] = n;
+
+	delete [] firstPass;
+	delete [] startFirst;
+	return out;
+}
+
+
+//--------------------------------------------------------------------
+// The matches found by one thread.
+//--------------------------------------------------------------------
+
+struct MatchList
+{
+	RadixMatch *matches;
+	long        numOfMatches;
+	long        size;
+};
+
+static void AddMatch(MatchList& list, int indexR, int indexS)
+{
+	if (list.numOfMatches == list.size)
+	{
+		RadixMatch *matches = new RadixMatch[2 * list.size];
+
+		memcpy(matches, list.matches, list.numOfMatches * sizeof(RadixMatch));
+		delete [] list.matches;
+		list.matches = matches;
+		list.size *= 2;
+	}
+	list.matches[list.numOfMatches].indexR = indexR;
+	list.matches[list.numOfMatches].indexS = indexS;
+	list.numOfMatches++;
+}
+
+
+//--------------------------------------------------------------------
+// The join of the partitions of the build and probe relations, a task
+// per pair of partitions.  The hash tables use the bits of the hash
+// past those the partitions were made on.
+//--------------------------------------------------------------------
+
+struct JoinPass
+{
+	const RadixTuple *build;
+	const RadixTuple *probe;
+	const int        *startBuild;
+	const int        *startProbe;
+	int               shift;
+	Bool              buildOnR;
+	MatchList        *lists;
+};
+
+static void JoinPartition(void *ctx, int thread, int task)
+{
+	JoinPass *pass = (JoinPass *)ctx;
+	const RadixTuple *build = pass->build + pass->startBuild[task];
+	const RadixTuple *probe = pass->probe + pass->startProbe[task];
+	int numOfBuild = pass->startBuild[task + 1] - pass->startBuild[task];
+	int numOfProbe = pass->startProbe[task + 1] - pass->startProbe[task];
+	MatchList& list = pass->lists[thread];
+
+	if (numOfBuild == 0 || numOfProbe == 0)
+		return;
+
+	int numOfBuckets = 1;
+	while (numOfBuckets < numOfBuild)
+		numOfBuckets *= 2;
+	int mask = numOfBuckets - 1;
+
+	// Chained by index: head[b] is the last tuple put in bucket b, and
+	// next[i] the one put there before tuple i, or -1.
+
+	int *head = new int[numOfBuckets];
+	int *next = new int[numOfBuild];
+
+	for (int b = 0; b < numOfBuckets; b++)
+		head[b] = -1;
+	for (int i = 0; i < numOfBuild; i++)
+	{
+		int b = RadixOf(build[i].key, pass->shift, mask);
+		next[i] = head[b];
+		head[b] = i;
+	}
+
+	for (int j = 0; j < numOfProbe; j++)
+	{
+		int key = probe[j].key;
+
+		for (int i = head[RadixOf(key, pass->shift, mask)]; i >= 0; i = next[i])
+		{
+			if (build[i].key != key)
+				continue;
+			if (pass->buildOnR)
+				AddMatch(list, build[i].index, probe[j].index);
+			else
+				AddMatch(list, probe[j].index, build[i].index);
+		}
+	}
+
+	delete [] head;
+	delete [] next;
+}
+
+
+//--------------------------------------------------------------------
+// RadixBits
+//
+// Return   : the number of bits of the hash to partition on, so that a
+//            partition of the build relation and its hash table -- a
+//            tuple, a bucket and a link per record -- fit in
+//            RADIX_CACHE_SIZE, and that there are partitions enough to
+//            share out between threads.
+//--------------------------------------------------------------------
+
+static int RadixBits(int numOfBuild, int numOfThreads)
+{
+	long bytes = (long)numOfBuild * (sizeof(RadixTuple) + 2*sizeof(int));
+	int bits = 0;
+
+	while (bits < 2*RADIX_MAX_BITS_PER_PASS
+	       && ((bytes >> bits) > RADIX_CACHE_SIZE
+	           || (numOfThreads > 1 && (1 << bits) < 4*numOfThreads)))
+		bits++;
+	return bits;
+}
+
+
+//--------------------------------------------------------------------
+// RadixJoinTuples
+//
+// Purpose  : join the tuples of r and s with equal keys.  Both are
+//            partitioned on the bits RadixBits picks, in one pass if
+//            there are at most RADIX_MAX_BITS_PER_PASS of them and in
+//            two otherwise, and each pair of partitions is joined by
+//            building a hash table on the partition of the relation
+//            with fewer tuples and probing it with the other.
+// Input    : r, s - the tuples, numOfR and numOfS of them.
+//            numOfThreads - threads that share out each pass.
+// Output   : matches - a new array of the pairs of tuples that join.
+// Return   : the number of matches.
+//--------------------------------------------------------------------
+
+long RadixJoinTuples(const RadixTuple *r, int numOfR, const RadixTuple *s, int numOfS,
+                     int numOfThreads, RadixMatch *&matches)
+{
+	if (numOfThreads < 1)
+		numOfThreads = 1;
+
+	JoinPass pass;
+	pass.buildOnR = numOfR <= numOfS;
+
+	const RadixTuple *build = pass.buildOnR ? r : s;
+	const RadixTuple *probe = pass.buildOnR ? s : r;
+	int numOfBuild = pass.buildOnR ? numOfR : numOfS;
+	int numOfProbe = pass.buildOnR ? numOfS : numOfR;
+
+	int bits = RadixBits(numOfBuild, numOfThreads);
+	int bits1 = (bits > RADIX_MAX_BITS_PER_PASS) ? (bits + 1) / 2 : bits;
+	int bits2 = bits - bits1;
+	int numOfParts = 1 << bits;
+
+	int *startBuild = new int[numOfParts + 1];
+	int *startProbe = new int[numOfParts + 1];
+	RadixTuple *partBuild = Partition(build, numOfBuild, bits1, bits2, numOfThreads, startBuild);
+	RadixTuple *partProbe = Partition(probe, numOfProbe, bits1, bits2, numOfThreads, startProbe);
+
+	pass.build = partBuild;
+	pass.probe = partProbe;
+	pass.startBuild = startBuild;
+	pass.startProbe = startProbe;
+	pass.shift = bits;
+	pass.lists = new MatchList[numOfThreads];
+	for (int t = 0; t < numOfThreads; t++)
+	{
+		pass.lists[t].size = 1024;
+		pass.lists[t].numOfMatches = 0;
+		pass.lists[t].matches = new RadixMatch[pass.lists[t].size];
+	}
+
+	RunTasks(numOfThreads, numOfParts, JoinPartition, &pass);
+
+	long numOfMatches = 0;
+	for (int t = 0; t < numOfThreads; t++)
+		numOfMatches += pass.lists[t].numOfMatches;
+
+	matches = new RadixMatch[numOfMatches > 0 ? numOfMatches : 1];
+	numOfMatches = 0;
+	for (int t = 0; t < numOfThreads; t++)
+	{
+		memcpy(matches + numOfMatches, pass.lists[t].matches,
+		       pass.lists[t].numOfMatches * sizeof(RadixMatch));
+		numOfMatches += pass.lists[t].numOfMatches;
+		delete [] pass.lists[t].matches;
+	}
+
+	delete [] pass.lists;
+	delete [] partBuild;
+	delete [] partProbe;
+	delete [] startBuild;
+	delete [] startProbe;
+	return numOfMatches;
+}
+
+
+//--------------------------------------------------------------------
+// LoadRelation
+//
+// Purpose  : read every record of a relation into memory.
+// Output   : recs - a new array of its records, n of them.
+//            tuples - a new array of their join attributes, each with
+//                     the index of its record in recs.
+// Return   : OK if successful, FAIL otherwise.
+//--------------------------------------------------------------------
+
+static Status LoadRelation(JoinSpec spec, char *&recs, RadixTuple *&tuples, int& n)
+{
+	Status s;
+	Scan *scan = spec.file->OpenScan(s);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot open scan on " << spec.relName << ".\n";
+		return FAIL;
+	}
+
+	int size = spec.file->GetNumOfRecords();
+	int recLen = spec.recLen;
+	RecordID rid;
+
+	recs = new char[(size > 0 ? size : 1) * recLen];
+	tuples = new RadixTuple[size > 0 ? size : 1];
+	n = 0;
+	while (n < size && scan->GetNext(rid, recs + n*spec.recLen, recLen) == OK)
+	{
+		memcpy(&tuples[n].key, recs + n*spec.recLen + spec.offset, sizeof(int));
+		tuples[n].index = n;
+		n++;
+	}
+	delete scan;
+	return OK;
+}
+
+
+// Seconds since the epoch.  Unlike clock(), which adds up the time of
+// every thread of the process, this is the time the join takes.
+
+static double WallClock()
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+
+//--------------------------------------------------------------------
+// RadixHashJoin
+//
+// Purpose  : join R and S in memory, like HashJoin, but partitioning
+//            both relations first so that each hash table fits in
+//            cache, and sharing the work out between numOfThreads
+//            threads.  Both relations are read into memory, and the
+//            result written, by the calling thread only, since the
+//            buffer manager is not made for more.  duration is wall
+//            clock time.
+//--------------------------------------------------------------------
+
+HeapFile* RadixHashJoin(JoinSpec specOfR, JoinSpec specOfS, int numOfThreads, long& pinRequests, long& pinMisses, double& duration)
+{
+	double begin = WallClock();
+	Status status = OK;
+	HeapFile* T = new HeapFile(NULL,status);
+	if (status != OK){
+		cerr << "ERROR: cannot create a file for the joined relations.\n";
+		return NULL;
+	}
+
+	char *recsR = NULL, *recsS = NULL;
+	RadixTuple *tuplesR = NULL, *tuplesS = NULL;
+	int numOfR, numOfS;
+
+	status = LoadRelation(specOfR, recsR, tuplesR, numOfR);
+	if (status == OK)
+		status = LoadRelation(specOfS, recsS, tuplesS, numOfS);
+	if (status != OK){
+		cerr << "ERROR: cannot join " << specOfR.relName << " and " << specOfS.relName << ".\n";
+		delete [] recsR;
+		delete [] tuplesR;
+		delete T;
+		return NULL;
+	}
+
+	RadixMatch *matches;
+	long numOfMatches = RadixJoinTuples(tuplesR, numOfR, tuplesS, numOfS, numOfThreads, matches);
+	delete [] tuplesR;
+	delete [] tuplesS;
+
+	int recLenR = specOfR.recLen;
+	int recLenS = specOfS.recLen;
+	char *recNew = new char[recLenR + recLenS];
+	RecordID ridNew;
+
+	for (long i = 0; i < numOfMatches; i++)
+	{
+		MakeNewRecord(recNew, recsR + matches[i].indexR*recLenR,
+		              recsS + matches[i].indexS*recLenS, recLenR, recLenS);
+		T->InsertRecord(recNew, recLenR + recLenS, ridNew);
+	}
+
+	delete [] recNew;
+	delete [] matches;
+	delete [] recsR;
+	delete [] recsS;
+
+	MINIBASE_BM->GetStat(pinRequests,pinMisses);
+
+	duration = WallClock() - begin;
+	return T;
+}
@@ -9,6 +9,7 @@
 #include "../include/join.h"
 #include "../include/relation.h"
 #include "../include/bufmgr.h"
+#include "../include/extsort.h"
 
 //---------------------------------------------------------------
 // Each join method takes in at least two parameters :
@@ -27,6 +28,103 @@
 // you have opened.
 //---------------------------------------------------------------
 
-void SortMergeJoin (JoinSpec specOfR, JoinSpec specOfS, long& pinRequests, long& pinMisses, double& duration)
+//--------------------------------------------------------------------
+// SortMergeJoin
+//
+// Purpose  : join R and S by sorting both on the join attribute and
+//            merging them.  Each is sorted by an ExternalSortScan in a
+//            quarter of the buffer pool, and its last merge is joined
+//            as it is read rather than written out first.  The records
+//            of S with the key of the current record of R are kept in
+//            memory, and joined with every record of R with that key.
+//--------------------------------------------------------------------
+
+HeapFile* SortMergeJoin(JoinSpec specOfR, JoinSpec specOfS, long& pinRequests, long& pinMisses, double& duration)
 {
+	clock_t begin = clock();
+	Status status = OK;
+	HeapFile* T = new HeapFile(NULL,status);
+	if (status != OK){
+		cerr << "ERROR: cannot create a file for the joined relations.\n";
+		return NULL;
+	}
+
+	int numOfPages = MINIBASE_BM->GetNumOfBuffers() / 4;
+	ExternalSortScan *sortedR = new ExternalSortScan(specOfR.file, specOfR.recLen, specOfR.offset, numOfPages, status);
+	ExternalSortScan *sortedS = NULL;
+	if (status == OK)
+		sortedS = new ExternalSortScan(specOfS.file, specOfS.recLen, specOfS.offset, numOfPages, status);
+	if (status != OK){
+		cerr << "ERROR: cannot sort " << specOfR.relName << " and " << specOfS.relName << ".\n";
+		delete sortedR;
+		delete sortedS;
+		delete T;
+		return NULL;
+	}
+
+	int recLenR = specOfR.recLen;
+	int recLenS = specOfS.recLen;
+	char *recNew = new char[recLenR + recLenS];
+	RecordID ridNew;
+
+	// The records of S with the same key.
+	int groupSize = 16;
+	char *group = new char[groupSize * recLenS];
+
+	char *r, *s;
+	int keyR, keyS;
+	Status moreR = sortedR->GetNext(r, keyR);
+	Status moreS = sortedS->GetNext(s, keyS);
+
+	while (moreR == OK && moreS == OK)
+	{
+		if (keyR < keyS)
+		{
+			moreR = sortedR->GetNext(r, keyR);
+			continue;
+		}
+		if (keyS < keyR)
+		{
+			moreS = sortedS->GetNext(s, keyS);
+			continue;
+		}
+
+		int key = keyS;
+		int groupLen = 0;
+		while (moreS == OK && keyS == key)
+		{
+			if (groupLen == groupSize)
+			{
+				char *bigger = new char[2 * groupSize * recLenS];
+				memcpy(bigger, group, groupSize * recLenS);
+				delete [] group;
+				group = bigger;
+				groupSize *= 2;
+			}
+			memcpy(group + groupLen*recLenS, s, recLenS);
+			groupLen++;
+			moreS = sortedS->GetNext(s, keyS);
+		}
+
+		while (moreR == OK && keyR == key)
+		{
+			for (int i = 0; i < groupLen; i++)
+			{
+				MakeNewRecord(recNew, r, group + i*recLenS, recLenR, recLenS);
+				T->InsertRecord(recNew, recLenR + recLenS, ridNew);
+			}
+			moreR = sortedR->GetNext(r, keyR);
+		}
+	}
+
+	delete [] group;
+	delete [] recNew;
+	delete sortedR;
+	delete sortedS;
+
+	MINIBASE_BM->GetStat(pinRequests,pinMisses);
+
+	clock_t end = clock();
+	duration = float(end - begin)/CLOCKS_PER_SEC;
+	return T;
 }
@@ -0,0 +1,594 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/minirel.h"
+#include "../include/heapfile.h"
+#include "../include/scan.h"
+#include "../include/join.h"
+#include "../include/inthash.h"
+#include "../include/vectorop.h"
+
+
+ColumnBatch::ColumnBatch(int numOfCols, int capacity)
+{
+	this->numOfCols = numOfCols;
+	this->capacity = capacity;
+	for (int c = 0; c < numOfCols; c++)
+		cols[c] = new int[capacity];
+	sel = new int[capacity];
+	SetNumOfRows(0);
+}
+
+
+ColumnBatch::~ColumnBatch()
+{
+	for (int c = 0; c < numOfCols; c++)
+		delete [] cols[c];
+	delete [] sel;
+}
+
+
+//--------------------------------------------------------------------
+// VecScanOp
+//--------------------------------------------------------------------
+
+VecScanOp::VecScanOp(HeapFile *file, int recLen)
+{
+	this->file = file;
+	this->recLen = recLen;
+	numOfCols = recLen / sizeof(int);
+	scan = NULL;
+	rec = new int[numOfCols];
+}
+
+
+VecScanOp::~VecScanOp()
+{
+	delete scan;
+	delete [] rec;
+}
+
+
+Status VecScanOp::Open()
+{
+	Status s;
+
+	delete scan;
+	scan = file->OpenScan(s);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot open scan on a heapfile.\n";
+		scan = NULL;
+		return FAIL;
+	}
+	return OK;
+}
+
+
+Status VecScanOp::Next(ColumnBatch& batch)
+{
+	RecordID rid;
+	int len = recLen;
+	int n = 0;
+
+	while (scan != NULL && n < batch.GetCapacity())
+	{
+		if (scan->GetNext(rid, (char *)rec, len) != OK)
+		{
+			delete scan;
+			scan = NULL;
+			break;
+		}
+		for (int c = 0; c < numOfCols; c++)
+			batch.Column(c)[n] = rec[c];
+		n++;
+	}
+	batch.SetNumOfRows(n);
+	return (n > 0) ? OK : DONE;
+}
+
+
+Status VecScanOp::Close()
+{
+	delete scan;
+	scan = NULL;
+	return OK;
+}
+
+
+//--------------------------------------------------------------------
+// VecFilterOp
+//
+// The filter narrows the selection of the batches of child in place.
+// Every row is written to the selection, and the end of the selection
+// only moves past it if it passes, so that the loop has no branch for
+// the compiler to mispredict.
+//--------------------------------------------------------------------
+
+#define SELECT_ROWS(cmp)                                     \
+	if (selIn == NULL)                                       \
+		for (int i = 0; i < n; i++)                          \
+		{                                                    \
+			selOut[k] = i;                                   \
+			k += (col[i] cmp value);                         \
+		}                                                    \
+	else                                                     \
+		for (int j = 0; j < n; j++)                          \
+		{                                                    \
+			int i = selIn[j];                                \
+			selOut[k] = i;                                   \
+			k += (col[i] cmp value);                         \
+		}
+
+
+//--------------------------------------------------------------------
+// SelectRows
+//
+// Purpose  : select the rows of a column whose value is op value.
+// Input    : col - the column.
+//            selIn - the rows to look at, NULL for rows 0 to n - 1.
+//            n - the number of rows to look at.
+// Output   : selOut - the rows that pass, which may be selIn.
+// Return   : the number of rows that pass.
+//--------------------------------------------------------------------
+
+static int SelectRows(const int *col, const int *selIn, int n, AttrOperator op, int value, int *selOut)
+{
+	int k = 0;
+
+	switch (op)
+	{
+	case aopEQ: SELECT_ROWS(==); break;
+	case aopLT: SELECT_ROWS(<);  break;
+	case aopGT: SELECT_ROWS(>);  break;
+	case aopNE: SELECT_ROWS(!=); break;
+	case aopLE: SELECT_ROWS(<=); break;
+	case aopGE: SELECT_ROWS(>=); break;
+	default:
+		for (int j = 0; j < n; j++)
+			selOut[j] = (selIn == NULL) ? j : selIn[j];
+		k = n;
+	}
+	return k;
+}
+
+
+VecFilterOp::VecFilterOp(VecOperator *child, int col, AttrOperator op, int value)
+{
+	this->child = child;
+	this->col = col;
+	this->op = op;
+	this->value = value;
+	numOfCols = child->GetNumOfCols();
+}
+
+
+VecFilterOp::~VecFilterOp()
+{
+	delete child;
+}
+
+
+Status VecFilterOp::Open()
+{
+	return child->Open();
+}
+
+
+Status VecFilterOp::Next(ColumnBatch& batch)
+{
+	while (child->Next(batch) == OK)
+	{
+		int n = SelectRows(batch.Column(col), batch.GetSelection(), batch.GetNumOfSelected(),
+		                   op, value, batch.SelectionVector());
+		batch.SetSelection(n);
+		if (n > 0)
+			return OK;
+	}
+	batch.SetNumOfRows(0);
+	return DONE;
+}
+
+
+Status VecFilterOp::Close()
+{
+	return child->Close();
+}
+
+
+//--------------------------------------------------------------------
+// The rows of the build operator, a column at a time, grouped by
+// bucket as in the JoinHashTable of HashJoin: the rows of bucket b are
+// start[b] up to start[b+1] - 1, and keys is the column joined on.
+//--------------------------------------------------------------------
+
+struct VecHashTable
+{
+	unsigned int mask;  // number of buckets - 1
+	int         *start;
+	int          numOfCols;
+	int         *cols[VEC_MAX_COLS];
+	int         *keys;
+};
+
+
+VecHashJoinOp::VecHashJoinOp(VecOperator *probe, int probeCol, VecOperator *build, int buildCol)
+	: probeBatch(probe->GetNumOfCols())
+{
+	this->probe = probe;
+	this->build = build;
+	this->probeCol = probeCol;
+	this->buildCol = buildCol;
+	numOfCols = probe->GetNumOfCols() + build->GetNumOfCols();
+
+	table = NULL;
+	buckets = new int[VEC_BATCH_SIZE];
+	matchProbe = new int[VEC_BATCH_SIZE];
+	matchBuild = new int[VEC_BATCH_SIZE];
+}
+
+
+VecHashJoinOp::~VecHashJoinOp()
+{
+	Close();
+	delete [] buckets;
+	delete [] matchProbe;
+	delete [] matchBuild;
+	delete probe;
+	delete build;
+}
+
+
+//--------------------------------------------------------------------
+// VecHashJoinOp::Open
+//
+// The selected rows of build are appended to columns that double in
+// size as they fill up, and then placed by bucket into the table with
+// a counting sort.
+//--------------------------------------------------------------------
+
+Status VecHashJoinOp::Open()
+{
+	if (build->Open() != OK)
+		return FAIL;
+
+	int numOfBuildCols = build->GetNumOfCols();
+	ColumnBatch in(numOfBuildCols);
+	int *cols[VEC_MAX_COLS];
+	int size = VEC_BATCH_SIZE;
+	int numOfRows = 0;
+
+	for (int c = 0; c < numOfBuildCols; c++)
+		cols[c] = new int[size];
+
+	while (build->Next(in) == OK)
+	{
+		int n = in.GetNumOfSelected();
+		int *sel = in.GetSelection();
+
+		if (numOfRows + n > size)
+		{
+			for (int c = 0; c < numOfBuildCols; c++)
+			{
+				int *col = new int[2 * size];
+				memcpy(col, cols[c], numOfRows * sizeof(int));
+				delete [] cols[c];
+				cols[c] = col;
+			}
+			size *= 2;
+		}
+		for (int c = 0; c < numOfBuildCols; c++)
+		{
+			int *from = in.Column(c);
+			int *to = cols[c] + numOfRows;
+
+			if (sel == NULL)
+				memcpy(to, from, n * sizeof(int));
+			else
+				for (int j = 0; j < n; j++)
+					to[j] = from[sel[j]];
+		}
+		numOfRows += n;
+	}
+	build->Close();
+
+	int numOfBuckets = 1;
+	while (numOfBuckets < numOfRows)
+		numOfBuckets *= 2;
+
+	table = new VecHashTable;
+	table->mask = numOfBuckets - 1;
+	table->numOfCols = numOfBuildCols;
+	table->start = new int[numOfBuckets + 1];
+	for (int c = 0; c < numOfBuildCols; c++)
+		table->cols[c] = new int[numOfRows > 0 ? numOfRows : 1];
+	table->keys = table->cols[buildCol];
+
+	int *bucketOf = new int[numOfRows > 0 ? numOfRows : 1];
+	int *keys = cols[buildCol];
+
+	memset(table->start, 0, (numOfBuckets + 1)*sizeof(int));
+	for (int i = 0; i < numOfRows; i++)
+	{
+		bucketOf[i] = HashInt(keys[i]) & table->mask;
+		table->start[bucketOf[i] + 1]++;
+	}
+	for (int b = 0; b < numOfBuckets; b++)
+		table->start[b + 1] += table->start[b];
+
+	// start[b] is the next free row of bucket b while the rows are
+	// placed, and ends up where bucket b + 1 begins.
+
+	for (int i = 0; i < numOfRows; i++)
+	{
+		int pos = table->start[bucketOf[i]]++;
+		for (int c = 0; c < numOfBuildCols; c++)
+			table->cols[c][pos] = cols[c][i];
+	}
+	for (int b = numOfBuckets; b > 0; b--)
+		table->start[b] = table->start[b - 1];
+	table->start[0] = 0;
+
+	delete [] bucketOf;
+	for (int c = 0; c < numOfBuildCols; c++)
+		delete [] cols[c];
+
+	probeBatch.SetNumOfRows(0);
+	probeDone = FALSE;
+	probePos = 0;
+	tablePos = tableEnd = 0;
+	return probe->Open();
+}
+
+
+//--------------------------------------------------------------------
+// VecHashJoinOp::Next
+//
+// Works in three loops over a batch: the buckets of all the selected
+// rows of a batch of probe are hashed at once, when it is read; the
+// pairs of rows that match are then listed, every row of a bucket
+// being written to the list and the end of the list only moving past
+// it if its key is equal; and the columns of the result are gathered
+// from the list one at a time.  A bucket whose matches do not fit the
+// batch is carried over to the next call.
+//--------------------------------------------------------------------
+
+Status VecHashJoinOp::Next(ColumnBatch& batch)
+{
+	int capacity = batch.GetCapacity();
+	int k = 0;
+
+	if (table == NULL)
+	{
+		batch.SetNumOfRows(0);
+		return DONE;
+	}
+
+	while (k < capacity)
+	{
+		if (tablePos < tableEnd)
+		{
+			const int *keys = table->keys;
+			int end = tablePos + (capacity - k);
+			if (end > tableEnd)
+				end = tableEnd;
+
+			for (int i = tablePos; i < end; i++)
+			{
+				matchProbe[k] = probeRow;
+				matchBuild[k] = i;
+				k += (keys[i] == probeKey);
+			}
+			tablePos = end;
+			continue;
+		}
+
+		if (probePos == probeBatch.GetNumOfSelected())
+		{
+			// The pairs listed so far point into probeBatch, so they
+			// are given out before it is read over.
+			if (k > 0 || probeDone)
+				break;
+			if (probe->Next(probeBatch) != OK)
+			{
+				probeBatch.SetNumOfRows(0);
+				probeDone = TRUE;
+				break;
+			}
+
+			int n = probeBatch.GetNumOfSelected();
+			int *sel = probeBatch.GetSelection();
+			int *keys = probeBatch.Column(probeCol);
+
+			if (sel == NULL)
+				for (int j = 0; j < n; j++)
+					buckets[j] = HashInt(keys[j]) & table->mask;
+			else
+				for (int j = 0; j < n; j++)
+					buckets[j] = HashInt(keys[sel[j]]) & table->mask;
+			probePos = 0;
+		}
+
+		int *sel = probeBatch.GetSelection();
+		int b = buckets[probePos];
+
+		probeRow = (sel == NULL) ? probePos : sel[probePos];
+		probeKey = probeBatch.Column(probeCol)[probeRow];
+		probePos++;
+		tablePos = table->start[b];
+		tableEnd = table->start[b + 1];
+	}
+
+	int numOfProbeCols = probeBatch.GetNumOfCols();
+	for (int c = 0; c < numOfProbeCols; c++)
+	{
+		int *from = probeBatch.Column(c);
+		int *to = batch.Column(c);
+		for (int j = 0; j < k; j++)
+			to[j] = from[matchProbe[j]];
+	}
+	for (int c = 0; c < table->numOfCols; c++)
+	{
+		int *from = table->cols[c];
+		int *to = batch.Column(numOfProbeCols + c);
+		for (int j = 0; j < k; j++)
+			to[j] = from[matchBuild[j]];
+	}
+	batch.SetNumOfRows(k);
+	return (k > 0) ? OK : DONE;
+}
+
+
+Status VecHashJoinOp::Close()
+{
+	if (table == NULL)
+		return OK;
+
+	delete [] table->start;
+	for (int c = 0; c < table->numOfCols; c++)
+		delete [] table->cols[c];
+	delete table;
+	table = NULL;
+	return probe->Close();
+}
+
+
+//--------------------------------------------------------------------
+// VecHashAggregate
+//--------------------------------------------------------------------
+
+#define VEC_AGG_INITIAL_GROUPS 64
+
+VecHashAggregate::VecHashAggregate(VecOperator *child, int groupCol, int sumCol)
+{
+	this->child = child;
+	this->groupCol = groupCol;
+	this->sumCol = sumCol;
+	numOfGroups = 0;
+	groups = NULL;
+	counts = NULL;
+	sums = NULL;
+	slots = NULL;
+	mask = 0;
+}
+
+
+VecHashAggregate::~VecHashAggregate()
+{
+	delete [] groups;
+	delete [] counts;
+	delete [] sums;
+	delete [] slots;
+	delete child;
+}
+
+
+//--------------------------------------------------------------------
+// VecHashAggregate::Grow
+//
+// Purpose  : double the room for groups, and the number of slots, so
+//            that at most half of the slots are taken.
+//--------------------------------------------------------------------
+
+void VecHashAggregate::Grow()
+{
+	int maxGroups = (slots == NULL) ? VEC_AGG_INITIAL_GROUPS : mask + 1;
+	int numOfSlots = 2 * maxGroups;
+
+	int *newGroups = new int[maxGroups];
+	long *newCounts = new long[maxGroups];
+	long *newSums = new long[maxGroups];
+
+	memcpy(newGroups, groups, numOfGroups * sizeof(int));
+	memcpy(newCounts, counts, numOfGroups * sizeof(long));
+	memcpy(newSums, sums, numOfGroups * sizeof(long));
+	delete [] groups;
+	delete [] counts;
+	delete [] sums;
+	groups = newGroups;
+	counts = newCounts;
+	sums = newSums;
+
+	delete [] slots;
+	slots = new int[numOfSlots];
+	mask = numOfSlots - 1;
+	for (int s = 0; s < numOfSlots; s++)
+		slots[s] = -1;
+	for (int g = 0; g < numOfGroups; g++)
+	{
+		unsigned int s = HashInt(groups[g]) & mask;
+		while (slots[s] != -1)
+			s = (s + 1) & mask;
+		slots[s] = g;
+	}
+}
+
+
+//--------------------------------------------------------------------
+// VecHashAggregate::Run
+//
+// The slots of the groups of a batch are looked up in one loop over
+// it, and their counts and sums added to in a second one.
+//--------------------------------------------------------------------
+
+Status VecHashAggregate::Run()
+{
+	numOfGroups = 0;
+	delete [] slots;
+	slots = NULL;
+	Grow();
+
+	if (child->Open() != OK)
+		return FAIL;
+
+	ColumnBatch batch(child->GetNumOfCols());
+	int *groupOf = new int[batch.GetCapacity()];
+
+	while (child->Next(batch) == OK)
+	{
+		int n = batch.GetNumOfSelected();
+		int *sel = batch.GetSelection();
+		int *keys = batch.Column(groupCol);
+		int *vals = batch.Column(sumCol);
+
+		for (int j = 0; j < n; j++)
+		{
+			int key = keys[(sel == NULL) ? j : sel[j]];
+			unsigned int s = HashInt(key) & mask;
+
+			while (slots[s] != -1 && groups[slots[s]] != key)
+				s = (s + 1) & mask;
+			if (slots[s] == -1)
+			{
+				if (2 * (numOfGroups + 1) > (int)(mask + 1))
+				{
+					Grow();
+					j--;
+					continue;
+				}
+				groups[numOfGroups] = key;
+				counts[numOfGroups] = 0;
+				sums[numOfGroups] = 0;
+				slots[s] = numOfGroups++;
+			}
+			groupOf[j] = slots[s];
+		}
+
+		if (sel == NULL)
+			for (int j = 0; j < n; j++)
+			{
+				counts[groupOf[j]]++;
+				sums[groupOf[j]] += vals[j];
+			}
+		else
+			for (int j = 0; j < n; j++)
+			{
+				counts[groupOf[j]]++;
+				sums[groupOf[j]] += vals[sel[j]];
+			}
+	}
+
+	delete [] groupOf;
+	return child->Close();
+}
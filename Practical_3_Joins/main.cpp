@@ -1,12 +1,17 @@
 #include <stdlib.h>
 #include <time.h>
 #include <ctype.h>
+#include <unistd.h>
 
 #include "include/minirel.h"
 #include "include/bufmgr.h"
 #include "include/heapfile.h"
 #include "include/join.h"
 #include "include/relation.h"
+#include "include/bloom.h"
+#include "include/operator.h"
+#include "include/vectorop.h"
+#include "include/planner.h"
 
 int MINIBASE_RESTART_FLAG = 0;// used in minibase part
 
@@ -76,6 +81,8 @@ int main()
 	long sum_request=0;
 	long sum_miss=0;
 	double sum_duration=0;
+	long measuredMisses[NUM_OF_JOIN_METHODS];
+	double measured[NUM_OF_JOIN_METHODS];
 	
 	/* tuple join */
 	for (int i = 0; i < REPEAT ; i++){
@@ -92,6 +99,7 @@ int main()
 		delete T;
 	}
     		cout << "Tuple " << sum_request/REPEAT << " " << sum_miss/REPEAT << " " << sum_duration / REPEAT << endl;
+    		measuredMisses[jmTuple] = sum_miss/REPEAT; measured[jmTuple] = sum_duration/REPEAT;
 		
 	/* block join */
 	sum_request = 0; sum_miss = 0;sum_duration = 0;
@@ -106,6 +114,8 @@ int main()
 		delete T;
 	}
 	cout << "Block " <<sum_request/REPEAT<< " " <<sum_miss/REPEAT << " " << sum_duration / REPEAT << endl;
+	measuredMisses[jmBlock] = sum_miss/REPEAT; measured[jmBlock] = sum_duration/REPEAT;
+	long blockPins = sum_request/REPEAT;
 	/* index join *
 	/* block join */
 	sum_request = 0; sum_miss = 0;sum_duration = 0;
@@ -120,6 +130,151 @@ int main()
 		delete T;
 	}
 	cout << "Index " <<sum_request/REPEAT<< " " <<sum_miss/REPEAT << " " << sum_duration / REPEAT << endl;
+	measuredMisses[jmIndex] = sum_miss/REPEAT; measured[jmIndex] = sum_duration/REPEAT;
+	long indexPins = sum_request/REPEAT;
+
+	/* sort-merge join */
+	sum_request = 0; sum_miss = 0;sum_duration = 0;
+	for (int i = 0; i < REPEAT; i++){
+		MINIBASE_BM->ResetStat();
+		HeapFile* T = SortMergeJoin(specOfR,specOfS, pinRequests, pinMisses, duration);
+		sum_request += pinRequests; 
+		sum_miss += pinMisses;
+		sum_duration += duration;
+		delete T;
+	}
+	cout << "SortMerge " <<sum_request/REPEAT<< " " <<sum_miss/REPEAT << " " << sum_duration / REPEAT << endl;
+	measuredMisses[jmSortMerge] = sum_miss/REPEAT; measured[jmSortMerge] = sum_duration/REPEAT;
+
+	/* hash join */
+	sum_request = 0; sum_miss = 0;sum_duration = 0;
+	for (int i = 0; i < REPEAT; i++){
+		MINIBASE_BM->ResetStat();
+		HeapFile* T = HashJoin(specOfR,specOfS, pinRequests, pinMisses, duration);
+		sum_request += pinRequests; 
+		sum_miss += pinMisses;
+		sum_duration += duration;
+		delete T;
+	}
+	cout << "Hash " <<sum_request/REPEAT<< " " <<sum_miss/REPEAT << " " << sum_duration / REPEAT << endl;
+	measuredMisses[jmHash] = sum_miss/REPEAT; measured[jmHash] = sum_duration/REPEAT;
+	long hashPins = sum_request/REPEAT;
+
+	/* hybrid hash join */
+	sum_request = 0; sum_miss = 0;sum_duration = 0;
+	for (int i = 0; i < REPEAT; i++){
+		MINIBASE_BM->ResetStat();
+		HeapFile* T = HybridHashJoin(specOfR,specOfS, pinRequests, pinMisses, duration);
+		sum_request += pinRequests; 
+		sum_miss += pinMisses;
+		sum_duration += duration;
+		delete T;
+	}
+	cout << "Hybrid " <<sum_request/REPEAT<< " " <<sum_miss/REPEAT << " " << sum_duration / REPEAT << endl;
+	measuredMisses[jmHybrid] = sum_miss/REPEAT; measured[jmHybrid] = sum_duration/REPEAT;
+
+	/* radix hash join, on every core */
+	sum_request = 0; sum_miss = 0;sum_duration = 0;
+	for (int i = 0; i < REPEAT; i++){
+		MINIBASE_BM->ResetStat();
+		int numOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
+		HeapFile* T = RadixHashJoin(specOfR,specOfS, numOfThreads, pinRequests, pinMisses, duration);
+		sum_request += pinRequests; 
+		sum_miss += pinMisses;
+		sum_duration += duration;
+		delete T;
+	}
+	cout << "Radix " <<sum_request/REPEAT<< " " <<sum_miss/REPEAT << " " << sum_duration / REPEAT << endl;
+	measuredMisses[jmRadix] = sum_miss/REPEAT; measured[jmRadix] = sum_duration/REPEAT;
+
+	/* the join the planner picks, against the one that was quickest */
+	RelationStats statsOfR, statsOfS;
+	JoinCost costs[NUM_OF_JOIN_METHODS];
+	GetRelationStats(specOfR, statsOfR);
+	GetRelationStats(specOfS, statsOfS);
+	JoinMethod pick = PlanJoin(statsOfR, statsOfS, MINIBASE_BM->GetNumOfBuffers(), sysconf(_SC_NPROCESSORS_ONLN), costs);
+	int fastest = 0;
+	for (int m = 0; m < NUM_OF_JOIN_METHODS; m++){
+		cout << "  plan " << GetJoinMethodName((JoinMethod)m) << " est " << costs[m].misses << " " << costs[m].time
+			<< " measured " << measuredMisses[m] << " " << measured[m] << endl;
+		if (measured[m] < measured[fastest]) fastest = m;
+	}
+	cout << "Planner picks " << GetJoinMethodName(pick) << " (" << measured[pick] << "s), quickest was "
+		<< GetJoinMethodName((JoinMethod)fastest) << " (" << measured[fastest] << "s)" << endl;
+
+	/* block, index and hash joins, skipping the records of R that a Bloom filter on S rules out */
+	const char *bloomNames[] = { "Block+Bloom", "Index+Bloom", "Hash+Bloom" };
+	long bloomBasePins[] = { blockPins, indexPins, hashPins };
+	for (int j = 0; j < 3; j++){
+		sum_request = 0; sum_miss = 0;sum_duration = 0;
+		double sum_passed = 0;
+		for (int i = 0; i < REPEAT; i++){
+			MINIBASE_BM->ResetStat();
+			clock_t begin = clock();
+			BloomFilter *filter = BuildBloomFilter(specOfS);
+			double buildDuration = float(clock() - begin)/CLOCKS_PER_SEC;
+			HeapFile* T;
+			if (j == 0){
+				int B = (MINIBASE_BM->GetNumOfBuffers()-3*3)*MINIBASE_PAGESIZE;
+				T = BlockNestedLoopJoin(specOfR,specOfS, B, pinRequests, pinMisses, duration, filter);
+			}
+			else if (j == 1)
+				T = IndexNestedLoopJoin(specOfR,specOfS, pinRequests, pinMisses, duration, filter);
+			else
+				T = HashJoin(specOfR,specOfS, pinRequests, pinMisses, duration, filter);
+			sum_request += pinRequests; 
+			sum_miss += pinMisses;
+			sum_duration += buildDuration + duration;
+			if (filter->GetNumOfLookups() > 0)
+				sum_passed += double(filter->GetNumOfPasses()) / filter->GetNumOfLookups();
+			delete filter;
+			delete T;
+		}
+		cout << bloomNames[j] << " " <<sum_request/REPEAT<< " " <<sum_miss/REPEAT << " " << sum_duration / REPEAT
+			<< " passed " << 100*sum_passed/REPEAT << "% saved " << bloomBasePins[j] - sum_request/REPEAT << " pins" << endl;
+	}
+
+	/* hash join piped straight into an aggregate, without writing the result to pages */
+	sum_request = 0; sum_miss = 0;sum_duration = 0;
+	long count = 0, sum = 0;
+	for (int i = 0; i < REPEAT; i++){
+		MINIBASE_BM->ResetStat();
+		clock_t begin = clock();
+		Operator *join = new HashJoinOp(new ScanOp(specOfR.file, specOfR.recLen), specOfR.offset,
+		                                new ScanOp(specOfS.file, specOfS.recLen), specOfS.offset);
+		Aggregate(join, specOfR.recLen + specOfS.offset, count, sum);
+		delete join;
+		duration = float(clock() - begin)/CLOCKS_PER_SEC;
+		MINIBASE_BM->GetStat(pinRequests, pinMisses);
+		sum_request += pinRequests; 
+		sum_miss += pinMisses;
+		sum_duration += duration;
+	}
+	cout << "Pipelined " <<sum_request/REPEAT<< " " <<sum_miss/REPEAT << " " << sum_duration / REPEAT
+		<< " " << count << " records" << endl;
+
+	/* the same, a column batch at a time */
+	sum_request = 0; sum_miss = 0;sum_duration = 0;
+	count = 0;
+	for (int i = 0; i < REPEAT; i++){
+		MINIBASE_BM->ResetStat();
+		clock_t begin = clock();
+		int numOfColsR = specOfR.recLen / sizeof(int);
+		VecHashAggregate agg(new VecHashJoinOp(new VecScanOp(specOfR.file, specOfR.recLen), specOfR.joinAttr,
+		                                       new VecScanOp(specOfS.file, specOfS.recLen), specOfS.joinAttr),
+		                     numOfColsR + specOfS.joinAttr, numOfColsR + specOfS.joinAttr);
+		agg.Run();
+		count = 0;
+		for (int g = 0; g < agg.GetNumOfGroups(); g++)
+			count += agg.GetCount(g);
+		duration = float(clock() - begin)/CLOCKS_PER_SEC;
+		MINIBASE_BM->GetStat(pinRequests, pinMisses);
+		sum_request += pinRequests; 
+		sum_miss += pinMisses;
+		sum_duration += duration;
+	}
+	cout << "Vectorized " <<sum_request/REPEAT<< " " <<sum_miss/REPEAT << " " << sum_duration / REPEAT
+		<< " " << count << " records" << endl;
 	
     //delete the created database
     remove("MINIBASE.DB");
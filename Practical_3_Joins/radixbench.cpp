@@ -0,0 +1,140 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "include/minirel.h"
+#include "include/heapfile.h"
+#include "include/join.h"
+#include "include/relation.h"
+#include "include/radixjoin.h"
+
+int MINIBASE_RESTART_FLAG = 0;// used in minibase part
+
+//
+// How RadixJoinTuples scales with threads.  Employee and Project
+// records are made in memory, as CreateR and CreateS would, but many
+// more of them: every employee works on one of a quarter as many
+// projects.  Their proj and id attributes are then joined with 1, 2,
+// 4, ... threads, up to the number of cores or the number given, and
+// each run is timed on the wall clock.
+//
+// Only the in-memory join is timed: reading the relations through the
+// buffer manager and writing the result, which RadixHashJoin does on
+// one thread, are left out.
+//
+// Usage: minibase-radixbench [number of employees] [most threads]
+//
+
+#define DEFAULT_NUM_OF_EMPLOYEES 4000000
+#define NUM_OF_RUNS 3
+
+
+static double WallClock()
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+
+//------------------------------------------------------------------
+// TimeJoin
+//
+// Purpose  : Join r and s NUM_OF_RUNS times with numOfThreads threads.
+// Output   : numOfMatches - the number of matches of the last run.
+// Return   : the fastest run, in seconds.
+//------------------------------------------------------------------
+
+static double TimeJoin(const RadixTuple *r, int numOfR, const RadixTuple *s, int numOfS,
+                       int numOfThreads, long& numOfMatches)
+{
+	double best = 0;
+
+	for (int run = 0; run < NUM_OF_RUNS; run++)
+	{
+		RadixMatch *matches;
+		double begin = WallClock();
+
+		numOfMatches = RadixJoinTuples(r, numOfR, s, numOfS, numOfThreads, matches);
+
+		double seconds = WallClock() - begin;
+		if (run == 0 || seconds < best)
+			best = seconds;
+		delete [] matches;
+	}
+	return best;
+}
+
+
+int main(int argc, char **argv)
+{
+	int numOfEmployees = (argc > 1) ? atoi(argv[1]) : DEFAULT_NUM_OF_EMPLOYEES;
+	int maxThreads = (argc > 2) ? atoi(argv[2]) : sysconf(_SC_NPROCESSORS_ONLN);
+	if (numOfEmployees < 1)
+		numOfEmployees = 1;
+
+	int numOfProjects = numOfEmployees / 4;
+	if (numOfProjects < 1)
+		numOfProjects = 1;
+	if (maxThreads < 1)
+		maxThreads = 1;
+
+	Employee *employees = new Employee[numOfEmployees];
+	Project *projects = new Project[numOfProjects];
+	RadixTuple *r = new RadixTuple[numOfEmployees];
+	RadixTuple *s = new RadixTuple[numOfProjects];
+
+	srand(1);
+	for (int i = 0; i < numOfProjects; i++)
+	{
+		projects[i].id = i;
+		projects[i].fund = rand() % 10000;
+		projects[i].manager = rand() % numOfEmployees;
+		projects[i].status = rand() % 4;
+
+		s[i].key = projects[i].id;
+		s[i].index = i;
+	}
+	for (int i = 0; i < numOfEmployees; i++)
+	{
+		employees[i].id = i;
+		employees[i].age = 20 + rand() % 45;
+		employees[i].proj = rand() % numOfProjects;
+		employees[i].salary = rand() % 100000;
+		employees[i].rating = rand() % 10;
+		employees[i].dept = rand() % 100;
+
+		r[i].key = employees[i].proj;
+		r[i].index = i;
+	}
+
+	cout << numOfEmployees << " employees, " << numOfProjects << " projects, "
+		<< sysconf(_SC_NPROCESSORS_ONLN) << " cores" << endl;
+
+	double single = 0;
+	for (int threads = 1; ; threads *= 2)
+	{
+		if (threads > maxThreads)
+			threads = maxThreads;
+
+		long numOfMatches;
+		double seconds = TimeJoin(r, numOfEmployees, s, numOfProjects, threads, numOfMatches);
+		if (threads == 1)
+			single = seconds;
+
+		cout << threads << " threads " << seconds << "s, "
+			<< (numOfEmployees + numOfProjects) / seconds / 1e6 << "M tuples/s, speedup "
+			<< single / seconds << ", " << numOfMatches << " matches" << endl;
+
+		if (threads == maxThreads)
+			break;
+	}
+
+	delete [] employees;
+	delete [] projects;
+	delete [] r;
+	delete [] s;
+	return 0;
+}
@@ -0,0 +1,216 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "include/minirel.h"
+#include "include/bufmgr.h"
+#include "include/heapfile.h"
+#include "include/scan.h"
+#include "include/btfile.h"
+#include "include/btfilescan.h"
+#include "include/join.h"
+#include "include/relation.h"
+
+int MINIBASE_RESTART_FLAG = 0;// used in minibase part
+
+//
+// Sorting a HeapFile of random int keys, bigger than the buffer pool,
+// the way SortFile used to -- bulk load a BTreeFile on the keys, then
+// fetch the records in the order of a scan of it -- and with
+// ExternalSort, given a few memory budgets.  For each, the time, and
+// the pins and misses it cost the buffer manager.  Last, an empty
+// relation is sorted, which must give an empty file.
+//
+// Usage: minibase-sortbench [number of records] [frames in buffer pool]
+//
+
+#define DEFAULT_NUM_OF_RECS 200000
+#define DEFAULT_NUM_OF_BUFS 100
+
+#define BENCH_REC_LEN 32
+
+
+static double Seconds(clock_t begin)
+{
+	return double(clock() - begin)/CLOCKS_PER_SEC;
+}
+
+
+//------------------------------------------------------------------
+// SortByIndex
+//
+// Purpose  : Sort F on the key at offset 0 through a BTreeFile.
+// Return   : the sorted file, NULL on error.
+//------------------------------------------------------------------
+
+static HeapFile *SortByIndex(HeapFile *F)
+{
+	BTreeFile *btree = BuildIndex(F, BENCH_REC_LEN, 0, "SORTBENCH");
+	if (btree == NULL)
+		return NULL;
+
+	Status s;
+	HeapFile *sorted = new HeapFile(NULL, s);
+	BTreeFileScan *scan = (BTreeFileScan *)btree->OpenScan(NULL, NULL);
+
+	char rec[BENCH_REC_LEN];
+	int recLen = BENCH_REC_LEN;
+	RecordID rid, newRid;
+	int key;
+
+	while (scan->GetNext(rid, &key) == OK)
+	{
+		F->GetRecord(rid, rec, recLen);
+		sorted->InsertRecord(rec, recLen, newRid);
+	}
+	delete scan;
+
+	btree->DestroyFile();
+	delete btree;
+	return sorted;
+}
+
+
+//------------------------------------------------------------------
+// CheckSorted
+//
+// Return   : the number of records of F, or -1 if they are out of
+//            order.
+//------------------------------------------------------------------
+
+static int CheckSorted(HeapFile *F)
+{
+	Status s;
+	Scan *scan = F->OpenScan(s);
+	char rec[BENCH_REC_LEN];
+	int recLen = BENCH_REC_LEN;
+	RecordID rid;
+	int n = 0, last = 0, key;
+	Bool sorted = TRUE;
+
+	while (scan->GetNext(rid, rec, recLen) == OK)
+	{
+		memcpy(&key, rec, sizeof(int));
+		if (n > 0 && key < last)
+			sorted = FALSE;
+		last = key;
+		n++;
+	}
+	delete scan;
+	return sorted ? n : -1;
+}
+
+
+static void Report(const char *name, HeapFile *sorted, clock_t begin,
+                   long pins, long misses)
+{
+	double seconds = Seconds(begin);
+	long pinsAfter, missesAfter;
+	MINIBASE_BM->GetStat(pinsAfter, missesAfter);
+
+	if (sorted == NULL)
+	{
+		cout << name << " failed" << endl;
+		return;
+	}
+	int n = CheckSorted(sorted);
+
+	cout << name << seconds << "s, "
+		<< pinsAfter - pins << " pins, "
+		<< missesAfter - misses << " misses, ";
+	if (n < 0)
+		cout << "NOT SORTED" << endl;
+	else
+		cout << n << " records sorted" << endl;
+}
+
+
+int main(int argc, char **argv)
+{
+	int numOfRecs = (argc > 1) ? atoi(argv[1]) : DEFAULT_NUM_OF_RECS;
+	int numOfBufs = (argc > 2) ? atoi(argv[2]) : DEFAULT_NUM_OF_BUFS;
+	Status s;
+
+	// The file, and the B-tree on it and its sorted copy, or the runs
+	// being merged and the run they are merged into.
+	int numOfPages = numOfRecs / 6 + 500;
+
+	minibase_globals = new SystemDefs(s, "SORTBENCH.DB", "SORTBENCH.LOG",
+		numOfPages, 500, numOfBufs, NULL);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot create the database.\n";
+		return 1;
+	}
+
+	HeapFile *F = new HeapFile("SORTBENCH.REL", s);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot create the relation.\n";
+		return 1;
+	}
+
+	char rec[BENCH_REC_LEN];
+	RecordID rid;
+	memset(rec, 0, BENCH_REC_LEN);
+	srand(1);
+	for (int i = 0; i < numOfRecs; i++)
+	{
+		int key = rand();
+
+		memcpy(rec, &key, sizeof(int));
+		memcpy(rec + sizeof(int), &i, sizeof(int));
+		F->InsertRecord(rec, BENCH_REC_LEN, rid);
+	}
+	cout << numOfRecs << " records of " << BENCH_REC_LEN << " bytes, "
+		<< numOfBufs << " frames" << endl;
+
+	clock_t begin;
+	long pins, misses;
+	HeapFile *sorted;
+
+	MINIBASE_BM->GetStat(pins, misses);
+	begin = clock();
+	sorted = SortByIndex(F);
+	Report("BTreeFile          ", sorted, begin, pins, misses);
+	delete sorted;
+
+	int budgets[] = { 8, 16, 0 };
+	for (int i = 0; i < (int)(sizeof(budgets)/sizeof(int)); i++)
+	{
+		char name[64];
+		sprintf(name, "ExternalSort %4d   ", budgets[i] ? budgets[i] : numOfBufs / 2);
+
+		MINIBASE_BM->GetStat(pins, misses);
+		begin = clock();
+		sorted = ExternalSort(F, BENCH_REC_LEN, 0, budgets[i]);
+		Report(name, sorted, begin, pins, misses);
+		delete sorted;
+	}
+
+	F->DeleteFile();
+	delete F;
+
+	// An empty relation makes no runs, and sorts to an empty file.
+
+	HeapFile *E = new HeapFile("SORTBENCH.EMPTY", s);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot create the relation.\n";
+		return 1;
+	}
+	sorted = ExternalSort(E, BENCH_REC_LEN, 0, 0);
+	if (sorted == NULL || CheckSorted(sorted) != 0)
+	{
+		cerr << "ERROR : sorting an empty relation failed.\n";
+		return 1;
+	}
+	cout << "ExternalSort of an empty relation: 0 records sorted" << endl;
+	delete sorted;
+	E->DeleteFile();
+	delete E;
+
+	remove("SORTBENCH.DB");
+	return 0;
+}
@@ -0,0 +1,181 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "include/minirel.h"
+#include "include/bufmgr.h"
+#include "include/heapfile.h"
+#include "include/scan.h"
+#include "include/join.h"
+#include "include/relation.h"
+#include "include/operator.h"
+#include "include/vectorop.h"
+
+int MINIBASE_RESTART_FLAG = 0;// used in minibase part
+
+//
+// The cost per employee of joining R with S, record at a time and
+// vector at a time.  Each of TupleNestedLoopJoin and HashJoin, which
+// write their result to a HeapFile, the HashJoinOp of operator.h piped
+// into Aggregate, and VecHashJoinOp piped into VecHashAggregate, joins
+// R and S and, where it can, sums the fund of the projects of the
+// employees.  A filtered query, employees of rating at least
+// MIN_RATING grouped by dept, is then run on the record and vector
+// operators, and their counts and sums checked against each other.
+//
+// Usage: minibase-vecbench [frames in buffer pool]
+//
+
+#define DEFAULT_NUM_OF_BUFS 50
+#define NUM_OF_DB_PAGES     2000
+#define MIN_RATING          3
+
+#define R_COLS    (int)(sizeof(Employee) / sizeof(int))
+#define COL_DEPT   5
+#define COL_RATING 4
+#define COL_FUND   (R_COLS + 1)
+#define COL_STATUS (R_COLS + 3)
+
+
+static void Report(const char *name, double duration, long numOfRecs, long numOfMatches, long sum)
+{
+	printf("%-20s %9.4fs %8.1f ns/employee %8ld records", name, duration, duration * 1e9 / numOfRecs, numOfMatches);
+	if (sum >= 0)
+		printf(" fund %ld", sum);
+	printf("\n");
+}
+
+
+// Read every record of op, for the cost of a scan alone.
+static long Drain(Operator *op)
+{
+	long count, sum;
+
+	Aggregate(op, 0, count, sum);
+	delete op;
+	return count;
+}
+
+
+static long Drain(VecOperator *op)
+{
+	ColumnBatch batch(op->GetNumOfCols());
+	long count = 0;
+
+	op->Open();
+	while (op->Next(batch) == OK)
+		count += batch.GetNumOfSelected();
+	op->Close();
+	delete op;
+	return count;
+}
+
+
+int main(int argc, char **argv)
+{
+	int numOfBufs = (argc > 1) ? atoi(argv[1]) : DEFAULT_NUM_OF_BUFS;
+	Status s;
+
+	minibase_globals = new SystemDefs(s, "VECBENCH.DB", "VECBENCH.LOG",
+		NUM_OF_DB_PAGES, 500, numOfBufs, NULL);
+	if (s != OK)
+	{
+		cerr << "ERROR : cannot create the database.\n";
+		return 1;
+	}
+
+	srand(1);
+	CreateR(1, 1);
+	CreateS(1, 1);
+
+	JoinSpec specOfR, specOfS;
+	CreateSpecForR(specOfR);
+	CreateSpecForS(specOfS);
+
+	long numOfR = specOfR.file->GetNumOfRecords();
+	int fundOffset = specOfR.recLen + sizeof(int);
+	long pins, misses, count, sum;
+	double duration;
+	clock_t begin;
+
+	HeapFile *T = TupleNestedLoopJoin(specOfR, specOfS, pins, misses, duration);
+	Report("TupleNestedLoopJoin", duration, numOfR, T->GetNumOfRecords(), -1);
+	delete T;
+
+	T = HashJoin(specOfR, specOfS, pins, misses, duration);
+	Report("HashJoin", duration, numOfR, T->GetNumOfRecords(), -1);
+	delete T;
+
+	// Reading R and S costs the same to every operator below, whatever
+	// it does with them.
+
+	begin = clock();
+	count = Drain(new ScanOp(specOfR.file, specOfR.recLen));
+	count += Drain(new ScanOp(specOfS.file, specOfS.recLen));
+	Report("ScanOp", float(clock() - begin)/CLOCKS_PER_SEC, numOfR, count, -1);
+
+	begin = clock();
+	count = Drain(new VecScanOp(specOfR.file, specOfR.recLen));
+	count += Drain(new VecScanOp(specOfS.file, specOfS.recLen));
+	Report("VecScanOp", float(clock() - begin)/CLOCKS_PER_SEC, numOfR, count, -1);
+
+	begin = clock();
+	Operator *join = new HashJoinOp(new ScanOp(specOfR.file, specOfR.recLen), specOfR.offset,
+	                                new ScanOp(specOfS.file, specOfS.recLen), specOfS.offset);
+	Aggregate(join, fundOffset, count, sum);
+	delete join;
+	Report("HashJoinOp", float(clock() - begin)/CLOCKS_PER_SEC, numOfR, count, sum);
+
+	// Grouped on the status of the project, whose counts and sums add
+	// up to those of the whole join.
+
+	begin = clock();
+	VecHashAggregate agg(new VecHashJoinOp(new VecScanOp(specOfR.file, specOfR.recLen), specOfR.joinAttr,
+	                                       new VecScanOp(specOfS.file, specOfS.recLen), specOfS.joinAttr),
+	                     COL_STATUS, COL_FUND);
+	agg.Run();
+	count = sum = 0;
+	for (int g = 0; g < agg.GetNumOfGroups(); g++)
+	{
+		count += agg.GetCount(g);
+		sum += agg.GetSum(g);
+	}
+	Report("VecHashJoinOp", float(clock() - begin)/CLOCKS_PER_SEC, numOfR, count, sum);
+
+	// Employees of rating at least MIN_RATING, grouped by dept: the
+	// record operators do it one dept at a time, the vector ones at once.
+
+	begin = clock();
+	VecHashAggregate byDept(new VecHashJoinOp(new VecFilterOp(new VecScanOp(specOfR.file, specOfR.recLen),
+	                                                          COL_RATING, aopGE, MIN_RATING),
+	                                          specOfR.joinAttr,
+	                                          new VecScanOp(specOfS.file, specOfS.recLen), specOfS.joinAttr),
+	                        COL_DEPT, COL_FUND);
+	byDept.Run();
+	duration = float(clock() - begin)/CLOCKS_PER_SEC;
+	count = sum = 0;
+	for (int g = 0; g < byDept.GetNumOfGroups(); g++)
+	{
+		count += byDept.GetCount(g);
+		sum += byDept.GetSum(g);
+	}
+	Report("VecFilterOp+group", duration, numOfR, count, sum);
+
+	int numOfBad = 0;
+	for (int g = 0; g < byDept.GetNumOfGroups(); g++)
+	{
+		Operator *op = new FilterOp(new FilterOp(new HashJoinOp(new ScanOp(specOfR.file, specOfR.recLen), specOfR.offset,
+		                                                        new ScanOp(specOfS.file, specOfS.recLen), specOfS.offset),
+		                                         COL_RATING * sizeof(int), aopGE, MIN_RATING),
+		                            COL_DEPT * sizeof(int), aopEQ, byDept.GetGroup(g));
+		Aggregate(op, fundOffset, count, sum);
+		delete op;
+		if (count != byDept.GetCount(g) || sum != byDept.GetSum(g))
+			numOfBad++;
+	}
+	printf("%d of %d depts differ from the record operators\n", numOfBad, byDept.GetNumOfGroups());
+
+	remove("VECBENCH.DB");
+	return 0;
+}